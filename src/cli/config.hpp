@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace surge::cli {
 
@@ -10,6 +11,15 @@ namespace surge::cli {
         // Target URL
         std::string url;
 
+        // All backend URLs when --url is repeated (first is url), load balanced client side
+        std::vector<std::string> targets;
+
+        // Expand the url's host to every resolved IPv4 address as separate backends
+        bool resolve_all = false;
+
+        // Balancing policy across backends: round-robin, random, least-outstanding, hash
+        std::string balance_policy = "round-robin";
+
         // Number of concurrent workers
         std::uint32_t concurrency = 10;
 
@@ -22,7 +32,120 @@ namespace surge::cli {
         // HTTP Method
         std::optional<std::string> method = "GET";
 
+        // Request body sent from this file with sendfile(), empty = no body
+        std::string body_file;
+
+        // Extra headers ("Name: value") and inline body, the URL path, headers and
+        // body may contain {{placeholders}} rendered per request
+        std::vector<std::string> headers;
+        std::string body;
+
+        // Data files for {{name}} / {{name.column}} placeholders, "name=path"
+        std::vector<std::string> feeders;
+
+        // Seed for {{rand}} / {{hex:n}}, each worker has its own generator
+        std::uint32_t seed = 1;
+
         // Verbose output
         bool verbose = true;
+
+        // Download mode: response bodies dropped in the kernel (MSG_TRUNC), nothing copied
+        bool download = false;
+
+        // Bytes per read of a response body, 0 = default
+        std::uint32_t recv_buffer = 0;
+
+        // Accept-Encoding sent with requests, and whether bodies are decoded (and the decoding timed)
+        std::string accept_encoding;
+        bool decompress = false;
+
+        // Report the slowest / most expensive normalised paths, 0 = off
+        std::uint32_t top_paths = 0;
+
+        // Exemplars: keep the `exemplars` slowest requests, plus exemplar_samples sampled among those at
+        // or above exemplar_threshold_ms (0 = no sample), and write them to trace_file ("chrome" or "otlp")
+        std::string trace_file;
+        std::string trace_format = "chrome";
+        std::uint32_t exemplars = 20;
+        double exemplar_threshold_ms = 0.0;
+        std::uint32_t exemplar_samples = 100;
+
+        // Numeric response header holding the server's own time (ms), used with Server-Timing
+        std::string response_time_header;
+
+        // Also split latency by exact status code (always split by status class and failures)
+        bool latency_by_code = false;
+
+        // Warmup excluded from results: by duration, by request count or auto (steady state)
+        std::uint32_t warmup_seconds = 0;
+        std::uint32_t warmup_requests = 0;
+        bool warmup_auto = false;
+
+        // Auto warmup: steady when throughput and p50 vary less than this (coefficient of variation)
+        double steady_threshold = 0.05;
+
+        // Auto warmup: give up waiting for steady state after this long
+        std::uint32_t warmup_max_seconds = 60;
+
+        // Access log to replay ("surge replay <log>"), empty = synthetic load
+        std::string replay_file;
+
+        // Replay speed-up factor, 2.0 = twice as fast as the log
+        double replay_speed = 1.0;
+
+        // WebSocket mode: each worker holds one upgraded connection and times message round trips
+        bool websocket = false;
+        double ws_rate = 0.0;               // Messages per second per connection, 0 = ping-pong (one in flight)
+        std::string ws_message;             // Text payload, empty = ws_size binary bytes
+        std::uint32_t ws_size = 32;
+        bool ws_ping = false;               // Send Ping control frames (answered by any server) instead of echoed data
+
+        // Connection capacity mode: open and hold hold_connections keep-alive connections, each
+        // sending a request every hold_interval seconds (0 = none), opened at hold_rate per second (0 = no limit)
+        std::uint32_t hold_connections = 0;
+        double hold_interval = 30.0;
+        double hold_rate = 0.0;
+        std::uint32_t hold_threads = 0;     // Event loop threads, 0 = one per core
+
+        // Outgoing socket tuning
+        std::string source_addresses;       // "127.0.0.2-127.0.0.50" or comma list, empty = kernel choice
+        bool tcp_nodelay = false;
+        std::uint32_t send_buffer = 0;      // SO_SNDBUF bytes, 0 = default
+        std::uint32_t receive_buffer = 0;   // SO_RCVBUF bytes, 0 = default
+        bool tcp_quickack = false;
+        bool tcp_fast_open = false;
+        bool linger_reset = false;          // RST on close, avoids TIME_WAIT
+        bool kernel_timestamps = false;     // SO_TIMESTAMPING, split network time from generator delay
+
+        // Sweep: run every combination of these lists back to back in one process, an empty list
+        // keeps the single --concurrency / --body; sweep_cooldown idle seconds between cells
+        std::vector<std::uint32_t> sweep_concurrency;
+        std::vector<std::uint32_t> sweep_body_sizes;
+        std::uint32_t sweep_cooldown = 2;
+        std::string sweep_json;             // Write the per cell results here
+
+        // Port for the live OpenMetrics endpoint, 0 = disabled
+        std::uint16_t metrics_port = 0;
+
+        // Soak mode: interval histogram log written every soak_interval seconds (+ <file>.checkpoint)
+        std::string soak_log;
+        std::uint32_t soak_interval = 10;
+
+        // "surge soak-report <log>": rebuild the report for [soak_from, soak_to) seconds of a soak log
+        std::string soak_report_file;
+        double soak_from = 0.0;
+        double soak_to = 0.0;               // 0 = to the end
+
+        // Baseline file to write after the run
+        std::string save_baseline_file;
+
+        // Baseline file to compare the run against
+        std::string compare_file;
+
+        // Regression thresholds for --compare
+        double max_latency_regression = 10.0;   // Percent at p50/p90/p99
+        double max_throughput_drop = 10.0;      // Percent
+        double max_error_increase = 1.0;        // Percentage points
+        double significance = 0.05;             // Mann-Whitney alpha
     };
 }
\ No newline at end of file
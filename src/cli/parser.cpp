@@ -1,4 +1,12 @@
 #include "cli/parser.hpp"
+#include "core/balancer.hpp"
+#include "http/body_file.hpp"
+#include "http/decoder.hpp"
+#include "http/socket.hpp"
+#include "http/url.hpp"
+#include "output/trace_export.hpp"
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -10,8 +18,118 @@ bool is_flag(std::string_view arg) {
     return arg.size() >= 2 && arg[0] == '-' && arg[1] == '-';
 }
 
+namespace {
+    // Take the value following a flag, error if missing
+    bool next_value(const std::vector<std::string>& args, size_t& i, std::string_view flag, std::string& out) {
+        if (i + 1 >= args.size()) {
+            std::cerr << "Error: " << flag << " requires a value\n";
+            return false;
+        }
+        out = args[++i];
+        return true;
+    }
+
+    // Parse a non-negative whole number
+    bool parse_uint(const std::string& text, std::string_view flag, std::uint32_t& out) {
+        try {
+            size_t used = 0;
+            long long value = std::stoll(text, &used);
+            if (used != text.size() || value < 0 || value > UINT32_MAX) {
+                std::cerr << "Error: invalid value for " << flag << "\n";
+                return false;
+            }
+            out = static_cast<std::uint32_t>(value);
+            return true;
+        } catch (const std::exception&) {
+            std::cerr << "Error: invalid value for " << flag << "\n";
+            return false;
+        }
+    }
+
+    // Comma separated non-negative whole numbers, e.g. "1,8,64"
+    bool parse_uint_list(const std::string& text, std::string_view flag, std::vector<std::uint32_t>& out) {
+        out.clear();
+        std::size_t start = 0;
+        while (start <= text.size()) {
+            std::size_t comma = text.find(',', start);
+            std::string item = text.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+            std::uint32_t value = 0;
+            if (!parse_uint(item, flag, value)) {
+                return false;
+            }
+            out.push_back(value);
+            if (comma == std::string::npos) {
+                break;
+            }
+            start = comma + 1;
+        }
+        return true;
+    }
+
+    // Parse a non-negative decimal value
+    bool parse_double(const std::string& text, std::string_view flag, double& out) {
+        try {
+            size_t used = 0;
+            double value = std::stod(text, &used);
+            if (used != text.size() || value < 0) {
+                std::cerr << "Error: invalid value for " << flag << "\n";
+                return false;
+            }
+            out = value;
+            return true;
+        } catch (const std::exception&) {
+            std::cerr << "Error: invalid value for " << flag << "\n";
+            return false;
+        }
+    }
+}
+
 bool parse_arguments(const std::vector<std::string>& args, Config& config) {
-    for (size_t i = 1; i < args.size(); ++i) {
+    size_t first_option = 1;
+
+    // Subcommand: surge soak-report <log> [--from s] [--to s], no load is generated
+    if (args.size() > 1 && args[1] == "soak-report") {
+        if (args.size() < 3 || is_flag(args[2])) {
+            std::cerr << "Error: soak-report requires a log file\n";
+            return false;
+        }
+        config.soak_report_file = args[2];
+        for (size_t i = 3; i < args.size(); ++i) {
+            std::string_view arg = args[i];
+            std::string value;
+            if (arg == "--from" || arg == "--to") {
+                double& target = arg == "--from" ? config.soak_from : config.soak_to;
+                if (!next_value(args, i, arg, value) || !parse_double(value, arg, target)) {
+                    return false;
+                }
+            } else if (arg == "--help" || arg == "-h") {
+                print_usage();
+                return false;
+            } else {
+                std::cerr << "Error: unknown argument '" << arg << "'\n";
+                return false;
+            }
+        }
+        if (config.soak_to > 0 && config.soak_to <= config.soak_from) {
+            std::cerr << "Error: --to must be after --from\n";
+            return false;
+        }
+        return true;
+    }
+
+    // Subcommand: surge replay <access.log> [OPTIONS]
+    if (args.size() > 1 && args[1] == "replay") {
+        if (args.size() < 3 || is_flag(args[2])) {
+            std::cerr << "Error: replay requires a log file\n";
+            return false;
+        }
+        config.replay_file = args[2];
+        first_option = 3;
+    }
+
+    bool method_set = false;
+
+    for (size_t i = first_option; i < args.size(); ++i) {
         std::string_view arg = args[i];
         
         if (arg == "--help" || arg == "-h") {
@@ -24,7 +142,17 @@ bool parse_arguments(const std::vector<std::string>& args, Config& config) {
                 std::cerr << "Error: --url requires a value\n";
                 return false;
             }
-            config.url = args[++i];
+            // Repeating --url adds backends, the first one also sets the request path
+            std::string url = args[++i];
+
+            // http+unix:///run/app.sock without a path targets "/"
+            if (http::is_unix_url(url) && url.find(":/", http::UNIX_SCHEME.size()) == std::string::npos) {
+                url += ":/";
+            }
+            if (config.url.empty()) {
+                config.url = url;
+            }
+            config.targets.push_back(url);
             
         } else if (arg == "--concurrency" || arg == "-c") {
             if (i + 1 >= args.size()) {
@@ -88,6 +216,264 @@ bool parse_arguments(const std::vector<std::string>& args, Config& config) {
                 std::cerr << "Error: duration value too large";
                 return false;
             }
+        } else if (arg == "--metrics-port") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Error: --metrics-port requires a value\n";
+                return false;
+            }
+            try {
+                int value = std::stoi(args[++i]);
+                if (value <= 0 || value > 65535) {
+                    std::cerr << "Error: metrics port must be between 1 and 65535\n";
+                    return false;
+                }
+                config.metrics_port = static_cast<std::uint16_t>(value);
+            } catch (const std::invalid_argument&) {
+                std::cerr << "Error: invalid metrics port\n";
+                return false;
+            } catch (const std::out_of_range&) {
+                std::cerr << "Error: metrics port value too large\n";
+                return false;
+            }
+        } else if (arg == "--warmup") {
+            // "auto", "<n>s" (duration) or "<n>" (requests)
+            std::string value;
+            if (!next_value(args, i, arg, value)) {
+                return false;
+            }
+            config.warmup_auto = false;
+            config.warmup_seconds = 0;
+            config.warmup_requests = 0;
+            if (value == "auto") {
+                config.warmup_auto = true;
+            } else if (!value.empty() && value.back() == 's') {
+                if (!parse_uint(value.substr(0, value.size() - 1), arg, config.warmup_seconds)) {
+                    return false;
+                }
+            } else if (!parse_uint(value, arg, config.warmup_requests)) {
+                return false;
+            }
+        } else if (arg == "--steady-threshold") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_double(value, arg, config.steady_threshold)) {
+                return false;
+            }
+        } else if (arg == "--warmup-max") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.warmup_max_seconds)) {
+                return false;
+            }
+        } else if (arg == "--method" || arg == "-X") {
+            std::string value;
+            if (!next_value(args, i, arg, value)) {
+                return false;
+            }
+            config.method = value;
+            method_set = true;
+        } else if (arg == "--body-file") {
+            if (!next_value(args, i, arg, config.body_file)) {
+                return false;
+            }
+            if (!http::BodyFile(config.body_file).is_open()) {
+                std::cerr << "Error: could not open body file: " << config.body_file << "\n";
+                return false;
+            }
+        } else if (arg == "--header" || arg == "-H") {
+            std::string value;
+            if (!next_value(args, i, arg, value)) {
+                return false;
+            }
+            if (value.find(':') == std::string::npos) {
+                std::cerr << "Error: header must be 'Name: value'\n";
+                return false;
+            }
+            config.headers.push_back(value);
+        } else if (arg == "--body") {
+            if (!next_value(args, i, arg, config.body)) {
+                return false;
+            }
+        } else if (arg == "--feeder") {
+            std::string value;
+            if (!next_value(args, i, arg, value)) {
+                return false;
+            }
+            size_t equals = value.find('=');
+            if (equals == 0 || equals == std::string::npos || equals + 1 == value.size()) {
+                std::cerr << "Error: feeder must be 'name=path'\n";
+                return false;
+            }
+            config.feeders.push_back(value);
+        } else if (arg == "--seed") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.seed)) {
+                return false;
+            }
+        } else if (arg == "--download") {
+            config.download = true;
+        } else if (arg == "--recv-buffer") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.recv_buffer)) {
+                return false;
+            }
+        } else if (arg == "--latency-by-code") {
+            config.latency_by_code = true;
+        } else if (arg == "--top-paths") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.top_paths)) {
+                return false;
+            }
+        } else if (arg == "--trace-out") {
+            if (!next_value(args, i, arg, config.trace_file)) {
+                return false;
+            }
+        } else if (arg == "--trace-format") {
+            if (!next_value(args, i, arg, config.trace_format)) {
+                return false;
+            }
+        } else if (arg == "--exemplars" || arg == "--exemplar-samples") {
+            std::string value;
+            std::uint32_t& target = arg == "--exemplars" ? config.exemplars : config.exemplar_samples;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, target)) {
+                return false;
+            }
+        } else if (arg == "--exemplar-threshold") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_double(value, arg, config.exemplar_threshold_ms)) {
+                return false;
+            }
+        } else if (arg == "--compressed") {
+            config.decompress = true;
+        } else if (arg == "--accept-encoding") {
+            if (!next_value(args, i, arg, config.accept_encoding)) {
+                return false;
+            }
+        } else if (arg == "--response-time-header") {
+            if (!next_value(args, i, arg, config.response_time_header)) {
+                return false;
+            }
+        } else if (arg == "--lb") {
+            if (!next_value(args, i, arg, config.balance_policy)) {
+                return false;
+            }
+            if (!core::parse_balance_policy(config.balance_policy)) {
+                std::cerr << "Error: unknown balancing policy '" << config.balance_policy << "'\n";
+                return false;
+            }
+        } else if (arg == "--resolve-all") {
+            config.resolve_all = true;
+        } else if (arg == "--source-addresses") {
+            if (!next_value(args, i, arg, config.source_addresses)) {
+                return false;
+            }
+            if (!http::SourceAddressPool::parse(config.source_addresses)) {
+                std::cerr << "Error: invalid source addresses '" << config.source_addresses << "'\n";
+                return false;
+            }
+        } else if (arg == "--sndbuf" || arg == "--rcvbuf") {
+            std::string value;
+            std::uint32_t& target = arg == "--sndbuf" ? config.send_buffer : config.receive_buffer;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, target)) {
+                return false;
+            }
+        } else if (arg == "--tcp-nodelay") {
+            config.tcp_nodelay = true;
+        } else if (arg == "--quickack") {
+            config.tcp_quickack = true;
+        } else if (arg == "--fastopen") {
+            config.tcp_fast_open = true;
+        } else if (arg == "--linger-reset") {
+            config.linger_reset = true;
+        } else if (arg == "--kernel-timestamps") {
+            config.kernel_timestamps = true;
+        } else if (arg == "--speed") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_double(value, arg, config.replay_speed)) {
+                return false;
+            }
+            if (config.replay_speed <= 0) {
+                std::cerr << "Error: speed must be positive\n";
+                return false;
+            }
+        } else if (arg == "--websocket") {
+            config.websocket = true;
+        } else if (arg == "--ws-rate") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_double(value, arg, config.ws_rate)) {
+                return false;
+            }
+        } else if (arg == "--ws-message") {
+            if (!next_value(args, i, arg, config.ws_message)) {
+                return false;
+            }
+        } else if (arg == "--ws-size") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.ws_size)) {
+                return false;
+            }
+        } else if (arg == "--ws-ping") {
+            config.ws_ping = true;
+        } else if (arg == "--hold") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.hold_connections)) {
+                return false;
+            }
+        } else if (arg == "--hold-interval" || arg == "--hold-rate") {
+            std::string value;
+            double& target = arg == "--hold-interval" ? config.hold_interval : config.hold_rate;
+            if (!next_value(args, i, arg, value) || !parse_double(value, arg, target)) {
+                return false;
+            }
+        } else if (arg == "--hold-threads") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.hold_threads)) {
+                return false;
+            }
+        } else if (arg == "--soak-log") {
+            if (!next_value(args, i, arg, config.soak_log)) {
+                return false;
+            }
+        } else if (arg == "--soak-interval") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.soak_interval)) {
+                return false;
+            }
+            if (config.soak_interval == 0) {
+                std::cerr << "Error: --soak-interval must be at least 1\n";
+                return false;
+            }
+        } else if (arg == "--sweep-concurrency" || arg == "--sweep-body") {
+            std::string value;
+            auto& target = arg == "--sweep-concurrency" ? config.sweep_concurrency : config.sweep_body_sizes;
+            if (!next_value(args, i, arg, value) || !parse_uint_list(value, arg, target)) {
+                return false;
+            }
+        } else if (arg == "--sweep-cooldown") {
+            std::string value;
+            if (!next_value(args, i, arg, value) || !parse_uint(value, arg, config.sweep_cooldown)) {
+                return false;
+            }
+        } else if (arg == "--sweep-json") {
+            if (!next_value(args, i, arg, config.sweep_json)) {
+                return false;
+            }
+        } else if (arg == "--save-baseline") {
+            if (!next_value(args, i, arg, config.save_baseline_file)) {
+                return false;
+            }
+        } else if (arg == "--compare") {
+            if (!next_value(args, i, arg, config.compare_file)) {
+                return false;
+            }
+        } else if (arg == "--max-latency-regression" || arg == "--max-throughput-drop" ||
+                   arg == "--max-error-increase" || arg == "--significance") {
+            std::string value;
+            double* target = arg == "--max-latency-regression" ? &config.max_latency_regression
+                           : arg == "--max-throughput-drop"    ? &config.max_throughput_drop
+                           : arg == "--max-error-increase"     ? &config.max_error_increase
+                                                               : &config.significance;
+            if (!next_value(args, i, arg, value) || !parse_double(value, arg, *target)) {
+                return false;
+            }
         } else {
             std::cerr << "Error: unknown argument '" << arg << "'\n";
             std::cerr << "Use --help for usage information\n";
@@ -99,28 +485,259 @@ bool parse_arguments(const std::vector<std::string>& args, Config& config) {
         std::cerr << "Error: --url is required\n";
         return false;
     }
+
+    // ws:// is plain HTTP until the upgrade
+    if (config.url.starts_with("ws://")) {
+        config.websocket = true;
+    }
+    if (config.websocket) {
+        if (config.targets.size() > 1 || !config.replay_file.empty()) {
+            std::cerr << "Error: WebSocket mode takes a single --url and no replay log\n";
+            return false;
+        }
+        if (config.warmup_seconds > 0 || config.warmup_requests > 0 || config.warmup_auto) {
+            std::cerr << "Error: --warmup is not supported in WebSocket mode\n";
+            return false;
+        }
+        if (config.url.starts_with("wss://") || config.url.starts_with("https://")) {
+            std::cerr << "Error: TLS is not supported, use ws://\n";
+            return false;
+        }
+        // Control frame payloads are limited to 125 bytes
+        if (config.ws_ping && (config.ws_size > 125 || config.ws_message.size() > 125)) {
+            std::cerr << "Error: --ws-ping payloads are limited to 125 bytes\n";
+            return false;
+        }
+    }
+
+    if (config.hold_connections > 0 &&
+        (config.websocket || config.targets.size() > 1 || !config.replay_file.empty() || !config.soak_log.empty() ||
+         http::is_unix_url(config.url) || config.url.starts_with("https://"))) {
+        std::cerr << "Error: --hold takes a single http:// --url, without replay, WebSocket or soak logs\n";
+        return false;
+    }
+
+    if (!config.trace_file.empty()) {
+        output::TraceFormat format;
+        if (!output::parse_trace_format(config.trace_format, format)) {
+            std::cerr << "Error: --trace-format must be chrome or otlp\n";
+            return false;
+        }
+        if (config.websocket || config.hold_connections > 0) {
+            std::cerr << "Error: --trace-out is not supported in WebSocket or hold mode\n";
+            return false;
+        }
+        if (config.exemplars == 0 && config.exemplar_threshold_ms <= 0.0) {
+            std::cerr << "Error: --trace-out needs --exemplars above 0 or an --exemplar-threshold\n";
+            return false;
+        }
+    }
+
+    if (config.decompress) {
+        if (config.download) {
+            std::cerr << "Error: --compressed needs the body, it cannot be used with --download\n";
+            return false;
+        }
+        if (config.accept_encoding.empty()) {
+            config.accept_encoding = http::supported_encodings();
+        }
+    }
+
+    if (!config.sweep_concurrency.empty() || !config.sweep_body_sizes.empty()) {
+        if (config.websocket || config.hold_connections > 0 || !config.replay_file.empty() ||
+            !config.soak_log.empty() || config.metrics_port > 0 || !config.trace_file.empty() ||
+            !config.compare_file.empty() || !config.save_baseline_file.empty()) {
+            std::cerr << "Error: a sweep cannot be combined with WebSocket, hold, replay, soak, metrics,\n"
+                      << "       trace or baseline options\n";
+            return false;
+        }
+        if (std::find(config.sweep_concurrency.begin(), config.sweep_concurrency.end(), 0u) !=
+            config.sweep_concurrency.end()) {
+            std::cerr << "Error: --sweep-concurrency values must be at least 1\n";
+            return false;
+        }
+        if (!config.sweep_body_sizes.empty() && (!config.body.empty() || !config.body_file.empty())) {
+            std::cerr << "Error: --sweep-body generates the body, drop --body / --body-file\n";
+            return false;
+        }
+        if (!config.sweep_body_sizes.empty() && !method_set) {
+            config.method = "POST";
+        }
+    }
+
+    if (!config.body_file.empty() && !config.body.empty()) {
+        std::cerr << "Error: use either --body or --body-file\n";
+        return false;
+    }
+
+    // Uploads default to POST
+    if ((!config.body_file.empty() || !config.body.empty()) && !method_set) {
+        config.method = "POST";
+    }
     
     return true;
 }
 
 void print_usage() {
     std::cout << R"(Usage: surge [OPTIONS]
+       surge replay <access.log> --url <base-url> [OPTIONS]
+       surge soak-report <soak.log> [--from <s>] [--to <s>]
 
 A high-performance HTTP load testing tool
 
 OPTIONS:
-    --url <url>              Target URL to test (required)
+    --url <url>              Target URL to test (required), repeat to
+                             load balance across several backends.
+                             Unix sockets: http+unix:///run/app.sock:/path
     -c, --concurrency <n>    Number of concurrent workers (default: 10)
     -r, --requests <n>       Total requests to make (default: 100)
     -d, --duration <n>       Duration in seconds
     -v, --verbose            Enable verbose output
+    -X, --method <method>    HTTP method (default: GET, POST with a body)
+    --body-file <file>       Send the file as the request body (sendfile,
+                             shared by all workers)
+    --metrics-port <port>    Serve live OpenMetrics at http://0.0.0.0:<port>/metrics
+    --download               Bandwidth mode: drop response bodies in the
+                             kernel (MSG_TRUNC) and read in large chunks
+    --recv-buffer <bytes>    Bytes per read of a response body
+                             (default: 1024, 256 KiB with --download)
+    --top-paths <k>          Report the k slowest paths by p99 and by total
+                             time (ids in paths grouped as {id}, memory
+                             bounded however many distinct paths)
+    --trace-out <file>       Keep the slowest requests in full (phases,
+                             connection, local port, response headers)
+                             and write them as a trace
+    --trace-format <format>  chrome (trace-event JSON, default) or otlp
+                             (OTLP/JSON spans, a traceparent header sent
+                             with -H is kept as the span's ids)
+    --exemplars <n>          Slowest requests to keep (default: 20)
+    --exemplar-threshold <ms>
+                             Also sample requests at least this slow
+    --exemplar-samples <n>   Size of that sample (default: 100)
+    --compressed             Send Accept-Encoding (gzip, deflate and br/zstd
+                             when built in) and decode bodies: decoded size
+                             and decode time are reported, decode time is
+                             excluded from latency
+    --accept-encoding <list> Accept-Encoding to send, e.g. "gzip" (without
+                             --compressed bodies are not decoded)
+    --latency-by-code        Report latency per status code, not just per
+                             class (2xx/4xx/5xx/failed)
+    --response-time-header <name>
+                             Header with the server's own time in ms
+                             (e.g. X-Response-Time, "12ms"/"0.012s" also
+                             work); Server-Timing is always read
     -h, --help               Show this help message
 
+BACKENDS:
+    Requests use the path of the first --url, backends differ by host/port.
+    --lb <policy>            round-robin (default), random,
+                             least-outstanding or hash (on the path)
+    --resolve-all            Use every address the host resolves to
+
+SOCKETS:
+    --source-addresses <list>  Spread connections over local IPs, e.g.
+                               127.0.0.2-127.0.0.50 or 10.0.0.1,10.0.0.2
+    --tcp-nodelay              Set TCP_NODELAY
+    --sndbuf <bytes>           Set SO_SNDBUF
+    --rcvbuf <bytes>           Set SO_RCVBUF
+    --quickack                 Set TCP_QUICKACK
+    --fastopen                 Use TCP Fast Open (TCP_FASTOPEN_CONNECT)
+    --linger-reset             Close with RST (SO_LINGER 0), no TIME_WAIT
+    --kernel-timestamps        Kernel TX/RX timestamps (SO_TIMESTAMPING) to
+                               split network + server time from the time
+                               responses wait before being read
+
+WARMUP:
+    Warmup requests are reported separately and excluded from the results.
+    The --duration / --requests limits apply to the measured window.
+    --warmup <spec>          <n>s = duration, <n> = request count,
+                             auto = until throughput and p50 are steady
+    --steady-threshold <cv>  Auto: max coefficient of variation over 5 1s
+                             windows (default: 0.05)
+    --warmup-max <n>         Auto: give up after n seconds (default: 60)
+
+TEMPLATES:
+    The URL path, headers and --body may contain placeholders:
+    {{seq}} request number, {{rand}} / {{rand:1-1000}} random number,
+    {{hex:n}} n random hex digits, {{name}} / {{name.column}} feeder value.
+    -H, --header <header>    Extra header "Name: value", repeatable
+    --body <text>            Request body
+    --feeder <name>=<file>   Values for {{name}}, one per line, or a CSV
+                             (*.csv) with a header row for {{name.column}}
+    --seed <n>               Seed for random values (default: 1)
+
+WEBSOCKET:
+    Each worker upgrades one connection (ws://host/path, or --websocket)
+    and times every message until the server's echo. -r counts messages.
+    --ws-rate <n>            Messages per second per connection, 0 =
+                             ping-pong with one in flight (default: 0)
+    --ws-message <text>      Text message to send
+    --ws-size <bytes>        Binary message size without --ws-message
+                             (default: 32)
+    --ws-ping                Send Ping frames and time the Pong, works
+                             against any server
+
+REPLAY:
+    Sends each request from a Common/Combined Log Format file, or a TSV of
+    timestamp, method, path[, body-file], at its original relative time.
+    --speed <factor>         Replay speed-up factor (default: 1.0)
+
+HOLD:
+    Connection capacity: open and hold n keep-alive connections from a few
+    epoll threads (spread them with --source-addresses past ~28k). Prints
+    connections, connect rate, memory and trickle latency every second.
+    Runs for -d seconds, or until Ctrl-C.
+    --hold <n>               Connections to hold
+    --hold-interval <s>      Seconds between requests per connection,
+                             0 = connect only (default: 30)
+    --hold-rate <n>          New connections per second (default: no limit)
+    --hold-threads <n>       Event loop threads (default: one per core)
+
+SOAK:
+    For long runs: every interval's counts and latency histogram are
+    appended to a log and synced, memory use stays constant. <file>.checkpoint
+    holds the whole run so far, so a killed run can still be reported.
+    --soak-log <file>        Write the interval log
+    --soak-interval <s>      Seconds per interval (default: 10)
+    soak-report <file>       Rebuild the report from a log (or checkpoint)
+      --from <s> --to <s>    Only intervals starting in this window
+
+SWEEP:
+    Runs every combination back to back in one process (body sizes outer,
+    concurrency inner), each cell with the -r / -d / --warmup limits, and
+    prints one table with throughput and percentiles per cell.
+    --sweep-concurrency <list>  Worker counts, e.g. 1,2,4,8,16,32
+    --sweep-body <list>         Request body sizes in bytes, e.g. 0,1024,65536
+                                (POST unless -X is given)
+    --sweep-cooldown <s>        Idle seconds between cells (default: 2)
+    --sweep-json <file>         Also write the cells as JSON for plotting
+
+BASELINES:
+    --save-baseline <file>          Save summary + latency histogram as JSON
+    --compare <file>                Compare against a saved baseline, exit 2 on regression
+    --max-latency-regression <pct>  Allowed p50/p90/p99 increase (default: 10)
+    --max-throughput-drop <pct>     Allowed requests/sec drop (default: 10)
+    --max-error-increase <pts>      Allowed error rate increase in points (default: 1)
+    --significance <alpha>          Mann-Whitney significance level (default: 0.05)
+
 EXAMPLES:
     surge --url http://localhost:8080
     surge --url http://api.example.com/users -c 50 -r 1000
     surge --url http://localhost:3000/api/test -v
     surge --url http://example.com/ -c 50 -d 120
+    surge --url http://example.com/ -c 50 -d 3600 --metrics-port 9100
+    surge --url http://localhost:8080/ -d 30 --compare baseline.json
+    surge --url http://localhost:8080/ -d 60 --warmup auto
+    surge --url http+unix:///run/app.sock:/health -c 32 -d 30
+    surge --url http://localhost:8080/upload --body-file payload.bin -c 16 -d 30
+    surge --url 'http://localhost:8080/users/{{users.id}}?q={{hex:8}}' --feeder users=users.csv
+    surge --url http://localhost:8080/ -d 60 --trace-out slow.json --exemplar-threshold 250
+    surge --url http://10.0.0.1:8080/api --url http://10.0.0.2:8080 --lb least-outstanding
+    surge replay access.log --url http://localhost:8080 -c 64 --speed 2
+    surge --url http://localhost:8080/ -c 32 -d 86400 --soak-log soak.log --soak-interval 60
+    surge soak-report soak.log --from 3600 --to 7200
+    surge --url http://localhost:8080/api -d 20 --sweep-concurrency 1,4,16,64 --sweep-body 0,4096 --sweep-json sweep.json
+    surge --url http://10.0.0.5:8080/ping --hold 200000 --hold-rate 5000 --source-addresses 10.0.1.1-10.0.1.10 -d 600
 )";
 }
 
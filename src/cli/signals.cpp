@@ -0,0 +1,53 @@
+#include "cli/signals.hpp"
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <pthread.h>
+
+namespace surge::cli {
+    namespace {
+        sigset_t stop_signals() {
+            sigset_t set;
+            sigemptyset(&set);
+            sigaddset(&set, SIGINT);
+            sigaddset(&set, SIGTERM);
+            return set;
+        }
+    }
+
+    StopSignals::StopSignals(std::function<void()> on_stop)
+        : on_stop_(std::move(on_stop))
+    {
+        sigset_t set = stop_signals();
+        pthread_sigmask(SIG_BLOCK, &set, nullptr);
+
+        waiter_ = std::jthread([this, set]() {
+            while (true) {
+                int signal = 0;
+                if (sigwait(&set, &signal) != 0 || finished_) {
+                    return;
+                }
+
+                if (received_.exchange(true)) {
+                    // Second Ctrl-C: give up on the partial report
+                    std::_Exit(128 + signal);
+                }
+
+                std::cerr << "\nStopping, reporting partial results (repeat to quit)\n";
+                on_stop_();
+            }
+        });
+    }
+
+    StopSignals::~StopSignals() {
+        // Wake the waiter with a signal only it receives
+        finished_ = true;
+        pthread_kill(waiter_.native_handle(), SIGTERM);
+        waiter_.join();
+
+        sigset_t set = stop_signals();
+        pthread_sigmask(SIG_UNBLOCK, &set, nullptr);
+    }
+}
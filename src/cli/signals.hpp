@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace surge::cli {
+
+    // Turns SIGINT/SIGTERM into a call to on_stop, from a normal thread rather
+    // than a signal handler so on_stop may lock and notify
+    // Create before any other thread: the signals are blocked in every thread
+    // started afterwards and taken with sigwait() here. A second signal exits at once
+    class StopSignals {
+        public:
+            explicit StopSignals(std::function<void()> on_stop);
+            ~StopSignals();
+
+            // Disable copy
+            StopSignals(const StopSignals&) = delete;
+            StopSignals& operator=(const StopSignals&) = delete;
+
+            // A signal was received
+            bool received() const { return received_; }
+
+        private:
+            std::function<void()> on_stop_;
+            std::atomic<bool> received_{false};
+            std::atomic<bool> finished_{false};
+            std::jthread waiter_;
+    };
+
+}
@@ -0,0 +1,112 @@
+#include "core/balancer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace surge::core {
+    std::optional<BalancePolicy> parse_balance_policy(std::string_view name) {
+        if (name == "round-robin" || name == "rr") {
+            return BalancePolicy::RoundRobin;
+        }
+        if (name == "random") {
+            return BalancePolicy::Random;
+        }
+        if (name == "least-outstanding" || name == "least") {
+            return BalancePolicy::LeastOutstanding;
+        }
+        if (name == "hash" || name == "consistent-hash") {
+            return BalancePolicy::ConsistentHash;
+        }
+        return std::nullopt;
+    }
+
+    const char* to_string(BalancePolicy policy) {
+        switch (policy) {
+            case BalancePolicy::RoundRobin: return "round-robin";
+            case BalancePolicy::Random: return "random";
+            case BalancePolicy::LeastOutstanding: return "least-outstanding";
+            case BalancePolicy::ConsistentHash: return "hash";
+        }
+        return "unknown";
+    }
+
+    Balancer::Balancer(std::size_t backends, BalancePolicy policy)
+        : backends_(backends)
+        , policy_(policy)
+        , outstanding_(std::make_unique<std::atomic<std::uint32_t>[]>(backends))
+    {
+        if (policy_ == BalancePolicy::ConsistentHash) {
+            ring_.reserve(backends_ * VIRTUAL_NODES);
+            for (std::size_t backend = 0; backend < backends_; ++backend) {
+                for (std::size_t node = 0; node < VIRTUAL_NODES; ++node) {
+                    std::string label = std::to_string(backend) + "#" + std::to_string(node);
+                    ring_.emplace_back(hash(label), backend);
+                }
+            }
+            std::sort(ring_.begin(), ring_.end());
+        }
+    }
+
+    // FNV-1a 64 with a final avalanche so nearby keys spread over the ring
+    std::uint64_t Balancer::hash(std::string_view key) {
+        std::uint64_t h = 14695981039346656037ULL;
+        for (char c : key) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ULL;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Scan from a rotating start so ties spread evenly
+    std::size_t Balancer::least_outstanding() {
+        std::size_t start = next_.fetch_add(1, std::memory_order_relaxed) % backends_;
+        std::size_t best = start;
+        std::uint32_t best_count = outstanding_[start].load(std::memory_order_relaxed);
+
+        for (std::size_t i = 1; i < backends_ && best_count > 0; ++i) {
+            std::size_t candidate = (start + i) % backends_;
+            std::uint32_t count = outstanding_[candidate].load(std::memory_order_relaxed);
+            if (count < best_count) {
+                best = candidate;
+                best_count = count;
+            }
+        }
+        return best;
+    }
+
+    std::size_t Balancer::select(std::string_view key) {
+        std::size_t backend = 0;
+
+        switch (policy_) {
+            case BalancePolicy::RoundRobin:
+                backend = next_.fetch_add(1, std::memory_order_relaxed) % backends_;
+                break;
+            case BalancePolicy::Random: {
+                thread_local std::minstd_rand generator(std::random_device{}());
+                backend = std::uniform_int_distribution<std::size_t>(0, backends_ - 1)(generator);
+                break;
+            }
+            case BalancePolicy::LeastOutstanding:
+                backend = least_outstanding();
+                break;
+            case BalancePolicy::ConsistentHash: {
+                // First ring point at or after the key's hash, wrapping around
+                auto point = std::lower_bound(ring_.begin(), ring_.end(), std::make_pair(hash(key), std::size_t{0}));
+                backend = (point == ring_.end() ? ring_.front() : *point).second;
+                break;
+            }
+        }
+
+        outstanding_[backend].fetch_add(1, std::memory_order_relaxed);
+        return backend;
+    }
+
+    void Balancer::release(std::size_t backend) {
+        outstanding_[backend].fetch_sub(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace surge::core {
+    enum class BalancePolicy {
+        RoundRobin,         // Each backend in turn
+        Random,             // Uniform random pick
+        LeastOutstanding,   // Fewest requests in flight
+        ConsistentHash,     // Same path key -> same backend
+    };
+
+    // "round-robin", "random", "least-outstanding", "hash"
+    std::optional<BalancePolicy> parse_balance_policy(std::string_view name);
+
+    const char* to_string(BalancePolicy policy);
+
+    // Picks a backend per request, thread safe
+    class Balancer {
+        public:
+            Balancer(std::size_t backends, BalancePolicy policy);
+
+            // Disable copy
+            Balancer(const Balancer&) = delete;
+            Balancer& operator=(const Balancer&) = delete;
+
+            // Choose a backend, key is only used for consistent hashing
+            // Every select() must be paired with a release() once the request completes
+            std::size_t select(std::string_view key);
+
+            void release(std::size_t backend);
+
+        private:
+            // Virtual nodes per backend on the hash ring
+            static constexpr std::size_t VIRTUAL_NODES = 128;
+
+            static std::uint64_t hash(std::string_view key);
+
+            std::size_t least_outstanding();
+
+            std::size_t backends_;
+            BalancePolicy policy_;
+
+            std::atomic<std::size_t> next_{0};
+            std::unique_ptr<std::atomic<std::uint32_t>[]> outstanding_;
+
+            // Sorted (hash, backend) points
+            std::vector<std::pair<std::uint64_t, std::size_t>> ring_;
+    };
+}
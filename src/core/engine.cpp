@@ -1,24 +1,69 @@
 #include "core/engine.hpp"
 #include "cli/config.hpp"
+#include "core/replay.hpp"
+#include "core/balancer.hpp"
 #include "core/thread_pool.hpp"
 #include "http/client.hpp"
+#include "http/clock.hpp"
 #include "http/request.hpp"
-#include "http/response.hpp"
+#include "http/result.hpp"
+#include "http/url.hpp"
+#include "http/websocket.hpp"
 #include "stats/metrics.hpp"
+#include "stats/steady_state.hpp"
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
+#include <netdb.h>
+#include <poll.h>
+#include <arpa/inet.h>
 
 namespace surge::core {
     // Constructor
     Engine::Engine(const cli::Config& config)
         : config_(config)
         , pool_(nullptr)
-        , collector_()
+        , collector_(config.latency_by_code)
         , running_(false)
         , stop_requested_(false)
+        , requests_started_(0)
         , requests_completed_(0)
-    {}
+    {
+        socket_options_.tcp_nodelay = config_.tcp_nodelay;
+        socket_options_.send_buffer = static_cast<int>(config_.send_buffer);
+        socket_options_.receive_buffer = static_cast<int>(config_.receive_buffer);
+        socket_options_.quickack = config_.tcp_quickack;
+        socket_options_.fast_open = config_.tcp_fast_open;
+        socket_options_.linger_reset = config_.linger_reset;
+        socket_options_.kernel_timestamps = config_.kernel_timestamps;
+        socket_options_.local_port = !config_.trace_file.empty();
+
+        // Download mode drops TCP bodies in the kernel, the buffer is for other sockets
+        receive_options_.discard_in_kernel = config_.download;
+        receive_options_.response_time_header = config_.response_time_header;
+        receive_options_.accept_encoding = config_.accept_encoding;
+        receive_options_.decompress = config_.decompress;
+        receive_options_.body_buffer = config_.recv_buffer > 0 ? config_.recv_buffer
+                                     : config_.download ? DOWNLOAD_BUFFER : 0;
+
+        if (!config_.source_addresses.empty()) {
+            if (auto addresses = http::SourceAddressPool::parse(config_.source_addresses)) {
+                source_pool_ = std::make_unique<http::SourceAddressPool>(std::move(*addresses));
+                socket_options_.source_addresses = source_pool_.get();
+            }
+        }
+
+        if (!config_.body_file.empty()) {
+            body_file_ = std::make_unique<http::BodyFile>(config_.body_file);
+        }
+
+        setup_backends();
+    }
 
     // Destructor
     Engine::~Engine() {
@@ -30,46 +75,551 @@ namespace surge::core {
         // Workers all join jthread handles
     }
 
-    // Execute a single HTTP request
-    // Called by workers
-    void Engine::execute_request() {
-        // Create HTTP Client per request - move to connection pooling later for performance
-        http::Client client;
+    void Engine::setup_backends() {
+        std::vector<std::string> targets = config_.targets;
+        if (targets.empty()) {
+            targets.push_back(config_.url);
+        }
+
+        // One host, every address it resolves to is a backend (Host header keeps the name)
+        if (config_.resolve_all && targets.size() == 1 && !http::is_unix_url(targets.front())) {
+            std::string_view base = http::url_base(targets.front());
+            size_t host_start = base.find("://");
+            std::string_view scheme = host_start == std::string_view::npos ? "http" : base.substr(0, host_start);
+            std::string_view host_port = host_start == std::string_view::npos ? base : base.substr(host_start + 3);
+            size_t colon = host_port.find(':');
+            std::string host(host_port.substr(0, colon));
+            std::string port(colon == std::string_view::npos ? "80" : host_port.substr(colon + 1));
+
+            addrinfo hints{};
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* info = nullptr;
+            if (getaddrinfo(host.c_str(), nullptr, &hints, &info) == 0) {
+                std::vector<std::string> resolved;
+                for (addrinfo* entry = info; entry != nullptr; entry = entry->ai_next) {
+                    char address[INET_ADDRSTRLEN];
+                    auto* ipv4 = reinterpret_cast<sockaddr_in*>(entry->ai_addr);
+                    inet_ntop(AF_INET, &ipv4->sin_addr, address, sizeof(address));
+                    std::string target = std::string(scheme) + "://" + address + ":" + port;
+                    if (std::find(resolved.begin(), resolved.end(), target) == resolved.end()) {
+                        resolved.push_back(target);
+                    }
+                }
+                freeaddrinfo(info);
+
+                if (!resolved.empty()) {
+                    targets = std::move(resolved);
+                    host_header_ = host;
+                }
+            }
+        }
+
+        for (const std::string& target : targets) {
+            backends_.push_back(Backend{
+                .name = std::string(http::url_base(target)),
+                .base = std::string(http::url_base(target)),
+                .collector = std::make_unique<stats::Collector>(),
+            });
+        }
+
+        if (backends_.size() > 1) {
+            auto policy = parse_balance_policy(config_.balance_policy).value_or(BalancePolicy::RoundRobin);
+            balancer_ = std::make_unique<Balancer>(backends_.size(), policy);
+        }
+    }
+
+    bool Engine::prepare() {
+        std::string error;
+        if (!templates_.load(config_, error)) {
+            std::cerr << "Error: " << error << "\n";
+            return false;
+        }
+        if (!config_.replay_file.empty() && !LogReader(config_.replay_file).is_open()) {
+            std::cerr << "Error: could not open replay log: " << config_.replay_file << "\n";
+            return false;
+        }
+
+        // Reset here rather than in run(), so a stop() between prepare() and run() is not lost
+        stop_requested_ = false;
+        interrupted_ = false;
+        deadline_ = std::chrono::steady_clock::time_point::max();
+        return true;
+    }
+
+    // Reuses the request's url capacity, no allocation per request
+    std::size_t Engine::route(http::Request& request, std::string_view path) {
+        std::size_t backend = balancer_ ? balancer_->select(path) : 0;
+        request.url.assign(backends_[backend].base).append(path);
+        return backend;
+    }
+
+    // Worker main loop
+    // The client and request live for the whole worker, so buffers and the
+    // resolved endpoint are reused and the steady state path does not allocate
+    void Engine::worker_loop(std::uint32_t worker) {
+        http::Client client(socket_options_, receive_options_);
 
-        // Build request
+        // Build request, path, headers and body are rendered into the worker's scratch buffers
         http::Request request;
-        request.url = config_.url;
         request.method = config_.method.value_or("GET");
+        request.host = host_header_;
+        request.body_file = body_file_ && body_file_->is_open() ? body_file_.get() : nullptr;
+        RenderState render = templates_.make_state(worker);
+        WorkerContext context{
+            .worker = worker,
+            .paths = path_stats_.empty() ? nullptr : path_stats_[worker].get(),
+            .render = &render,
+        };
+
+        Phase phase = Phase::Measured;
+        while (should_continue(phase)) {
+            templates_.render(render, request);
+            std::size_t backend = route(request, render.path);
+            execute_request(client, request, phase, backend, context);
+        }
+    }
+
+    // Messages are sent from one precomputed frame, replies are matched to send times in order
+    // (a connection's echoes come back in the order they were sent)
+    void Engine::websocket_loop(std::uint32_t worker) {
+        http::Client client(socket_options_, receive_options_);
+        http::Request request;
+        request.host = host_header_;
+        RenderState render = templates_.make_state(worker);
+        templates_.render(render, request);
+        request.url.assign(backends_.front().base).append(render.path);
+
+        http::Result handshake;
+        std::string leftover;
+        int sock = client.upgrade(request, handshake, leftover);
+        if (sock < 0) {
+            collector_.request_started();
+            collector_.record(handshake);
+            return;
+        }
+        collector_.record_connection(handshake);
+        collector_.connection_held();
+
+        http::WebSocket socket(sock, leftover);
+        std::string payload = config_.ws_message.empty() ? std::string(config_.ws_size, 'x') : config_.ws_message;
+        http::Opcode opcode = config_.ws_ping ? http::Opcode::Ping
+                            : config_.ws_message.empty() ? http::Opcode::Binary : http::Opcode::Text;
+        socket.prepare(opcode, payload, static_cast<std::uint32_t>(render.random()));
+
+        // Send times of the messages in flight, oldest at head
+        std::vector<std::uint64_t> sent_at(WEBSOCKET_WINDOW);
+        std::size_t head = 0;
+        std::size_t outstanding = 0;
+
+        const bool ping_pong = config_.ws_rate <= 0;
+        const double ticks_per_second = http::TscClock::ticks_per_second();
+        const auto interval = static_cast<std::uint64_t>(ping_pong ? 1.0 : std::max(1.0, ticks_per_second / config_.ws_rate));
+        std::uint64_t next_send = http::TscClock::now();
+
+        bool sending = true;
+        bool failed = false;
+        std::uint64_t drain_until = 0;
+        Phase phase = Phase::Measured;
+
+        while (true) {
+            std::uint64_t now = http::TscClock::now();
+
+            if (sending) {
+                std::size_t due = ping_pong ? (outstanding == 0 ? 1 : 0)
+                                : now >= next_send ? 1 + static_cast<std::size_t>((now - next_send) / interval) : 0;
+                due = std::min({due, WEBSOCKET_WINDOW - outstanding, WEBSOCKET_BATCH});
+
+                std::size_t claimed = 0;
+                while (claimed < due && should_continue(phase)) {
+                    ++claimed;
+                }
+                if (claimed < due) {
+                    sending = false;
+                    drain_until = now + static_cast<std::uint64_t>(ticks_per_second * WEBSOCKET_DRAIN.count());
+                }
+
+                if (claimed > 0) {
+                    if (!socket.send(claimed)) {
+                        failed = true;
+                        break;
+                    }
+                    for (std::size_t i = 0; i < claimed; ++i) {
+                        sent_at[(head + outstanding) % WEBSOCKET_WINDOW] = now;
+                        ++outstanding;
+                        collector_.request_started();
+                    }
+                    if (!ping_pong) {
+                        next_send += claimed * interval;
+                    }
+                }
+            }
+
+            // Budget used up: wait for the last replies, unless the run has ended
+            if (!sending && (outstanding == 0 || stop_requested_.load(std::memory_order_relaxed) ||
+                             past_deadline() || now >= drain_until)) {
+                break;
+            }
+
+            // Sleep until the next send is due or a reply arrives, waking regularly to notice stop()
+            std::uint64_t wait_ticks = static_cast<std::uint64_t>(ticks_per_second / 10);
+            if (sending && !ping_pong && outstanding < WEBSOCKET_WINDOW) {
+                wait_ticks = next_send > now ? std::min(wait_ticks, next_send - now) : 0;
+            }
+            auto wait_ns = static_cast<std::int64_t>(static_cast<double>(wait_ticks) * 1e9 / ticks_per_second);
+            timespec timeout{static_cast<time_t>(wait_ns / 1'000'000'000), static_cast<long>(wait_ns % 1'000'000'000)};
+            pollfd readable{socket.fd(), POLLIN, 0};
+            if (ppoll(&readable, 1, &timeout, nullptr) <= 0) {
+                continue;
+            }
+
+            std::size_t replies = 0;
+            std::uint64_t bytes = 0;
+            bool open = socket.receive(replies, bytes);
+            std::uint64_t received_at = http::TscClock::now();
+            bool cut_off = past_deadline();
+
+            replies = std::min(replies, outstanding);
+            for (std::size_t i = 0; i < replies; ++i) {
+                if (cut_off) {
+                    collector_.request_abandoned();
+                    requests_cut_off_++;
+                } else {
+                    http::Result result;
+                    result.success = true;
+                    result.status_code = 101;
+                    result.latency = http::TscClock::elapsed(sent_at[head], received_at);
+                    result.first_byte = result.latency;
+                    result.bytes_sent = socket.frame_size();
+                    result.bytes_received = bytes / replies;
+                    collector_.record(result);
+                }
+                head = (head + 1) % WEBSOCKET_WINDOW;
+                --outstanding;
+                requests_completed_++;
+            }
+
+            if (!open) {
+                failed = true;
+                break;
+            }
+        }
+
+        // Messages still waiting: lost with the connection, or in flight when the run ended
+        std::uint64_t ended_at = http::TscClock::now();
+        for (; outstanding > 0; --outstanding) {
+            if (failed) {
+                http::Result result;
+                result.connect_attempted = true;
+                result.error = "WebSocket connection closed";
+                result.latency = http::TscClock::elapsed(sent_at[head], ended_at);
+                collector_.record(result);
+            } else {
+                collector_.request_abandoned();
+                requests_cut_off_++;
+            }
+            head = (head + 1) % WEBSOCKET_WINDOW;
+        }
+        collector_.connection_released();
+    }
+
+    // Replay worker: takes entries from the dispatcher queue and sends them
+    void Engine::replay_worker_loop(std::uint32_t worker) {
+        http::Client client(socket_options_, receive_options_);
+        http::Request request;
+        ReplayEntry entry;
+        request.host = host_header_;
+        RenderState render = templates_.make_state(worker);
+        WorkerContext context{
+            .worker = worker,
+            .paths = path_stats_.empty() ? nullptr : path_stats_[worker].get(),
+            .render = &render,
+        };
+
+        while (!stop_requested_ && replay_queue_->pop(entry)) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline_.load()) {
+                break;
+            }
+
+            // How far behind the log's schedule this request starts
+            auto lag = std::chrono::duration_cast<std::chrono::microseconds>(now - replay_due(entry.offset));
+            if (lag > REPLAY_LATE_THRESHOLD) {
+                replay_late_++;
+            }
+            std::int64_t max_lag = replay_max_lag_us_.load();
+            while (lag.count() > max_lag && !replay_max_lag_us_.compare_exchange_weak(max_lag, lag.count())) {}
+
+            // Reuse string capacity, the request is rebuilt in place
+            request.method.assign(entry.method);
+            std::size_t backend = route(request, entry.path);
+            request.body_file = entry.body_file.empty() ? nullptr : replay_body(entry.body_file);
+            templates_.render_headers(render, request);
+
+            execute_request(client, request, current_phase(), backend, context);
+        }
+
+        // Leaving early (stop or deadline): wake a dispatcher blocked on a full queue
+        replay_queue_->close();
+    }
+
+    // Body-ref files are shared between workers and stay open for the run
+    const http::BodyFile* Engine::replay_body(const std::string& filepath) {
+        std::lock_guard lock(replay_bodies_mutex_);
+        auto [it, inserted] = replay_bodies_.try_emplace(filepath);
+        if (inserted) {
+            auto body = std::make_unique<http::BodyFile>(filepath);
+            if (body->is_open()) {
+                it->second = std::move(body);
+            } else {
+                std::cerr << "Warning: could not open replay body: " << filepath << "\n";
+            }
+        }
+        return it->second.get();
+    }
+
+    // When an entry is due, the log's relative offset scaled by the speed factor
+    std::chrono::steady_clock::time_point Engine::replay_due(std::chrono::microseconds offset) const {
+        auto scaled = std::chrono::duration<double, std::micro>(offset.count() / config_.replay_speed);
+        return start_time_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(scaled);
+    }
+
+    // Read the log and hand each entry to the workers at its original relative time
+    void Engine::dispatch_replay(LogReader& reader) {
+        ReplayEntry entry;
+        std::uint64_t dispatched = 0;
+
+        while (!stop_requested_ && reader.next(entry)) {
+            if (config_.requests > 0 && dispatched >= config_.requests) {
+                break;
+            }
+
+            auto due = replay_due(entry.offset);
+            if (due >= deadline_.load()) {
+                break;
+            }
+
+            // Sleep until due, stop() wakes us
+            {
+                std::unique_lock lock(stop_mutex_);
+                stop_condition_.wait_until(lock, due, [this]() {
+                    return stop_requested_.load();
+                });
+            }
+            if (stop_requested_) {
+                break;
+            }
+
+            if (!replay_queue_->push(entry)) {
+                break;
+            }
+            dispatched++;
+        }
+
+        replay_queue_->close();
+        replay_dispatched_ = dispatched;
+    }
+
+    // Execute a single HTTP request
+    // Called by workers
+    void Engine::execute_request(http::Client& client, const http::Request& request, Phase phase, std::size_t backend,
+                                 const WorkerContext& context) {
+        stats::Collector& collector = phase == Phase::Warmup ? warmup_collector_ : collector_;
 
         // Execute request
-        http::Response response = client.execute(request);
+        collector.request_started();
+        http::Result result = client.execute(request);
+
+        // Finished after the run ended (deadline or stop), exclude it so the window is exact
+        if (phase == Phase::Measured && past_deadline()) {
+            collector.request_abandoned();
+            if (balancer_) {
+                balancer_->release(backend);
+            }
+            requests_cut_off_++;
+            requests_completed_++;
+            return;
+        }
 
         // Record result (thread safe)
-        collector_.record(response);
+        collector.record(result);
+
+        // Per path latency, measured successes only like the latency histogram
+        if (context.paths != nullptr && result.success && phase == Phase::Measured) {
+            context.paths->record(http::url_path(request.url), static_cast<std::uint64_t>(result.latency.count()));
+        }
+
+        // Exemplars: one compare per request, detail only for the few that may be kept
+        if (exemplars_ && phase == Phase::Measured &&
+            static_cast<std::uint64_t>(result.latency.count()) >= exemplars_->floor()) {
+            capture_exemplar(client, request, result, context);
+        }
+
+        // Per backend stats cover the measured window only
+        if (balancer_) {
+            balancer_->release(backend);
+            if (phase == Phase::Measured) {
+                backends_[backend].collector->request_started();
+                backends_[backend].collector->record(result);
+            }
+        }
 
         // Increment req completed
         requests_completed_++;
     }
 
-    // Check if test should continue
-    // Return false when limits reached
-    bool Engine::should_continue() const {
-        // Check stop flag
+    void Engine::capture_exemplar(const http::Client& client, const http::Request& request, const http::Result& result,
+                                  const WorkerContext& context) {
+        stats::Admission admission = exemplars_->admit(static_cast<std::uint64_t>(result.latency.count()));
+        if (!admission) {
+            return;
+        }
+
+        // The wall clock start is taken back from now, a few μs late at most
+        auto started = std::chrono::system_clock::now() -
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(result.latency + result.decode_time);
+
+        stats::Exemplar exemplar{
+            .id = admission.id,
+            .started = started,
+            .worker = context.worker,
+            .connection = client.connections_opened(),
+            .local_port = result.local_port,
+            .sequence = context.render != nullptr ? context.render->sequence : 0,
+            .method = request.method,
+            .url = request.url,
+            .request_headers = request.headers,
+            .response_head = std::string(client.response_head()),
+            .status_code = result.status_code,
+            .success = result.success,
+            .error = result.error,
+            .connected = result.connected,
+            .connect_time = result.connect_time,
+            .first_byte = result.first_byte,
+            .latency = result.latency,
+            .decode_time = result.decode_time,
+            .timestamped = result.timestamped,
+            .network_time = result.network_time,
+            .read_delay = result.read_delay,
+            .bytes_sent = result.bytes_sent,
+            .bytes_received = result.bytes_received,
+            .server_time_ms = result.server_time_ms,
+            .slowest = false,
+            .sampled = false,
+        };
+        exemplars_->keep(admission, std::move(exemplar));
+    }
+
+    bool Engine::has_warmup() const {
+        return config_.warmup_seconds > 0 || config_.warmup_requests > 0 || config_.warmup_auto;
+    }
+
+    // Phase for the next request, ends a request-count warmup once its budget is used
+    Engine::Phase Engine::current_phase() {
+        if (!warming_up_) {
+            return Phase::Measured;
+        }
+        if (config_.warmup_requests > 0) {
+            if (warmup_started_.fetch_add(1) < config_.warmup_requests) {
+                return Phase::Warmup;
+            }
+            end_warmup(std::chrono::steady_clock::now());
+            return Phase::Measured;
+        }
+        return Phase::Warmup;
+    }
+
+    // Switch to the measured window, the duration limit counts from here
+    void Engine::end_warmup(std::chrono::steady_clock::time_point now) {
+        // A stopped run ends during warmup, the deadline must not move past the stop
         if (stop_requested_) {
-            return false;
+            return;
+        }
+
+        bool expected = true;
+        if (!warming_up_.compare_exchange_strong(expected, false)) {
+            return; // Already ended
         }
 
-        // Check duration limit if set
-        if (deadline_.has_value()) {
+        measure_start_ = now;
+        if (config_.duration_seconds > 0) {
+            deadline_ = now + std::chrono::seconds(config_.duration_seconds);
+        }
+    }
+
+    // Ends time based warmups, in auto mode waits for steady throughput and p50
+    void Engine::monitor_warmup(std::stop_token stop_token) {
+        auto limit = start_time_ + std::chrono::seconds(
+            config_.warmup_auto ? config_.warmup_max_seconds : config_.warmup_seconds);
+
+        stats::SteadyStateDetector detector(STEADY_STATE_WINDOWS, config_.steady_threshold);
+        stats::Metrics previous = warmup_collector_.get_metrics();
+        auto window_start = std::chrono::steady_clock::now();
+
+        while (!stop_token.stop_requested() && warming_up_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
             auto now = std::chrono::steady_clock::now();
-            if (now >= *deadline_) {
-                return false; // Time deadline reached
+
+            if (now >= limit) {
+                end_warmup(now);
+                return;
             }
+
+            if (!config_.warmup_auto || now - window_start < STEADY_STATE_WINDOW) {
+                continue;
+            }
+
+            // One window: throughput and p50 of the requests completed in it
+            stats::Metrics current = warmup_collector_.get_metrics();
+            stats::Histogram window = current.latency_histogram;
+            window.subtract(previous.latency_histogram);
+
+            double seconds = std::chrono::duration<double>(now - window_start).count();
+            double throughput = (current.total_requests - previous.total_requests) / seconds;
+            detector.add_window(throughput, static_cast<double>(window.value_at(0.50)));
+
+            previous = std::move(current);
+            window_start = now;
+
+            if (detector.steady()) {
+                steady_state_detected_ = true;
+                end_warmup(now);
+                return;
+            }
+        }
+    }
+
+    // Without a duration only stop() sets the deadline, the clock is read once it has
+    bool Engine::past_deadline() const {
+        auto deadline = deadline_.load(std::memory_order_relaxed);
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            return false;
+        }
+        return std::chrono::steady_clock::now() > deadline;
+    }
+
+    // Check if test should continue, claims the next request from the budget
+    // Return false when limits reached
+    bool Engine::should_continue(Phase& phase) {
+        // Check stop flag, stop() also ends runs without a duration
+        if (stop_requested_.load(std::memory_order_relaxed)) {
+            return false;
         }
 
-        // Check request limit if set
+        // Check duration limit (max() until known)
+        if (std::chrono::steady_clock::now() >= deadline_.load(std::memory_order_relaxed)) {
+            return false; // Time deadline reached
+        }
+
+        // Warmup requests dont use the request budget
+        phase = current_phase();
+        if (phase == Phase::Warmup) {
+            return true;
+        }
+
+        // Check request limit if set, workers claim slots so exactly N are sent
         if (config_.requests > 0) {
-            if (requests_completed_ >= config_.requests) {
+            if (requests_started_.fetch_add(1, std::memory_order_relaxed) >= config_.requests) {
                 return false;
             }
         }
@@ -78,75 +628,125 @@ namespace surge::core {
     }
 
     // Wait for load test to complete
+    // Workers leave their loops at the deadline, budget or stop(), the pool wakes us when the last one exits
     void Engine::wait_for_completion() {
-    if (config_.duration_seconds > 0) {
-        // Duration-based: poll until deadline, then wait for workers
-        while (running_ && !stop_requested_) {
-            if (deadline_.has_value()) {
-                auto now = std::chrono::steady_clock::now();
-                if (now >= *deadline_) {
-                    running_ = false;
-                    break;
-                }
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-        
-        // Wait for workers to see the deadline and exit their loops
-        pool_->wait_for_completion();
-        
-    } else if (config_.requests > 0) {
-        // Request-based: just wait for all tasks
-        pool_->wait_for_completion();
+        workers_->wait_for_completion();
     }
-}
 
     // Run the load test (blocking)
     Results Engine::run() {
         // Initialise state
         start_time_ = std::chrono::steady_clock::now();
         running_ = true;
-        stop_requested_ = false;
+        requests_started_ = 0;
         requests_completed_ = 0;
+        requests_cut_off_ = 0;
 
-        // Set deadline
-        if (config_.duration_seconds > 0) {
-            deadline_ = start_time_ + std::chrono::seconds(config_.duration_seconds);
+        // Warmup first, measured window (and deadline) starts when it ends
+        warming_up_ = has_warmup();
+        warmup_started_ = 0;
+        steady_state_detected_ = false;
+        measure_start_ = start_time_;
+
+        // Already stopped: workers exit at once and the measured window is empty
+        // Otherwise set the deadline, unless a concurrent stop() pulled it in first
+        if (stop_requested_) {
+            deadline_ = start_time_;
+        } else if (!warming_up_ && config_.duration_seconds > 0) {
+            auto limit = start_time_ + std::chrono::seconds(config_.duration_seconds);
+            auto deadline = deadline_.load();
+            while (limit < deadline && !deadline_.compare_exchange_weak(deadline, limit)) {}
         }
 
-        // Create thread pool
-        pool_ = std::make_unique<ThreadPool>(config_.concurrency);
+        if (config_.warmup_seconds > 0 || config_.warmup_auto) {
+            warmup_monitor_ = std::jthread([this](std::stop_token stop_token) {
+                monitor_warmup(stop_token);
+            });
+        }
 
-        // Submit work 
-        if (config_.requests > 0) {
-            // Request based
-            for (uint32_t i = 0; i < config_.requests; ++i) {
-                pool_->submit([this]() {
-                    execute_request();
+        // Per worker path trackers, nothing is shared on the request path
+        path_stats_.clear();
+        if (config_.top_paths > 0 && !config_.websocket) {
+            for (std::uint32_t i = 0; i < config_.concurrency; ++i) {
+                path_stats_.push_back(std::make_unique<stats::PathStats>(config_.top_paths * PATH_SLOTS_PER_RESULT));
+            }
+        }
+
+        // One exemplar store shared by the workers, they only touch it for slow requests
+        exemplars_.reset();
+        if (!config_.trace_file.empty()) {
+            auto threshold = static_cast<std::uint64_t>(config_.exemplar_threshold_ms * 1000.0);
+            exemplars_ = std::make_unique<stats::ExemplarStore>(
+                config_.exemplars, threshold > 0 ? threshold : stats::ExemplarStore::NO_THRESHOLD, config_.exemplar_samples);
+        }
+
+        // Create thread pool, unless running on a shared one
+        if (shared_pool_ != nullptr) {
+            workers_ = shared_pool_;
+        } else {
+            pool_ = std::make_unique<ThreadPool>(config_.concurrency);
+            workers_ = pool_.get();
+        }
+
+        std::optional<ReplayStats> replay_stats;
+        if (!config_.replay_file.empty()) {
+            // Replay: dispatcher runs here, workers pull from a bounded queue
+            LogReader reader(config_.replay_file);
+
+            replay_queue_ = std::make_unique<ReplayQueue>(config_.concurrency * REPLAY_QUEUE_PER_WORKER);
+            replay_late_ = 0;
+            replay_max_lag_us_ = 0;
+
+            for (uint32_t i = 0; i < config_.concurrency; ++i) {
+                workers_->submit([this, i]() {
+                    replay_worker_loop(i);
                 });
             }
+
+            dispatch_replay(reader);
+            workers_->wait_for_completion();
+
+            replay_stats = ReplayStats{
+                .dispatched = replay_dispatched_,
+                .skipped_lines = reader.skipped(),
+                .late = replay_late_.load(),
+                .max_lag = std::chrono::microseconds(replay_max_lag_us_.load()),
+            };
         } else {
-            // Duration based
+            // Submit one long running loop per worker
+            // Request based runs share the budget via should_continue()
             for (uint32_t i = 0; i < config_.concurrency; ++i) {
-                pool_->submit([this]() {
-                    while (should_continue()) {
-                        execute_request();
+                workers_->submit([this, i]() {
+                    if (config_.websocket) {
+                        websocket_loop(i);
+                    } else {
+                        worker_loop(i);
                     }
                 });
             }
-        }
 
-        // Wait
-        wait_for_completion();
+            // Wait
+            wait_for_completion();
+        }
 
         // Stop workers and cleanup
         running_ = false;
         stop_requested_ = true;
         pool_.reset();
+        workers_ = nullptr;
+        replay_queue_.reset();
+
+        // Stop the warmup monitor if the run ended during warmup
+        if (warmup_monitor_.joinable()) {
+            warmup_monitor_.request_stop();
+            warmup_monitor_.join();
+        }
 
-        // Record test
-        auto end_time = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time_);
+        // Record test, the measured window starts after warmup and ends at the deadline (or stop)
+        // A run that ended during warmup has an empty measured window
+        auto end_time = std::min(std::chrono::steady_clock::now(), deadline_.load());
+        auto measure_start = warming_up_ ? end_time : measure_start_.load();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - measure_start);
         collector_.set_duration(duration);
 
         // Gather results
@@ -155,20 +755,115 @@ namespace surge::core {
 
         // Calculate metrics
         double duration_seconds = duration.count() / 1'000'000.0;
-        double requests_per_second = metrics.total_requests / duration_seconds;
+        double requests_per_second = duration_seconds > 0 ? metrics.total_requests / duration_seconds : 0.0;
+
+        std::optional<WarmupResults> warmup;
+        if (has_warmup()) {
+            auto warmup_duration = std::chrono::duration_cast<std::chrono::microseconds>(measure_start - start_time_);
+            warmup_collector_.set_duration(warmup_duration);
+
+            stats::Metrics warmup_metrics = warmup_collector_.get_metrics();
+            double warmup_seconds = warmup_duration.count() / 1'000'000.0;
+
+            warmup = WarmupResults{
+                .metrics = warmup_metrics,
+                .percentiles = warmup_collector_.calculate_percentiles(),
+                .duration = warmup_duration,
+                .requests_per_second = warmup_seconds > 0 ? warmup_metrics.total_requests / warmup_seconds : 0.0,
+                .steady_state_detected = steady_state_detected_,
+            };
+        }
+
+        std::vector<BackendResults> backend_results;
+        if (backends_.size() > 1) {
+            for (const Backend& backend : backends_) {
+                stats::Metrics backend_metrics = backend.collector->get_metrics();
+                backend_results.push_back(BackendResults{
+                    .target = backend.name,
+                    .metrics = backend_metrics,
+                    .percentiles = backend.collector->calculate_percentiles(),
+                    .requests_per_second = duration_seconds > 0 ? backend_metrics.total_requests / duration_seconds : 0.0,
+                });
+            }
+        }
+
+        std::vector<stats::PathSummary> slowest_paths;
+        std::vector<stats::PathSummary> costliest_paths;
+        if (!path_stats_.empty()) {
+            for (std::size_t i = 1; i < path_stats_.size(); ++i) {
+                path_stats_.front()->merge(*path_stats_[i]);
+            }
+            std::vector<stats::PathSummary> paths = path_stats_.front()->summaries();
+            path_stats_.clear();
+
+            std::size_t top = config_.top_paths;
+            costliest_paths = paths;
+            std::sort(costliest_paths.begin(), costliest_paths.end(), [](const auto& a, const auto& b) {
+                return a.total_time_us > b.total_time_us;
+            });
+            costliest_paths.resize(std::min(costliest_paths.size(), top));
+
+            // A p99 over a handful of requests is noise, rare paths only rank by total time
+            std::erase_if(paths, [](const auto& path) {
+                return path.count < MIN_PATH_SAMPLES;
+            });
+            std::sort(paths.begin(), paths.end(), [](const auto& a, const auto& b) {
+                return a.p99 > b.p99;
+            });
+            paths.resize(std::min(paths.size(), top));
+            slowest_paths = std::move(paths);
+        }
+
+        std::vector<stats::Exemplar> exemplars;
+        std::uint64_t exemplar_threshold_requests = 0;
+        if (exemplars_) {
+            exemplars = exemplars_->take();
+            exemplar_threshold_requests = exemplars_->above_threshold();
+            exemplars_.reset();
+        }
 
         // return results
         return Results {
             .metrics = metrics,
             .percentiles = percentiles,
             .duration = duration,
-            .requests_per_second = requests_per_second
+            .requests_per_second = requests_per_second,
+            .cut_off_requests = requests_cut_off_.load(),
+            .interrupted = interrupted_.load(),
+            .connects_per_second = duration_seconds > 0 ? metrics.connections_opened / duration_seconds : 0.0,
+            .time_wait_sockets = http::count_time_wait_sockets(),
+            .replay = replay_stats,
+            .warmup = warmup,
+            .backends = backend_results,
+            .slowest_paths = slowest_paths,
+            .costliest_paths = costliest_paths,
+            .exemplars = std::move(exemplars),
+            .exemplar_threshold_requests = exemplar_threshold_requests
         };
     }
 
+    // Live stats, safe to read while the test runs
+    const stats::Collector& Engine::collector() const {
+        return collector_;
+    }
+
+    void Engine::share_pool(ThreadPool& pool) {
+        shared_pool_ = &pool;
+    }
+
     // Stop load test early
     void Engine::stop() {
-        stop_requested_ = true;
-        running_ = false;
+        // Pull the deadline in to now, requests finishing later are cut off
+        auto now = std::chrono::steady_clock::now();
+        auto deadline = deadline_.load();
+        while (now < deadline && !deadline_.compare_exchange_weak(deadline, now)) {}
+
+        {
+            std::lock_guard lock(stop_mutex_);
+            interrupted_ = true;
+            stop_requested_ = true;
+            running_ = false;
+        }
+        stop_condition_.notify_all();
     }
 }
\ No newline at end of file
@@ -2,15 +2,58 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <atomic>
+#include <condition_variable>
 #include <optional>
 #include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include "cli/config.hpp"
+#include "core/balancer.hpp"
+#include "core/replay.hpp"
+#include "core/template.hpp"
 #include "core/thread_pool.hpp"
+#include "http/body_file.hpp"
+#include "http/client.hpp"
+#include "http/request.hpp"
+#include "http/socket.hpp"
 #include "stats/collector.hpp"
+#include "stats/exemplars.hpp"
 #include "stats/metrics.hpp"
+#include "stats/path_stats.hpp"
 
 namespace surge::core {
+    // How closely a replay followed the log's timing
+    struct ReplayStats {
+        std::uint64_t dispatched = 0;       // Entries handed to workers
+        std::uint64_t skipped_lines = 0;    // Unparseable log lines
+        std::uint64_t late = 0;             // Requests started more than 10ms behind schedule
+        std::chrono::microseconds max_lag{0};
+    };
+
+    // Numbers for the warmup phase, excluded from the main results
+    struct WarmupResults {
+        stats::Metrics metrics;
+        stats::Percentiles percentiles;
+        std::chrono::microseconds duration;
+        double requests_per_second;
+
+        // Auto mode: steady state found (false = warmup hit its time cap)
+        bool steady_state_detected = false;
+    };
+
+    // Stats for one backend when balancing across several
+    struct BackendResults {
+        std::string target;
+        stats::Metrics metrics;
+        stats::Percentiles percentiles;
+        double requests_per_second;
+    };
+
     struct Results {
         stats::Metrics metrics;
         stats::Percentiles percentiles;
@@ -18,6 +61,33 @@ namespace surge::core {
         std::chrono::microseconds duration;
 
         double requests_per_second; // Throughput
+
+        // Requests in flight at the deadline (or stop), completed late and excluded
+        std::uint64_t cut_off_requests = 0;
+
+        // Stopped early by stop() (SIGINT/SIGTERM), the results cover the partial run
+        bool interrupted = false;
+
+        // Connection churn
+        double connects_per_second = 0.0;
+        std::uint64_t time_wait_sockets = 0;    // System wide, sampled at the end of the run
+
+        // Set for replay runs
+        std::optional<ReplayStats> replay;
+
+        // Set when a warmup phase was configured
+        std::optional<WarmupResults> warmup;
+
+        // Per backend breakdown, only when there is more than one backend
+        std::vector<BackendResults> backends;
+
+        // Worst normalised paths (--top-paths): by p99, and by total time spent in them
+        std::vector<stats::PathSummary> slowest_paths;
+        std::vector<stats::PathSummary> costliest_paths;
+
+        // Slow requests kept in full (--trace-out), slowest first
+        std::vector<stats::Exemplar> exemplars;
+        std::uint64_t exemplar_threshold_requests = 0;  // Measured requests at or above --exemplar-threshold
     };
 
     class Engine {
@@ -31,38 +101,167 @@ namespace surge::core {
             Engine(const Engine&) = delete;
             Engine& operator=(const Engine&) = delete;
 
+            // Open feeders, compile request templates and check the replay log, false (error printed) if invalid
+            // Also clears the stop state: a stop() from here on ends the next run, even before it starts
+            bool prepare();
+
             // Run the load test - main entry point
             Results run();
 
-            // Stop the test early
+            // Stop the test early, safe to call from any thread (after prepare())
+            // The run ends now: requests in flight are cut off and workers exit after them
             void stop();
 
+            // Live stats, safe to read while the test runs
+            const stats::Collector& collector() const;
+
+            // Run the workers on an existing pool of at least --concurrency threads instead of
+            // starting one per run (sweeps), call before run()
+            void share_pool(ThreadPool& pool);
+
         private:
+            // Which histogram a request is recorded into, decided when it is claimed
+            enum class Phase { Warmup, Measured };
+
+            // What execute_request needs from its worker besides the client
+            struct WorkerContext {
+                std::uint32_t worker = 0;
+                stats::PathStats* paths = nullptr;      // --top-paths tracker, null when off
+                const RenderState* render = nullptr;    // {{seq}} of the request, for exemplars
+            };
+
+            // One backend target and its own stats
+            struct Backend {
+                std::string name;       // Shown in the report
+                std::string base;       // "scheme://host:port", request paths are appended
+                std::unique_ptr<stats::Collector> collector;
+            };
+
+            // Build backends from --url list (or every resolved address)
+            void setup_backends();
+
+            // Pick a backend and point request at it, returns the backend index
+            std::size_t route(http::Request& request, std::string_view path);
+
+            // Worker thread body, loops until limits reached
+            void worker_loop(std::uint32_t worker);
+
+            // WebSocket mode: one upgraded connection per worker, messages count as requests
+            void websocket_loop(std::uint32_t worker);
+
+            // Replay mode: dispatcher (calling thread) and workers
+            void dispatch_replay(LogReader& reader);
+            void replay_worker_loop(std::uint32_t worker);
+            const http::BodyFile* replay_body(const std::string& filepath);
+            std::chrono::steady_clock::time_point replay_due(std::chrono::microseconds offset) const;
+
             // Called by worker threads
-            void execute_request();
+            void execute_request(http::Client& client, const http::Request& request, Phase phase, std::size_t backend,
+                                 const WorkerContext& context);
+
+            // Copy a request that may be an exemplar, off the common path
+            void capture_exemplar(const http::Client& client, const http::Request& request, const http::Result& result,
+                                  const WorkerContext& context);
 
             // Check if test should continue, false when limits reached
-            bool should_continue() const;
+            // Sets the phase the next request belongs to
+            bool should_continue(Phase& phase);
+
+            // Request finished after the run ended (deadline or stop)
+            bool past_deadline() const;
+
+            // Warmup handling
+            bool has_warmup() const;
+            Phase current_phase();
+            void end_warmup(std::chrono::steady_clock::time_point now);
+            void monitor_warmup(std::stop_token stop_token);
 
             void wait_for_completion();
 
             cli::Config config_;
 
+            // Backends and client side balancing (balancer only with several backends)
+            std::vector<Backend> backends_;
+            std::unique_ptr<Balancer> balancer_;
+            std::string host_header_;   // Set when backends are resolved addresses of one host
+
+            // Applied to every worker's client
+            std::unique_ptr<http::SourceAddressPool> source_pool_;
+            http::SocketOptions socket_options_;
+            http::ReceiveOptions receive_options_;
+
+            // --body-file, opened once and sent by every worker
+            std::unique_ptr<http::BodyFile> body_file_;
+
+            // URL path, extra headers and body, rendered per request
+            RequestTemplates templates_;
+
             // unique pointer because threadpool is non copy
+            // workers_ is the pool in use, pool_ or a shared one
             std::unique_ptr<core::ThreadPool> pool_;
+            core::ThreadPool* workers_ = nullptr;
+            core::ThreadPool* shared_pool_ = nullptr;
 
-            // Stats collector
+            // Stats collector (measured window) and warmup collector
             stats::Collector collector_;
+            stats::Collector warmup_collector_;
+
+            // One path tracker per worker (--top-paths), merged into the results
+            // Space-Saving keeps this many entries per reported path
+            static constexpr std::size_t PATH_SLOTS_PER_RESULT = 4;
+            static constexpr std::uint64_t MIN_PATH_SAMPLES = 20;     // Fewest requests to rank a path by p99
+            std::vector<std::unique_ptr<stats::PathStats>> path_stats_;
+
+            // Slowest and sampled requests (--trace-out), null when off
+            std::unique_ptr<stats::ExemplarStore> exemplars_;
 
             // State management
             std::atomic<bool> running_{false};
             std::atomic<bool> stop_requested_{false};
+            std::atomic<bool> interrupted_{false};
+
+            // Wakes threads sleeping until a scheduled time (replay dispatcher) on stop()
+            std::mutex stop_mutex_;
+            std::condition_variable stop_condition_;
 
             // Timing
+            // Deadline is time_point::max() until known, warmup can move it
             std::chrono::steady_clock::time_point start_time_;
-            std::optional<std::chrono::steady_clock::time_point> deadline_;
+            std::atomic<std::chrono::steady_clock::time_point> measure_start_{};
+            std::atomic<std::chrono::steady_clock::time_point> deadline_{std::chrono::steady_clock::time_point::max()};
+
+            // Warmup state
+            static constexpr std::size_t STEADY_STATE_WINDOWS = 5;
+            static constexpr std::chrono::seconds STEADY_STATE_WINDOW{1};
+            std::atomic<bool> warming_up_{false};
+            std::atomic<std::uint32_t> warmup_started_{0};
+            std::atomic<bool> steady_state_detected_{false};
+            std::jthread warmup_monitor_;
 
             // Request tracking 
+            std::atomic<std::uint32_t> requests_started_{0};
             std::atomic<std::uint32_t> requests_completed_{0};
+            std::atomic<std::uint64_t> requests_cut_off_{0};
+
+            // WebSocket: sent messages awaiting their reply per connection, and how long
+            // a finished budget waits for the last replies
+            static constexpr std::size_t WEBSOCKET_WINDOW = 4096;
+            static constexpr std::size_t WEBSOCKET_BATCH = 64;
+            static constexpr std::chrono::seconds WEBSOCKET_DRAIN{5};
+
+            // Default body read size in download mode
+            static constexpr std::uint32_t DOWNLOAD_BUFFER = 256 * 1024;
+
+            // Replay state
+            static constexpr size_t REPLAY_QUEUE_PER_WORKER = 4;
+            static constexpr std::chrono::milliseconds REPLAY_LATE_THRESHOLD{10};
+            std::unique_ptr<ReplayQueue> replay_queue_;
+            std::uint64_t replay_dispatched_ = 0;
+            std::atomic<std::uint64_t> replay_late_{0};
+            std::atomic<std::int64_t> replay_max_lag_us_{0};
+
+            // Replay body-refs, each file opened once on first use (nullptr if it could not be)
+            std::mutex replay_bodies_mutex_;
+            std::unordered_map<std::string, std::unique_ptr<http::BodyFile>> replay_bodies_;
     };
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "core/feeder.hpp"
+
+#include <fcntl.h>          // open()
+#include <sys/mman.h>       // mmap()
+#include <sys/stat.h>       // fstat()
+#include <unistd.h>         // close()
+#include <utility>
+
+namespace surge::core {
+    namespace {
+        // Next line without its terminator, advances pos past it
+        std::string_view next_line(std::string_view data, std::size_t& pos) {
+            std::size_t end = data.find('\n', pos);
+            if (end == std::string_view::npos) {
+                end = data.size();
+            }
+            std::string_view line = data.substr(pos, end - pos);
+            pos = end + 1;
+            if (line.ends_with('\r')) {
+                line.remove_suffix(1);
+            }
+            return line;
+        }
+    }
+
+    Feeder::Feeder(std::string name, const std::string& filepath)
+        : name_(std::move(name))
+    {
+        int fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void* mapping = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data_ = static_cast<const char*>(mapping);
+                size_ = static_cast<std::size_t>(info.st_size);
+            }
+        }
+        close(fd);  // The mapping stays valid
+
+        if (data_ != nullptr) {
+            index(std::string_view(filepath).ends_with(".csv"));
+        }
+    }
+
+    Feeder::~Feeder() {
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    std::optional<std::size_t> Feeder::column(std::string_view name) const {
+        for (std::size_t i = 0; i < column_names_.size(); ++i) {
+            if (column_names_[i] == name) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void Feeder::index(bool csv) {
+        std::string_view data(data_, size_);
+        std::size_t pos = 0;
+
+        if (csv) {
+            std::string_view header = next_line(data, pos);
+            std::size_t start = 0;
+            while (true) {
+                std::size_t comma = header.find(',', start);
+                column_names_.emplace_back(header.substr(start, comma - start));
+                if (comma == std::string_view::npos) {
+                    break;
+                }
+                start = comma + 1;
+            }
+        } else {
+            column_names_.emplace_back();
+        }
+        columns_ = column_names_.size();
+
+        while (pos < data.size()) {
+            std::string_view line = next_line(data, pos);
+            if (line.empty()) {
+                continue;
+            }
+
+            // Short rows are padded with empty cells, extra cells are dropped
+            std::size_t first = cells_.size();
+            cells_.resize(first + columns_);
+            if (!csv) {
+                cells_[first] = line;
+            } else {
+                std::size_t start = 0;
+                for (std::size_t column = 0; column < columns_ && start <= line.size(); ++column) {
+                    std::size_t comma = line.find(',', start);
+                    cells_[first + column] = line.substr(start, comma - start);
+                    start = comma == std::string_view::npos ? line.size() + 1 : comma + 1;
+                }
+            }
+            rows_++;
+        }
+    }
+}
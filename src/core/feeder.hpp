@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace surge::core {
+    // Data file that request templates pull values from (user IDs, SKUs, ...)
+    // The file is mmapped once and shared by every worker, only a cell index is built
+    // "*.csv": header row names the columns (no quoted fields), anything else: one value per line
+    class Feeder {
+        public:
+            Feeder(std::string name, const std::string& filepath);
+            ~Feeder();
+
+            // Disable copy
+            Feeder(const Feeder&) = delete;
+            Feeder& operator=(const Feeder&) = delete;
+
+            // Mapped and has at least one row
+            bool is_open() const { return rows_ > 0; }
+
+            const std::string& name() const { return name_; }
+            std::size_t rows() const { return rows_; }
+
+            // Column by header name, line files have a single unnamed column
+            std::optional<std::size_t> column(std::string_view name) const;
+
+            std::string_view value(std::size_t row, std::size_t column) const {
+                return cells_[row * columns_ + column];
+            }
+
+            // Rows are handed out in file order, wrapping around, shared across workers
+            std::size_t next_row() {
+                return next_.fetch_add(1, std::memory_order_relaxed) % rows_;
+            }
+
+        private:
+            void index(bool csv);
+
+            std::string name_;
+            const char* data_ = nullptr;
+            std::size_t size_ = 0;
+
+            std::vector<std::string> column_names_;
+            std::size_t columns_ = 1;
+            std::size_t rows_ = 0;
+            std::vector<std::string_view> cells_;   // rows_ x columns_, views into the mapping
+
+            std::atomic<std::size_t> next_{0};
+    };
+}
@@ -0,0 +1,638 @@
+#include "core/hold.hpp"
+#include "http/clock.hpp"
+#include "http/result.hpp"
+#include "http/url.hpp"
+
+#include <sys/epoll.h>      // epoll_create1(), epoll_ctl(), epoll_wait()
+#include <sys/resource.h>   // getrlimit(), setrlimit()
+#include <sys/socket.h>     // connect(), send(), recv()
+#include <arpa/inet.h>      // htons()
+#include <netdb.h>          // getaddrinfo()
+#include <unistd.h>         // close(), sysconf()
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace surge::core {
+    namespace {
+        // Connects in progress per loop, keeps the SYN backlog sane while ramping
+        constexpr std::uint32_t MAX_CONNECTING = 512;
+
+        // A refused or failed connection is retried after this long
+        constexpr std::chrono::seconds RECONNECT_DELAY{1};
+
+        constexpr std::size_t READ_BUFFER_SIZE = 64 * 1024;
+        constexpr int MAX_EVENTS = 256;
+
+        // Longest epoll wait, so stop() and the ramp are noticed promptly
+        constexpr int MAX_WAIT_MS = 50;
+
+        constexpr std::string_view CONTENT_LENGTH = "content-length";
+
+        // Response parsing, one byte at a time so no header bytes are kept per connection
+        enum class Parse : std::uint8_t { Status, StatusRest, LineStart, Name, Value, SkipLine, Body, UntilClose };
+
+        enum Flags : std::uint8_t {
+            CONNECTING = 1 << 0,
+            HAS_LENGTH = 1 << 1,
+            LATE = 1 << 2,          // Interval passed while waiting for a reply, send on arrival
+        };
+
+        // epoll user data: descriptor and connection index, so stale events can be told apart
+        std::uint64_t event_data(int fd, std::uint32_t index) {
+            return (static_cast<std::uint64_t>(fd) << 32) | index;
+        }
+
+        // Resident set size from /proc/self/statm, 0 if unavailable
+        std::uint64_t resident_bytes() {
+            std::ifstream statm("/proc/self/statm");
+            std::uint64_t size = 0;
+            std::uint64_t resident = 0;
+            if (!(statm >> size >> resident)) {
+                return 0;
+            }
+            return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+        }
+    }
+
+    // Everything the generator keeps for one held connection
+    struct Connection {
+        std::uint64_t sent_at = 0;          // Ticks when the request in flight (or connect) started, 0 = idle
+        std::uint64_t due = 0;              // Ticks of the queued send / reconnect, matches its queue entry
+        std::uint64_t body_remaining = 0;
+        std::uint32_t received = 0;         // Bytes of the current response
+        int fd = -1;
+        std::uint16_t status = 0;
+        Parse parse = Parse::Status;
+        std::uint8_t matched = 0;           // Characters of "content-length" matched on this header line
+        std::uint8_t flags = 0;
+    };
+
+    // Queued send or reconnect, stale when the connection's due no longer matches
+    struct Timer {
+        std::uint64_t due;
+        std::uint32_t index;
+    };
+
+    struct HoldTest::Loop {
+        int epoll_fd = -1;
+        std::uint64_t target = 0;           // Connections this loop holds
+        double ramp_per_second = 0.0;       // New connections per second, 0 = as fast as possible
+        std::uint32_t next_unopened = 0;    // Connections below this have been opened at least once
+        std::uint32_t connecting = 0;
+        std::vector<Connection> connections;
+
+        // Due times only grow within each queue (now + a fixed delay), so the FIFOs stay ordered
+        std::deque<Timer> sends;
+        std::deque<Timer> reconnects;
+
+        std::vector<char> buffer;
+        std::jthread thread;
+
+        ~Loop() {
+            for (Connection& connection : connections) {
+                if (connection.fd >= 0) {
+                    close(connection.fd);
+                }
+            }
+            if (epoll_fd >= 0) {
+                close(epoll_fd);
+            }
+        }
+    };
+
+    HoldTest::HoldTest(const cli::Config& config)
+        : config_(config)
+    {
+        socket_options_.tcp_nodelay = config_.tcp_nodelay;
+        socket_options_.send_buffer = static_cast<int>(config_.send_buffer);
+        socket_options_.receive_buffer = static_cast<int>(config_.receive_buffer);
+        socket_options_.quickack = config_.tcp_quickack;
+        socket_options_.linger_reset = config_.linger_reset;
+
+        if (!config_.source_addresses.empty()) {
+            if (auto addresses = http::SourceAddressPool::parse(config_.source_addresses)) {
+                source_pool_ = std::make_unique<http::SourceAddressPool>(std::move(*addresses));
+                socket_options_.source_addresses = source_pool_.get();
+            }
+        }
+    }
+
+    HoldTest::~HoldTest() {
+        running_ = false;
+    }
+
+    std::size_t HoldTest::state_bytes() {
+        return sizeof(Connection) + sizeof(Timer);
+    }
+
+    bool HoldTest::prepare() {
+        if (http::is_unix_url(config_.url) || config_.url.starts_with("https://")) {
+            std::cerr << "Error: --hold needs a plain http:// target\n";
+            return false;
+        }
+
+        std::string_view base = http::url_base(config_.url);
+        size_t host_start = base.find("://");
+        std::string_view host_port = host_start == std::string_view::npos ? base : base.substr(host_start + 3);
+        std::string_view host = host_port;
+        std::uint16_t port = 80;
+        if (size_t colon = host_port.rfind(':'); colon != std::string_view::npos) {
+            host = host_port.substr(0, colon);
+            std::string_view digits = host_port.substr(colon + 1);
+            auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), port);
+            if (ec != std::errc{} || end != digits.data() + digits.size()) {
+                std::cerr << "Error: invalid port in " << config_.url << "\n";
+                return false;
+            }
+        }
+
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* resolved = nullptr;
+        std::string host_name(host);
+        if (getaddrinfo(host_name.c_str(), nullptr, &hints, &resolved) != 0 || resolved == nullptr) {
+            std::cerr << "Error: could not resolve " << host_name << "\n";
+            return false;
+        }
+        address_ = *reinterpret_cast<const sockaddr_in*>(resolved->ai_addr);
+        address_.sin_port = htons(port);
+        freeaddrinfo(resolved);
+
+        // Built once, every trickle request is the same bytes
+        request_.assign(config_.method.value_or("GET")).append(" ").append(http::url_path(config_.url)).append(" HTTP/1.1\r\n");
+        request_.append("Host: ").append(host_port).append("\r\n");
+        for (const std::string& header : config_.headers) {
+            request_.append(header).append("\r\n");
+        }
+        request_.append("\r\n");
+
+        // One descriptor per connection
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+            if (limit.rlim_cur < config_.hold_connections + 64) {
+                std::cerr << "Warning: open file limit is " << limit.rlim_cur
+                          << ", raise it (ulimit -n) to hold " << config_.hold_connections << " connections\n";
+            }
+        }
+        return true;
+    }
+
+    void HoldTest::on_sample(std::function<void(const HoldSample&)> callback) {
+        sample_callback_ = std::move(callback);
+    }
+
+    void HoldTest::stop() {
+        {
+            std::lock_guard lock(stop_mutex_);
+            interrupted_ = true;
+            running_ = false;
+        }
+        stop_condition_.notify_all();
+    }
+
+    HoldResults HoldTest::run() {
+        std::uint32_t thread_count = config_.hold_threads > 0 ? config_.hold_threads
+                                   : std::max(1u, std::thread::hardware_concurrency());
+        thread_count = static_cast<std::uint32_t>(std::min<std::uint64_t>(thread_count, config_.hold_connections));
+
+        std::uint64_t rss_before = resident_bytes();
+        start_ = std::chrono::steady_clock::now();
+        {
+            // A stop() that came before run() (signal watcher already installed) ends it at once
+            std::lock_guard lock(stop_mutex_);
+            running_ = !interrupted_;
+        }
+
+        // Connections (and the ramp) split evenly across the loops
+        std::vector<std::unique_ptr<Loop>> loops;
+        for (std::uint32_t i = 0; i < thread_count; ++i) {
+            auto loop = std::make_unique<Loop>();
+            loop->target = config_.hold_connections / thread_count + (i < config_.hold_connections % thread_count ? 1 : 0);
+            loop->ramp_per_second = config_.hold_rate / thread_count;
+            loop->connections.resize(loop->target);
+            loop->buffer.resize(READ_BUFFER_SIZE);
+            loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            loops.push_back(std::move(loop));
+        }
+        for (auto& loop : loops) {
+            loop->thread = std::jthread([this, &loop = *loop]() {
+                run_loop(loop);
+            });
+        }
+
+        // Sample once per second until the deadline or stop()
+        auto deadline = config_.duration_seconds > 0
+            ? start_ + std::chrono::seconds(config_.duration_seconds)
+            : std::chrono::steady_clock::time_point::max();
+        stats::Metrics previous = collector_.get_metrics();
+        std::uint64_t peak = 0;
+        auto next_sample = start_;
+        while (running_) {
+            next_sample = std::min(next_sample + std::chrono::seconds(1), deadline);
+            {
+                std::unique_lock lock(stop_mutex_);
+                stop_condition_.wait_until(lock, next_sample, [this]() {
+                    return !running_.load();
+                });
+            }
+            auto now = std::chrono::steady_clock::now();
+
+            stats::Metrics current = collector_.get_metrics();
+            stats::Histogram interval = current.latency_histogram;
+            interval.subtract(previous.latency_histogram);
+
+            HoldSample sample{
+                .elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_),
+                .open_connections = open_connections_.load(),
+                .connects_per_second = static_cast<double>(current.connections_opened - previous.connections_opened),
+                .rss_bytes = resident_bytes(),
+                .requests = interval.count(),
+                .p50 = interval.value_at(0.50),
+                .p99 = interval.value_at(0.99),
+            };
+            peak = std::max(peak, sample.open_connections);
+            previous = std::move(current);
+            if (sample_callback_ && running_) {
+                sample_callback_(sample);
+            }
+            if (now >= deadline) {
+                running_ = false;
+            }
+        }
+
+        std::uint64_t rss_held = resident_bytes();
+        peak = std::max(peak, open_connections_.load());
+        for (auto& loop : loops) {
+            loop->thread.join();
+        }
+        auto end = std::min(std::chrono::steady_clock::now(), deadline);
+        loops.clear();
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start_);
+        collector_.set_duration(duration);
+        stats::Metrics metrics = collector_.get_metrics();
+        double seconds = duration.count() / 1'000'000.0;
+
+        HoldResults results;
+        Results& summary = results.results;
+        summary.metrics = metrics;
+        summary.percentiles = collector_.calculate_percentiles();
+        summary.duration = duration;
+        summary.requests_per_second = seconds > 0 ? metrics.total_requests / seconds : 0.0;
+        summary.cut_off_requests = cut_off_.load();
+        summary.interrupted = interrupted_.load();
+        summary.connects_per_second = seconds > 0 ? metrics.connections_opened / seconds : 0.0;
+        summary.time_wait_sockets = http::count_time_wait_sockets();
+        results.target = config_.hold_connections;
+        results.peak_connections = peak;
+        results.time_to_target = std::chrono::milliseconds(target_reached_ms_.load());
+        results.server_closed = server_closed_.load();
+        results.local_failures = local_failures_.load();
+        results.rss_growth_bytes = rss_held > rss_before ? rss_held - rss_before : 0;
+        results.state_bytes = state_bytes();
+        return results;
+    }
+
+    void HoldTest::run_loop(Loop& loop) {
+        const std::uint64_t ticks_per_ms = static_cast<std::uint64_t>(http::TscClock::ticks_per_second() / 1000.0);
+        const std::uint64_t interval_ticks = static_cast<std::uint64_t>(config_.hold_interval * http::TscClock::ticks_per_second());
+        const std::uint64_t reconnect_ticks = static_cast<std::uint64_t>(RECONNECT_DELAY.count() * http::TscClock::ticks_per_second());
+        const std::uint64_t loop_start = http::TscClock::now();
+
+        // Failed connects are retried after RECONNECT_DELAY
+        auto fail_connect = [&](std::uint32_t index, std::uint64_t now) {
+            http::Result result;
+            result.connect_attempted = true;
+            collector_.record_connection(result);
+            loop.connections[index].due = now + reconnect_ticks;
+            loop.reconnects.push_back(Timer{now + reconnect_ticks, index});
+        };
+
+        auto open_connection = [&](std::uint32_t index, std::uint64_t now) {
+            Connection& connection = loop.connections[index];
+            connection = Connection{};
+            int fd = http::create_socket(AF_INET, socket_options_, true);
+            if (fd < 0) {
+                fail_connect(index, now);
+                return;
+            }
+            if (connect(fd, reinterpret_cast<const sockaddr*>(&address_), sizeof(address_)) < 0 && errno != EINPROGRESS) {
+                close(fd);
+                fail_connect(index, now);
+                return;
+            }
+            epoll_event event{};
+            event.events = EPOLLOUT | EPOLLIN;
+            event.data.u64 = event_data(fd, index);
+            epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, fd, &event);
+            connection.fd = fd;
+            connection.sent_at = now;
+            connection.flags = CONNECTING;
+            loop.connecting++;
+        };
+
+        // Drop a connection and reopen it straight away, the caller counts why it was dropped
+        auto close_connection = [&](std::uint32_t index, std::uint64_t now, bool failed_request) {
+            Connection& connection = loop.connections[index];
+            if (connection.sent_at != 0 && failed_request) {
+                http::Result result;
+                result.latency = http::TscClock::elapsed(connection.sent_at, now);
+                result.bytes_sent = request_.size();
+                result.bytes_received = connection.received;
+                result.error = "Connection closed before the response completed";
+                collector_.record(result);
+            }
+            epoll_ctl(loop.epoll_fd, EPOLL_CTL_DEL, connection.fd, nullptr);
+            close(connection.fd);
+            connection.fd = -1;
+            open_connections_--;
+            open_connection(index, now);
+        };
+
+        auto send_request = [&](std::uint32_t index, std::uint64_t now) {
+            Connection& connection = loop.connections[index];
+            // A short request into an idle socket's empty send buffer goes out whole
+            ssize_t sent = ::send(connection.fd, request_.data(), request_.size(), MSG_NOSIGNAL);
+            if (sent != static_cast<ssize_t>(request_.size())) {
+                // A reset or broken pipe is the server's close surfacing here, anything else is ours
+                if (sent < 0 && (errno == EPIPE || errno == ECONNRESET)) {
+                    server_closed_++;
+                } else {
+                    local_failures_++;
+                }
+                collector_.request_started();
+                connection.sent_at = now;
+                close_connection(index, now, true);
+                return;
+            }
+            collector_.request_started();
+            connection.sent_at = now;
+            connection.received = 0;
+            connection.status = 0;
+            connection.body_remaining = 0;
+            connection.parse = Parse::Status;
+            connection.flags &= static_cast<std::uint8_t>(~(HAS_LENGTH | LATE));
+            connection.due = now + interval_ticks;
+            loop.sends.push_back(Timer{connection.due, index});
+        };
+
+        auto complete_response = [&](std::uint32_t index, std::uint64_t now) {
+            Connection& connection = loop.connections[index];
+            http::Result result;
+            result.status_code = connection.status;
+            result.success = connection.status != 0;
+            result.latency = http::TscClock::elapsed(connection.sent_at, now);
+            result.bytes_sent = request_.size();
+            result.bytes_received = connection.received;
+            if (!result.success) {
+                result.error = "Invalid HTTP response";
+            }
+            collector_.record(result);
+            connection.sent_at = 0;
+            if (connection.flags & LATE) {
+                send_request(index, now);
+            }
+        };
+
+        // Feed response bytes, true once the response is complete
+        auto parse = [](Connection& connection, const char* data, std::size_t length) {
+            for (std::size_t i = 0; i < length; ++i) {
+                char c = data[i];
+                switch (connection.parse) {
+                    case Parse::Status:
+                        // "HTTP/1.1 200 OK": the code follows the first space
+                        if (c == ' ') {
+                            connection.parse = Parse::StatusRest;
+                        }
+                        break;
+                    case Parse::StatusRest:
+                        if (c >= '0' && c <= '9' && connection.status < 100) {
+                            connection.status = static_cast<std::uint16_t>(connection.status * 10 + (c - '0'));
+                        } else if (c == '\n') {
+                            connection.parse = Parse::LineStart;
+                        }
+                        break;
+                    case Parse::LineStart:
+                        if (c == '\r') {
+                            break;
+                        }
+                        if (c == '\n') {
+                            // End of head
+                            bool no_body = connection.status < 200 || connection.status == 204 || connection.status == 304;
+                            if (no_body || ((connection.flags & HAS_LENGTH) && connection.body_remaining == 0)) {
+                                return true;
+                            }
+                            connection.parse = (connection.flags & HAS_LENGTH) ? Parse::Body : Parse::UntilClose;
+                            break;
+                        }
+                        connection.matched = 0;
+                        connection.parse = Parse::Name;
+                        [[fallthrough]];
+                    case Parse::Name:
+                        if (c == ':') {
+                            connection.parse = connection.matched == CONTENT_LENGTH.size() ? Parse::Value : Parse::SkipLine;
+                            if (connection.parse == Parse::Value) {
+                                connection.flags |= HAS_LENGTH;
+                                connection.body_remaining = 0;
+                            }
+                        } else if (connection.matched < CONTENT_LENGTH.size() &&
+                                   std::tolower(static_cast<unsigned char>(c)) == CONTENT_LENGTH[connection.matched]) {
+                            connection.matched++;
+                        } else {
+                            connection.parse = Parse::SkipLine;
+                        }
+                        break;
+                    case Parse::Value:
+                        if (c >= '0' && c <= '9') {
+                            connection.body_remaining = connection.body_remaining * 10 + static_cast<std::uint64_t>(c - '0');
+                        } else if (c == '\n') {
+                            connection.parse = Parse::LineStart;
+                        }
+                        break;
+                    case Parse::SkipLine:
+                        if (c == '\n') {
+                            connection.parse = Parse::LineStart;
+                        }
+                        break;
+                    case Parse::Body: {
+                        std::uint64_t take = std::min<std::uint64_t>(connection.body_remaining, length - i);
+                        connection.body_remaining -= take;
+                        i += take - 1;
+                        if (connection.body_remaining == 0) {
+                            return true;
+                        }
+                        break;
+                    }
+                    case Parse::UntilClose:
+                        return false;
+                }
+            }
+            return false;
+        };
+
+        epoll_event events[MAX_EVENTS];
+        while (running_) {
+            std::uint64_t now = http::TscClock::now();
+
+            // Open new connections at the ramp rate
+            std::uint64_t allowed = loop.target;
+            if (loop.ramp_per_second > 0) {
+                double seconds = static_cast<double>(now - loop_start) / http::TscClock::ticks_per_second();
+                allowed = std::min<std::uint64_t>(loop.target, static_cast<std::uint64_t>(loop.ramp_per_second * seconds) + 1);
+            }
+            while (loop.next_unopened < allowed && loop.connecting < MAX_CONNECTING) {
+                open_connection(loop.next_unopened++, now);
+            }
+
+            // Retry failed connects
+            while (!loop.reconnects.empty() && loop.reconnects.front().due <= now && loop.connecting < MAX_CONNECTING) {
+                Timer timer = loop.reconnects.front();
+                loop.reconnects.pop_front();
+                Connection& connection = loop.connections[timer.index];
+                if (connection.due == timer.due && connection.fd < 0) {
+                    open_connection(timer.index, now);
+                }
+            }
+
+            // Trickle requests that are due
+            while (!loop.sends.empty() && loop.sends.front().due <= now) {
+                Timer timer = loop.sends.front();
+                loop.sends.pop_front();
+                Connection& connection = loop.connections[timer.index];
+                if (connection.due != timer.due || connection.fd < 0 || (connection.flags & CONNECTING)) {
+                    continue;
+                }
+                if (connection.sent_at == 0) {
+                    send_request(timer.index, now);
+                } else {
+                    connection.flags |= LATE;
+                }
+            }
+
+            // Sleep until the next timer, briefly while still ramping
+            std::uint64_t next_due = UINT64_MAX;
+            if (!loop.sends.empty()) {
+                next_due = loop.sends.front().due;
+            }
+            if (!loop.reconnects.empty()) {
+                next_due = std::min(next_due, loop.reconnects.front().due);
+            }
+            int timeout = MAX_WAIT_MS;
+            if (loop.next_unopened < loop.target) {
+                timeout = loop.connecting < MAX_CONNECTING ? 1 : timeout;
+            }
+            if (next_due != UINT64_MAX) {
+                std::uint64_t wait = next_due > now ? (next_due - now) / std::max<std::uint64_t>(ticks_per_ms, 1) + 1 : 0;
+                timeout = std::min<int>(timeout, static_cast<int>(std::min<std::uint64_t>(wait, MAX_WAIT_MS)));
+            }
+
+            int ready = epoll_wait(loop.epoll_fd, events, MAX_EVENTS, timeout);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+
+            now = http::TscClock::now();
+            for (int e = 0; e < ready; ++e) {
+                auto index = static_cast<std::uint32_t>(events[e].data.u64);
+                Connection& connection = loop.connections[index];
+                // Stale event for a connection closed (and maybe reopened) earlier in this batch
+                if (connection.fd < 0 || connection.fd != static_cast<int>(events[e].data.u64 >> 32)) {
+                    continue;
+                }
+
+                if (connection.flags & CONNECTING) {
+                    int error = 0;
+                    socklen_t length = sizeof(error);
+                    getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                    loop.connecting--;
+                    if (error != 0 || (events[e].events & (EPOLLERR | EPOLLHUP))) {
+                        epoll_ctl(loop.epoll_fd, EPOLL_CTL_DEL, connection.fd, nullptr);
+                        close(connection.fd);
+                        connection.fd = -1;
+                        fail_connect(index, now);
+                        continue;
+                    }
+
+                    http::Result result;
+                    result.connect_attempted = true;
+                    result.connected = true;
+                    result.connect_time = http::TscClock::elapsed(connection.sent_at, now);
+                    collector_.record_connection(result);
+                    http::apply_connected_options(connection.fd, AF_INET, socket_options_);
+
+                    epoll_event event{};
+                    event.events = EPOLLIN | EPOLLRDHUP;
+                    event.data.u64 = event_data(connection.fd, index);
+                    epoll_ctl(loop.epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+                    connection.flags = 0;
+                    connection.sent_at = 0;
+
+                    std::uint64_t open = open_connections_.fetch_add(1) + 1;
+                    if (open == config_.hold_connections) {
+                        std::int64_t unset = -1;
+                        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_);
+                        target_reached_ms_.compare_exchange_strong(unset, elapsed.count());
+                    }
+                    if (interval_ticks > 0) {
+                        send_request(index, now);
+                    }
+                    continue;
+                }
+
+                // Read everything available, bytes outside a request are ignored
+                bool closed = false;
+                while (true) {
+                    ssize_t received = recv(connection.fd, loop.buffer.data(), loop.buffer.size(), 0);
+                    if (received > 0) {
+                        if (connection.sent_at != 0) {
+                            connection.received += static_cast<std::uint32_t>(received);
+                            if (parse(connection, loop.buffer.data(), static_cast<std::size_t>(received))) {
+                                complete_response(index, now);
+                            }
+                        }
+                        continue;
+                    }
+                    if (received < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    closed = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+                    break;
+                }
+
+                if (closed) {
+                    // A response without a length ends with the connection
+                    bool until_close = connection.sent_at != 0 && connection.parse == Parse::UntilClose;
+                    if (until_close) {
+                        connection.flags &= static_cast<std::uint8_t>(~LATE);
+                        complete_response(index, now);
+                    }
+                    server_closed_++;
+                    close_connection(index, now, !until_close);
+                }
+            }
+        }
+
+        // Requests still waiting at the end are cut off, like the closed loop's
+        for (Connection& connection : loop.connections) {
+            if (connection.fd >= 0 && connection.sent_at != 0 && !(connection.flags & CONNECTING)) {
+                collector_.request_abandoned();
+                cut_off_++;
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+#include "cli/config.hpp"
+#include "core/engine.hpp"
+#include "http/socket.hpp"
+#include "stats/collector.hpp"
+
+namespace surge::core {
+    // One progress sample, taken every second while connections are held
+    struct HoldSample {
+        std::chrono::milliseconds elapsed{0};
+        std::uint64_t open_connections = 0;
+        double connects_per_second = 0.0;       // Over the last second
+        std::uint64_t rss_bytes = 0;            // Resident memory of the process
+        std::uint64_t requests = 0;             // Trickle requests completed in the last second
+        std::uint64_t p50 = 0;                  // Their latency (μs)
+        std::uint64_t p99 = 0;
+    };
+
+    struct HoldResults {
+        Results results;                        // Trickle requests and connection counts
+        std::uint64_t target = 0;
+        std::uint64_t peak_connections = 0;
+        std::chrono::milliseconds time_to_target{-1};  // Negative if the target was never reached
+        std::uint64_t server_closed = 0;        // Held connections the server closed (reopened)
+        std::uint64_t local_failures = 0;       // Held connections dropped on a local send error (reopened)
+        std::uint64_t rss_growth_bytes = 0;     // Resident memory gained while holding
+        std::size_t state_bytes = 0;            // Generator state per connection
+    };
+
+    // Connection capacity test (--hold <n>): opens n keep-alive connections across the source
+    // addresses and holds them, each sending one request per --hold-interval
+    // A few event loop threads (epoll) drive every connection, a held connection is a
+    // small state struct plus one index in a timer queue, so the generator side costs
+    // tens of bytes per connection instead of a thread and a Client
+    class HoldTest {
+        public:
+            explicit HoldTest(const cli::Config& config);
+            ~HoldTest();
+
+            // Disable copy
+            HoldTest(const HoldTest&) = delete;
+            HoldTest& operator=(const HoldTest&) = delete;
+
+            // Resolve the target and raise the open file limit, false (error printed) on failure
+            bool prepare();
+
+            // Called from run() once per second
+            void on_sample(std::function<void(const HoldSample&)> callback);
+
+            // Hold until --duration ends or stop(), blocking
+            HoldResults run();
+
+            // End the run, safe to call from any thread (signal watcher)
+            void stop();
+
+            // Generator state per held connection, for the report
+            static std::size_t state_bytes();
+
+        private:
+            struct Loop;
+
+            void run_loop(Loop& loop);
+
+            cli::Config config_;
+            std::unique_ptr<http::SourceAddressPool> source_pool_;
+            http::SocketOptions socket_options_;
+            sockaddr_in address_{};
+            std::string request_;           // Sent as is on every connection
+
+            std::function<void(const HoldSample&)> sample_callback_;
+            stats::Collector collector_;
+
+            std::atomic<bool> running_{false};
+            std::atomic<bool> interrupted_{false};
+            std::atomic<std::uint64_t> open_connections_{0};
+            std::atomic<std::uint64_t> server_closed_{0};
+            std::atomic<std::uint64_t> local_failures_{0};
+            std::atomic<std::uint64_t> cut_off_{0};
+            std::atomic<std::int64_t> target_reached_ms_{-1};
+            std::chrono::steady_clock::time_point start_;
+
+            // Wakes the sampling loop on stop()
+            std::mutex stop_mutex_;
+            std::condition_variable stop_condition_;
+    };
+}
@@ -0,0 +1,226 @@
+#include "core/replay.hpp"
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace surge::core {
+    namespace {
+        // Days since 1970-01-01 for a civil date (proleptic Gregorian)
+        std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day) {
+            year -= month <= 2;
+            const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+            const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+            const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+            const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+            return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+        }
+
+        template <typename T>
+        bool parse_int(std::string_view text, T& out) {
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+            return ec == std::errc{} && end == text.data() + text.size();
+        }
+
+        // "10/Oct/2000:13:55:36 -0700" to μs since epoch (UTC)
+        bool parse_clf_time(std::string_view text, std::int64_t& timestamp_us) {
+            static constexpr std::string_view MONTHS[] = {
+                "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+            };
+
+            if (text.size() < 26 || text[2] != '/' || text[6] != '/' || text[11] != ':' || text[20] != ' ') {
+                return false;
+            }
+
+            unsigned day = 0;
+            unsigned month = 0;
+            std::int64_t year = 0;
+            int hour = 0, minute = 0, second = 0, zone = 0;
+
+            for (unsigned i = 0; i < 12; ++i) {
+                if (text.substr(3, 3) == MONTHS[i]) {
+                    month = i + 1;
+                }
+            }
+
+            if (month == 0 ||
+                !parse_int(text.substr(0, 2), day) || !parse_int(text.substr(7, 4), year) ||
+                !parse_int(text.substr(12, 2), hour) || !parse_int(text.substr(15, 2), minute) ||
+                !parse_int(text.substr(18, 2), second) || !parse_int(text.substr(22, 4), zone)) {
+                return false;
+            }
+
+            // Zone is +hhmm / -hhmm
+            std::int64_t zone_seconds = (zone / 100) * 3600 + (zone % 100) * 60;
+            if (text[21] == '-') {
+                zone_seconds = -zone_seconds;
+            }
+
+            std::int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - zone_seconds;
+            timestamp_us = seconds * 1'000'000;
+            return true;
+        }
+    }
+
+    LogReader::LogReader(const std::string& filepath)
+        : file_(filepath)
+    {
+        line_.reserve(1024);
+    }
+
+    bool LogReader::is_open() const {
+        return file_.is_open();
+    }
+
+    bool LogReader::next(ReplayEntry& entry) {
+        while (std::getline(file_, line_)) {
+            std::string_view line(line_);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+            if (parse_line(line, entry)) {
+                return true;
+            }
+            skipped_++;
+        }
+        return false;
+    }
+
+    bool LogReader::parse_line(std::string_view line, ReplayEntry& entry) {
+        std::int64_t timestamp_us = 0;
+
+        bool parsed = line.find('\t') != std::string_view::npos
+            ? parse_tsv(line, timestamp_us, entry)
+            : parse_clf(line, timestamp_us, entry);
+        if (!parsed) {
+            return false;
+        }
+
+        // Offsets are relative to the first entry, out of order lines are sent immediately
+        if (!first_timestamp_us_) {
+            first_timestamp_us_ = timestamp_us;
+        }
+        entry.offset = std::chrono::microseconds(std::max<std::int64_t>(0, timestamp_us - *first_timestamp_us_));
+        return true;
+    }
+
+    // "1697040000.125\tGET\t/users/42\tbodies/u42.json"
+    bool LogReader::parse_tsv(std::string_view line, std::int64_t& timestamp_us, ReplayEntry& entry) {
+        std::string_view fields[4];
+        size_t count = 0;
+        while (count < 4) {
+            size_t tab = line.find('\t');
+            fields[count++] = line.substr(0, tab);
+            if (tab == std::string_view::npos) {
+                break;
+            }
+            line.remove_prefix(tab + 1);
+        }
+
+        if (count < 3 || fields[1].empty() || fields[2].empty() || fields[2].front() != '/') {
+            return false;
+        }
+
+        double seconds = 0.0;
+        auto [end, ec] = std::from_chars(fields[0].data(), fields[0].data() + fields[0].size(), seconds);
+        if (ec != std::errc{} || end != fields[0].data() + fields[0].size()) {
+            return false;
+        }
+
+        timestamp_us = static_cast<std::int64_t>(seconds * 1'000'000.0);
+        entry.method.assign(fields[1]);
+        entry.path.assign(fields[2]);
+        entry.body_file.assign(count == 4 ? fields[3] : std::string_view{});
+        return true;
+    }
+
+    // 127.0.0.1 - frank [10/Oct/2000:13:55:36 -0700] "GET /apache_pb.gif HTTP/1.0" 200 2326 ...
+    bool LogReader::parse_clf(std::string_view line, std::int64_t& timestamp_us, ReplayEntry& entry) {
+        size_t time_start = line.find('[');
+        size_t time_end = line.find(']', time_start);
+        if (time_start == std::string_view::npos || time_end == std::string_view::npos) {
+            return false;
+        }
+        if (!parse_clf_time(line.substr(time_start + 1, time_end - time_start - 1), timestamp_us)) {
+            return false;
+        }
+
+        // Request line between the next pair of quotes
+        size_t request_start = line.find('"', time_end);
+        size_t request_end = line.find('"', request_start + 1);
+        if (request_start == std::string_view::npos || request_end == std::string_view::npos) {
+            return false;
+        }
+        std::string_view request = line.substr(request_start + 1, request_end - request_start - 1);
+
+        size_t method_end = request.find(' ');
+        if (method_end == std::string_view::npos) {
+            return false;
+        }
+        std::string_view target = request.substr(method_end + 1);
+        target = target.substr(0, target.find(' '));
+        if (target.empty() || target.front() != '/') {
+            return false;
+        }
+
+        entry.method.assign(request.substr(0, method_end));
+        entry.path.assign(target);
+        entry.body_file.clear();
+        return true;
+    }
+
+    ReplayQueue::ReplayQueue(size_t capacity)
+        : slots_(capacity)
+    {}
+
+    bool ReplayQueue::push(ReplayEntry& entry) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() {
+            return size_ < slots_.size() || closed_;
+        });
+        if (closed_) {
+            return false;
+        }
+
+        // Swap so the caller gets back a recycled entry with spare capacity
+        std::swap(slots_[(head_ + size_) % slots_.size()], entry);
+        size_++;
+        lock.unlock();
+
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool ReplayQueue::pop(ReplayEntry& entry) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() {
+            return size_ > 0 || closed_;
+        });
+        if (size_ == 0) {
+            return false;
+        }
+
+        std::swap(slots_[head_], entry);
+        head_ = (head_ + 1) % slots_.size();
+        size_--;
+        lock.unlock();
+
+        not_full_.notify_one();
+        return true;
+    }
+
+    void ReplayQueue::close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace surge::core {
+    // One request read from an access log
+    struct ReplayEntry {
+        std::chrono::microseconds offset{0};    // Relative to the first entry in the log
+        std::string method;
+        std::string path;
+        std::string body_file;                  // Optional body-ref (file holding the body)
+    };
+
+    // Streams entries from an access log, one line at a time
+    // Memory use does not depend on the size of the log
+    // Accepts Common/Combined Log Format or TSV: timestamp, method, path[, body-ref]
+    class LogReader {
+        public:
+            explicit LogReader(const std::string& filepath);
+
+            bool is_open() const;
+
+            // Read the next entry into entry (reusing its capacity), false at end of file
+            bool next(ReplayEntry& entry);
+
+            // Lines that could not be parsed
+            std::uint64_t skipped() const { return skipped_; }
+
+        private:
+            bool parse_line(std::string_view line, ReplayEntry& entry);
+
+            static bool parse_tsv(std::string_view line, std::int64_t& timestamp_us, ReplayEntry& entry);
+            static bool parse_clf(std::string_view line, std::int64_t& timestamp_us, ReplayEntry& entry);
+
+            std::ifstream file_;
+            std::string line_;
+            std::optional<std::int64_t> first_timestamp_us_;
+            std::uint64_t skipped_ = 0;
+    };
+
+    // Fixed capacity queue between the dispatcher and workers
+    // Entries are swapped in and out of preallocated slots so string buffers are recycled
+    class ReplayQueue {
+        public:
+            explicit ReplayQueue(size_t capacity);
+
+            // Blocks while full, false if closed
+            bool push(ReplayEntry& entry);
+
+            // Blocks while empty, false once closed and drained
+            bool pop(ReplayEntry& entry);
+
+            // No more entries (or no more takers), wakes all waiters
+            void close();
+
+        private:
+            std::vector<ReplayEntry> slots_;
+            size_t head_ = 0;
+            size_t size_ = 0;
+            bool closed_ = false;
+
+            std::mutex mutex_;
+            std::condition_variable not_empty_;
+            std::condition_variable not_full_;
+    };
+}
@@ -0,0 +1,110 @@
+#include "core/sweep.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace surge::core {
+    Sweep::Sweep(const cli::Config& config)
+        : config_(config)
+    {
+        // An empty list sweeps the single configured value
+        std::vector<std::uint32_t> concurrency = config_.sweep_concurrency;
+        if (concurrency.empty()) {
+            concurrency.push_back(config_.concurrency);
+        }
+        std::vector<std::uint32_t> bodies = config_.sweep_body_sizes;
+        if (bodies.empty()) {
+            bodies.push_back(static_cast<std::uint32_t>(config_.body.size()));
+        }
+
+        for (std::uint32_t body : bodies) {
+            for (std::uint32_t workers : concurrency) {
+                cells_.emplace_back(workers, body);
+            }
+        }
+    }
+
+    void Sweep::on_cell(std::function<void(const SweepCell&, std::size_t)> callback) {
+        cell_callback_ = std::move(callback);
+    }
+
+    cli::Config Sweep::cell_config(std::uint32_t concurrency, std::uint32_t body_bytes) const {
+        cli::Config config = config_;
+        config.concurrency = concurrency;
+        if (!config_.sweep_body_sizes.empty()) {
+            config.body.assign(body_bytes, 'x');
+        }
+        return config;
+    }
+
+    std::vector<SweepCell> Sweep::run() {
+        // Threads are started once, a cell submits one long running loop per worker it uses
+        std::uint32_t most = 0;
+        for (const auto& [concurrency, body] : cells_) {
+            most = std::max(most, concurrency);
+        }
+        pool_ = std::make_unique<ThreadPool>(most);
+
+        std::vector<SweepCell> results;
+        for (std::size_t i = 0; i < cells_.size(); ++i) {
+            auto [concurrency, body] = cells_[i];
+
+            // Idle between cells so one cell's TIME_WAIT and server backlog do not spill into the next
+            if (i > 0 && config_.sweep_cooldown > 0) {
+                std::unique_lock lock(mutex_);
+                stop_condition_.wait_for(lock, std::chrono::seconds(config_.sweep_cooldown), [this]() {
+                    return stopped_;
+                });
+            }
+
+            Engine engine(cell_config(concurrency, body));
+            if (!engine.prepare()) {
+                break;
+            }
+            engine.share_pool(*pool_);
+            {
+                std::lock_guard lock(mutex_);
+                if (stopped_) {
+                    break;
+                }
+                current_ = &engine;
+            }
+
+            SweepCell cell{
+                .concurrency = concurrency,
+                .body_bytes = body,
+                .results = engine.run(),
+            };
+            bool stopped = false;
+            {
+                std::lock_guard lock(mutex_);
+                current_ = nullptr;
+                stopped = stopped_;
+            }
+
+            if (cell_callback_) {
+                cell_callback_(cell, i);
+            }
+            results.push_back(std::move(cell));
+            if (stopped) {
+                break;
+            }
+        }
+
+        pool_.reset();
+        return results;
+    }
+
+    void Sweep::stop() {
+        {
+            std::lock_guard lock(mutex_);
+            stopped_ = true;
+            interrupted_ = true;
+            if (current_ != nullptr) {
+                current_->stop();
+            }
+        }
+        stop_condition_.notify_all();
+    }
+}
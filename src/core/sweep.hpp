@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "cli/config.hpp"
+#include "core/engine.hpp"
+#include "core/thread_pool.hpp"
+
+namespace surge::core {
+    // One combination of a sweep and its results
+    struct SweepCell {
+        std::uint32_t concurrency = 0;
+        std::uint32_t body_bytes = 0;
+        Results results;
+    };
+
+    // Parameter sweep (--sweep-concurrency / --sweep-body): every combination runs back to back in
+    // one process, --sweep-cooldown idle seconds apart. Each cell is a normal run with its own
+    // engine and stats, the worker threads come from one pool sized for the largest concurrency
+    class Sweep {
+        public:
+            explicit Sweep(const cli::Config& config);
+
+            // Disable copy
+            Sweep(const Sweep&) = delete;
+            Sweep& operator=(const Sweep&) = delete;
+
+            // Cells in run order: body sizes outer, concurrency inner (one scaling curve per size)
+            const std::vector<std::pair<std::uint32_t, std::uint32_t>>& cells() const { return cells_; }
+
+            // Called after each cell with its index
+            void on_cell(std::function<void(const SweepCell&, std::size_t)> callback);
+
+            // Run every cell, blocking, stop() ends the current cell and skips the rest
+            std::vector<SweepCell> run();
+
+            // Safe to call from any thread (signal watcher)
+            void stop();
+
+            // stop() was called, also when it landed in a cooldown and no cell saw it
+            bool interrupted() const { return interrupted_; }
+
+        private:
+            cli::Config cell_config(std::uint32_t concurrency, std::uint32_t body_bytes) const;
+
+            cli::Config config_;
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> cells_;    // (concurrency, body bytes)
+            std::function<void(const SweepCell&, std::size_t)> cell_callback_;
+            std::unique_ptr<ThreadPool> pool_;
+
+            // The running cell's engine, for stop()
+            std::mutex mutex_;
+            std::condition_variable stop_condition_;
+            Engine* current_ = nullptr;
+            bool stopped_ = false;
+            std::atomic<bool> interrupted_{false};
+    };
+}
@@ -0,0 +1,206 @@
+#include "core/template.hpp"
+#include "http/url.hpp"
+
+#include <charconv>
+#include <utility>
+
+namespace surge::core {
+    namespace {
+        constexpr std::string_view SLOT_OPEN = "{{";
+        constexpr std::string_view SLOT_CLOSE = "}}";
+        constexpr std::size_t MAX_HEX_DIGITS = 64;
+
+        bool parse_number(std::string_view text, std::uint64_t& out) {
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+            return ec == std::errc{} && end == text.data() + text.size() && !text.empty();
+        }
+
+        void append_number(std::string& out, std::uint64_t value) {
+            char digits[20];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, end);
+        }
+    }
+
+    bool RequestTemplate::compile(std::string_view text, const std::vector<std::unique_ptr<Feeder>>& feeders, std::string& error) {
+        source_.assign(text);
+        segments_.clear();
+        uses_sequence_ = false;
+
+        std::size_t pos = 0;
+        while (pos < text.size()) {
+            std::size_t open = text.find(SLOT_OPEN, pos);
+            if (open != pos) {
+                std::size_t end = open == std::string_view::npos ? text.size() : open;
+                segments_.push_back(Segment{.offset = pos, .length = end - pos});
+                pos = end;
+                continue;
+            }
+
+            std::size_t close = text.find(SLOT_CLOSE, open + SLOT_OPEN.size());
+            if (close == std::string_view::npos) {
+                error = "unterminated placeholder in '" + std::string(text) + "'";
+                return false;
+            }
+            if (!compile_slot(text.substr(open + SLOT_OPEN.size(), close - open - SLOT_OPEN.size()), feeders, error)) {
+                return false;
+            }
+            pos = close + SLOT_CLOSE.size();
+        }
+        return true;
+    }
+
+    bool RequestTemplate::compile_slot(std::string_view slot, const std::vector<std::unique_ptr<Feeder>>& feeders, std::string& error) {
+        Segment segment;
+
+        if (slot == "seq") {
+            segment.slot = Slot::Sequence;
+            uses_sequence_ = true;
+        } else if (slot == "rand") {
+            segment.slot = Slot::Random;
+        } else if (slot.starts_with("rand:")) {
+            // "rand:low-high"
+            std::string_view range = slot.substr(5);
+            std::size_t dash = range.find('-');
+            segment.slot = Slot::Random;
+            segment.ranged = true;
+            if (dash == std::string_view::npos ||
+                !parse_number(range.substr(0, dash), segment.low) ||
+                !parse_number(range.substr(dash + 1), segment.high) ||
+                segment.high < segment.low) {
+                error = "invalid range in {{" + std::string(slot) + "}}";
+                return false;
+            }
+        } else if (slot.starts_with("hex:")) {
+            std::uint64_t digits = 0;
+            if (!parse_number(slot.substr(4), digits) || digits == 0 || digits > MAX_HEX_DIGITS) {
+                error = "invalid length in {{" + std::string(slot) + "}}";
+                return false;
+            }
+            segment.slot = Slot::Hex;
+            segment.length = static_cast<std::size_t>(digits);
+        } else {
+            // "name" or "name.column"
+            std::size_t dot = slot.find('.');
+            std::string_view name = slot.substr(0, dot);
+            for (std::size_t i = 0; i < feeders.size(); ++i) {
+                if (feeders[i]->name() == name) {
+                    segment.feeder = feeders[i].get();
+                    segment.feeder_index = i;
+                }
+            }
+            if (segment.feeder == nullptr) {
+                error = "unknown placeholder {{" + std::string(slot) + "}}";
+                return false;
+            }
+            if (dot != std::string_view::npos) {
+                auto column = segment.feeder->column(slot.substr(dot + 1));
+                if (!column) {
+                    error = "feeder '" + std::string(name) + "' has no column '" + std::string(slot.substr(dot + 1)) + "'";
+                    return false;
+                }
+                segment.column = *column;
+            }
+            segment.slot = Slot::Feeder;
+        }
+
+        segments_.push_back(segment);
+        return true;
+    }
+
+    void RequestTemplate::render(RenderState& state, std::string& out) const {
+        static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+        out.clear();
+
+        for (const Segment& segment : segments_) {
+            switch (segment.slot) {
+                case Slot::Literal:
+                    out.append(source_, segment.offset, segment.length);
+                    break;
+                case Slot::Sequence:
+                    append_number(out, state.sequence);
+                    break;
+                case Slot::Random: {
+                    std::uint64_t value = state.random();
+                    if (segment.ranged) {
+                        std::uint64_t span = segment.high - segment.low;
+                        value = span == UINT64_MAX ? value : segment.low + value % (span + 1);
+                    }
+                    append_number(out, value);
+                    break;
+                }
+                case Slot::Hex: {
+                    std::uint64_t bits = 0;
+                    for (std::size_t i = 0; i < segment.length; ++i) {
+                        if (i % 16 == 0) {
+                            bits = state.random();
+                        }
+                        out.push_back(HEX_DIGITS[bits & 0xF]);
+                        bits >>= 4;
+                    }
+                    break;
+                }
+                case Slot::Feeder:
+                    out.append(segment.feeder->value(state.rows[segment.feeder_index], segment.column));
+                    break;
+            }
+        }
+    }
+
+    bool RequestTemplates::load(const cli::Config& config, std::string& error) {
+        for (const std::string& spec : config.feeders) {
+            // "name=path"
+            std::size_t equals = spec.find('=');
+            auto feeder = std::make_unique<Feeder>(spec.substr(0, equals), spec.substr(equals + 1));
+            if (!feeder->is_open()) {
+                error = "could not read feeder file: " + spec.substr(equals + 1);
+                return false;
+            }
+            feeders_.push_back(std::move(feeder));
+        }
+
+        std::string headers;
+        for (const std::string& header : config.headers) {
+            headers.append(header).append("\r\n");
+        }
+
+        if (!path_.compile(http::url_path(config.url), feeders_, error) ||
+            !headers_.compile(headers, feeders_, error) ||
+            !body_.compile(config.body, feeders_, error)) {
+            return false;
+        }
+
+        seed_ = config.seed;
+        uses_sequence_ = path_.uses_sequence() || headers_.uses_sequence() || body_.uses_sequence();
+        return true;
+    }
+
+    RenderState RequestTemplates::make_state(std::uint32_t worker) const {
+        RenderState state;
+        std::seed_seq seed{seed_, worker};
+        state.random.seed(seed);
+        state.rows.resize(feeders_.size(), 0);
+        return state;
+    }
+
+    void RequestTemplates::next(RenderState& state) {
+        if (uses_sequence_) {
+            state.sequence = sequence_.fetch_add(1, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < feeders_.size(); ++i) {
+            state.rows[i] = feeders_[i]->next_row();
+        }
+    }
+
+    void RequestTemplates::render(RenderState& state, http::Request& request) {
+        next(state);
+        path_.render(state, state.path);
+        headers_.render(state, request.headers);
+        body_.render(state, request.body);
+    }
+
+    void RequestTemplates::render_headers(RenderState& state, http::Request& request) {
+        next(state);
+        headers_.render(state, request.headers);
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "cli/config.hpp"
+#include "core/feeder.hpp"
+#include "http/request.hpp"
+
+namespace surge::core {
+    // Per worker render state and scratch space, reused for every request
+    struct RenderState {
+        std::mt19937_64 random;         // Seeded per worker, {{rand}} / {{hex:n}}
+        std::uint64_t sequence = 0;     // {{seq}} for the current request
+        std::vector<std::size_t> rows;  // Current row of each feeder
+        std::string path;               // Rendered request path
+    };
+
+    // Text compiled at startup into literal segments and placeholder slots
+    //   {{seq}}               request sequence number, shared across workers
+    //   {{rand}}              random 64 bit number, {{rand:10-99}} within a range
+    //   {{hex:n}}             n random hex digits (max 64)
+    //   {{name}}              first column of feeder name, {{name.column}} a named CSV column
+    class RequestTemplate {
+        public:
+            // Compile text, false with error set on an unknown placeholder
+            bool compile(std::string_view text, const std::vector<std::unique_ptr<Feeder>>& feeders, std::string& error);
+
+            bool uses_sequence() const { return uses_sequence_; }
+
+            // Render into out, reusing its capacity
+            void render(RenderState& state, std::string& out) const;
+
+        private:
+            enum class Slot { Literal, Sequence, Random, Hex, Feeder };
+
+            struct Segment {
+                Slot slot = Slot::Literal;
+                std::size_t offset = 0;     // Literal: position in source_
+                std::size_t length = 0;     // Literal: size, Hex: digits
+                bool ranged = false;        // Random: within [low, high], else full 64 bits
+                std::uint64_t low = 0;
+                std::uint64_t high = 0;
+                const Feeder* feeder = nullptr;
+                std::size_t feeder_index = 0;
+                std::size_t column = 0;
+            };
+
+            bool compile_slot(std::string_view slot, const std::vector<std::unique_ptr<Feeder>>& feeders, std::string& error);
+
+            std::string source_;
+            std::vector<Segment> segments_;
+            bool uses_sequence_ = false;
+    };
+
+    // Path, extra headers and body of the synthetic request, plus the feeders they read
+    class RequestTemplates {
+        public:
+            // Open feeders and compile the templates from the config, false with error set on failure
+            bool load(const cli::Config& config, std::string& error);
+
+            RenderState make_state(std::uint32_t worker) const;
+
+            // Render the next request: path into state.path, headers and body into request
+            // Sequence number and feeder rows are picked once, so every part sees the same values
+            void render(RenderState& state, http::Request& request);
+
+            // Only the extra headers (replay keeps the log's path and body)
+            void render_headers(RenderState& state, http::Request& request);
+
+        private:
+            void next(RenderState& state);
+
+            std::vector<std::unique_ptr<Feeder>> feeders_;
+            RequestTemplate path_;
+            RequestTemplate headers_;
+            RequestTemplate body_;
+            std::uint32_t seed_ = 1;
+            bool uses_sequence_ = false;
+            std::atomic<std::uint64_t> sequence_{0};
+    };
+}
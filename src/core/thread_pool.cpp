@@ -1,5 +1,4 @@
 #include "core/thread_pool.hpp"
-#include <chrono>
 #include <cstddef>
 #include <exception>
 #include <functional>
@@ -21,8 +20,6 @@ namespace surge::core {
                 worker_loop();
             });
         }
-        // REMOVE AFTER TESTING
-        std::cout << "ThreadPool created with " << num_threads << " workers\n";
     }
 
     // Destructor: Stop workers and wait for them to finish
@@ -36,9 +33,6 @@ namespace surge::core {
 
         // Wake up all sleeping workers
         condition_.notify_all();
-
-        // REMOVE AFTER TESTING
-        std::cout << "ThreadPool destroyed, all workers joined\n";
     }
 
     // Submit a task to be executed by a worker
@@ -54,21 +48,12 @@ namespace surge::core {
         condition_.notify_one();
     }
 
-    // Wait for all tasks to be completed
+    // Wait for all tasks to be completed, woken by the worker that finishes the last one
     void ThreadPool::wait_for_completion() {
-        while (true) {
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-
-                // Check if all work is done
-                if(tasks_.empty() && active_tasks_ == 0) {
-                    return; // All finished
-                }
-            }
-            // Lock release
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        idle_.wait(lock, [this]() {
+            return tasks_.empty() && active_tasks_ == 0;
+        });
     }
 
     // Worker thread main loop
@@ -107,8 +92,14 @@ namespace surge::core {
                 // Unknown exception
                 std::cerr << "Task threw unknown exception\n";
             }
-            // Task finished, decrement active count
-            active_tasks_--;
+            // Task finished, decrement active count (under the lock so a waiter cannot miss it)
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                active_tasks_--;
+                if (tasks_.empty() && active_tasks_ == 0) {
+                    idle_.notify_all();
+                }
+            }
         }
     }
 }
\ No newline at end of file
@@ -28,7 +28,7 @@ namespace surge::core {
             // task - a callable function with void() sig
             void submit(std::function<void()> task);
 
-            // Wait for all to be submitted
+            // Block until the queue is empty and no task is running
             void wait_for_completion();
 
         private:
@@ -42,6 +42,8 @@ namespace surge::core {
 
             std::condition_variable condition_; // For signaling workers
 
+            std::condition_variable idle_;  // Signalled when the last running task finishes
+
             std::atomic<size_t> active_tasks_{0};   // Count of running tasks
 
             bool stop_flag_{false}; // Signal workers to stop
@@ -0,0 +1,51 @@
+#include "http/body_file.hpp"
+
+#include <fcntl.h>          // open()
+#include <sys/sendfile.h>   // sendfile()
+#include <sys/stat.h>       // fstat()
+#include <unistd.h>         // close()
+#include <cerrno>
+
+namespace surge::http {
+
+    BodyFile::BodyFile(const std::string& filepath) {
+        fd_ = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            return;
+        }
+
+        struct stat info{};
+        if (fstat(fd_, &info) < 0 || !S_ISREG(info.st_mode)) {
+            close(fd_);
+            fd_ = -1;
+            return;
+        }
+        size_ = static_cast<std::uint64_t>(info.st_size);
+    }
+
+    BodyFile::~BodyFile() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool BodyFile::send_to(int sock) const {
+        // Explicit offset, the shared file position is never touched
+        off_t offset = 0;
+        while (static_cast<std::uint64_t>(offset) < size_) {
+            ssize_t sent = sendfile(sock, fd_, &offset, size_ - static_cast<std::uint64_t>(offset));
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (sent == 0) {
+                // File shrank under us
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace surge::http {
+
+    // Request body read straight from a file with sendfile()
+    // Opened once and shared read-only by every worker: each send passes its own
+    // offset, so the payload is neither duplicated in memory nor copied through user space
+    class BodyFile {
+        public:
+            explicit BodyFile(const std::string& filepath);
+            ~BodyFile();
+
+            // Disable copy
+            BodyFile(const BodyFile&) = delete;
+            BodyFile& operator=(const BodyFile&) = delete;
+
+            bool is_open() const { return fd_ >= 0; }
+
+            int fd() const { return fd_; }
+            std::uint64_t size() const { return size_; }
+
+            // Send the whole file to a connected socket, false on error
+            bool send_to(int sock) const;
+
+        private:
+            int fd_ = -1;
+            std::uint64_t size_ = 0;
+    };
+
+}
@@ -1,30 +1,180 @@
 #include "http/client.hpp"
+#include "http/clock.hpp"
 #include "http/request.hpp"
-#include "http/response.hpp"
+#include "http/result.hpp"
+#include "http/url.hpp"
 
 // System headers for socket programming
 #include <chrono>
-#include <sys/socket.h>     // socket(), connect(), send(), recv()
+#include <sys/socket.h>     // socket(), connect(), sendmsg(), recv()
+#include <sys/uio.h>        // iovec
 #include <netinet/in.h>     // sockaddr_in struct
-#include <arpa/inet.h>      // inet_addr()
-#include <netdb.h>          // gethostbyname() for DNS lookup
+#include <sys/un.h>         // sockaddr_un struct
+#include <arpa/inet.h>      // htons()
+#include <netdb.h>          // getaddrinfo() for DNS lookup
 #include <unistd.h>         // close() for file descriptors
+#include <linux/errqueue.h> // scm_timestamping
+#include <time.h>           // clock_gettime()
 
 // Standard library
-#include <cstring>          // memset(), strlen()
-#include <sstream>          // std::istringstream for string parsing
+#include <algorithm>
+#include <cctype>           // std::tolower
+#include <cerrno>
+#include <charconv>         // std::from_chars, std::to_chars
+#include <cstring>          // memcpy()
 
 namespace surge::http {
+    namespace {
+        // Initial receive buffer, grows only if a response head doesnt fit
+        constexpr std::size_t RECEIVE_BUFFER_SIZE = 4096;
+
+        // Minimum space kept after the headers for reading (and discarding) the body
+        constexpr std::size_t MIN_BODY_SPACE = 1024;
+
+        constexpr std::string_view HEADER_END = "\r\n\r\n";
+        constexpr std::string_view SERVER_TIMING = "Server-Timing";
+        constexpr std::string_view TOTAL_METRIC = "total";
+        constexpr std::string_view CONTENT_ENCODING = "Content-Encoding";
+        constexpr std::string_view TRANSFER_ENCODING = "Transfer-Encoding";
+
+        // Every handshake uses the RFC 6455 sample nonce, so the expected accept value is
+        // a constant and no SHA-1 is needed to check it
+        constexpr std::string_view WEBSOCKET_HANDSHAKE =
+            "Upgrade: websocket\r\n"
+            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+            "Sec-WebSocket-Version: 13\r\n";
+        constexpr std::string_view WEBSOCKET_ACCEPT = "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=";
+
+        // Most a single MSG_TRUNC read may discard
+        constexpr std::size_t DISCARD_CHUNK = std::size_t{64} << 20;
+
+        // Room for one SCM_TIMESTAMPING control message
+        constexpr std::size_t CONTROL_BUFFER_SIZE = CMSG_SPACE(sizeof(scm_timestamping)) + 64;
+
+        std::string_view trim(std::string_view text) {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        bool equals_ignore_case(std::string_view a, std::string_view b) {
+            if (a.size() != b.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // "12.5", "12.5ms", "0.0125s" or "12500us" -> milliseconds
+        // false if not a number or the unit is unknown, out is then left untouched
+        bool parse_milliseconds(std::string_view text, double& out) {
+            text = trim(text);
+            double value = 0.0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec != std::errc{} || end == text.data()) {
+                return false;
+            }
+            std::string_view unit = text.substr(static_cast<size_t>(end - text.data()));
+            if (unit == "s") {
+                value *= 1000.0;
+            } else if (unit == "us" || unit == "μs") {
+                value /= 1000.0;
+            } else if (!unit.empty() && unit != "ms") {
+                return false;
+            }
+            out = value;
+            return true;
+        }
+
+        std::int64_t to_nanos(const timespec& time) {
+            return static_cast<std::int64_t>(time.tv_sec) * 1'000'000'000 + time.tv_nsec;
+        }
+
+        // Software timestamp (ts[0]) of a message from an SO_TIMESTAMPING socket, 0 if none
+        std::int64_t software_timestamp(msghdr& message) {
+            for (cmsghdr* control = CMSG_FIRSTHDR(&message); control != nullptr; control = CMSG_NXTHDR(&message, control)) {
+                if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPING) {
+                    scm_timestamping stamps;
+                    memcpy(&stamps, CMSG_DATA(control), sizeof(stamps));
+                    return to_nanos(stamps.ts[0]);
+                }
+            }
+            return 0;
+        }
+
+        // recv() that also returns the kernel receive timestamp of the data
+        ssize_t receive_timestamped(int sock, char* destination, size_t space, std::int64_t& received_at) {
+            alignas(cmsghdr) char control[CONTROL_BUFFER_SIZE];
+            iovec data{destination, space};
+            msghdr message{};
+            message.msg_iov = &data;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            ssize_t bytes_received = recvmsg(sock, &message, 0);
+            if (bytes_received > 0) {
+                received_at = software_timestamp(message);
+            }
+            return bytes_received;
+        }
+
+        // Latest transmit timestamp queued on the error queue, 0 if none
+        // For TCP each send is stamped when its last byte leaves, so the latest is the end of the request
+        std::int64_t last_sent_timestamp(int sock) {
+            std::int64_t latest = 0;
+            while (true) {
+                alignas(cmsghdr) char control[CONTROL_BUFFER_SIZE];
+                msghdr message{};
+                message.msg_control = control;
+                message.msg_controllen = sizeof(control);
+                if (recvmsg(sock, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                    return latest;
+                }
+                latest = std::max(latest, software_timestamp(message));
+            }
+        }
+    }
+
+    Client::Client(const SocketOptions& options, const ReceiveOptions& receive)
+        : options_(options)
+        , receive_(receive)
+        , receive_buffer_(RECEIVE_BUFFER_SIZE)
+    {
+        request_buffer_.reserve(256);
+        TscClock::init();
+    }
+
     // Parse URL: "http://example.com:8080/api/v1"
     // Protocol: "http://", Host: "example.com", Port: "8080", Path: "/api/v1"
-    Client::ParsedUrl Client::parse_url(const std::string& url) {
-        ParsedUrl result;
+    // Result holds views into url, nothing is copied
+    bool Client::parse_url(std::string_view url, ParsedUrl& result) {
+        // Unix socket: "http+unix:///run/app.sock:/path"
+        if (is_unix_url(url)) {
+            std::string_view base = url_base(url);
+            result.socket_path = base.substr(UNIX_SCHEME.size());
+            if (result.socket_path.ends_with(':')) {
+                result.socket_path.remove_suffix(1);
+            }
+            result.path = url_path(url);
+            result.host = "localhost";
+            result.port = 0;
+            return !result.socket_path.empty();
+        }
+        result.socket_path = {};
 
         // Find "://" ends, skips protocol
-        // std::string::find returns position or std::string::npos if not found
         size_t protocol_end = url.find("://");
-        if (protocol_end == std::string::npos) {
-            // No protocol specified, assume starts at beginning 
+        if (protocol_end == std::string_view::npos) {
+            // No protocol specified, assume starts at beginning
             protocol_end = 0;
         } else {
             // Skip past ://
@@ -35,8 +185,8 @@ namespace surge::http {
         size_t path_start = url.find('/', protocol_end);
 
         // Extract host:port part
-        std::string host_port;
-        if (path_start == std::string::npos) {
+        std::string_view host_port;
+        if (path_start == std::string_view::npos) {
             // No path specified (e.g. "example.com")
             host_port = url.substr(protocol_end);
             result.path = "/";
@@ -48,167 +198,412 @@ namespace surge::http {
 
         // Split host:port
         size_t port_separator = host_port.find(':');
-        if (port_separator == std::string::npos) {
+        if (port_separator == std::string_view::npos) {
             // No port specified use default HTTP
             result.host = host_port;
             result.port = 80;
         } else {
             result.host = host_port.substr(0, port_separator);
-            std::string port_str = host_port.substr(port_separator + 1);
-            result.port = static_cast<std::uint16_t>(std::stoi(port_str));
+            std::string_view port_str = host_port.substr(port_separator + 1);
+
+            auto [end, ec] = std::from_chars(port_str.data(), port_str.data() + port_str.size(), result.port);
+            if (ec != std::errc{} || end != port_str.data() + port_str.size()) {
+                return false;
+            }
         }
 
-        return result;
+        return !result.host.empty();
     }
 
-    std::string Client::build_request_string(const Request& request, const std::string& host) {
-        std::string result;
+    // Resolve hostname to an IP address, cached while the host stays the same
+    bool Client::resolve(const ParsedUrl& url) {
+        std::string_view key = url.socket_path.empty() ? url.host : url.socket_path;
+        if (endpoint_.resolved && endpoint_.port == url.port && endpoint_.host == key) {
+            return true;
+        }
+
+        endpoint_.resolved = false;
+        endpoint_.host.assign(key);
+        endpoint_.port = url.port;
+
+        // Unix socket path, no lookup needed
+        if (!url.socket_path.empty()) {
+            auto* address = reinterpret_cast<sockaddr_un*>(&endpoint_.address);
+            if (url.socket_path.size() >= sizeof(address->sun_path)) {
+                return false;
+            }
+            memset(address, 0, sizeof(sockaddr_un));
+            address->sun_family = AF_UNIX;
+            memcpy(address->sun_path, url.socket_path.data(), url.socket_path.size());
+
+            endpoint_.family = AF_UNIX;
+            endpoint_.address_length = static_cast<socklen_t>(sizeof(sockaddr_un));
+            endpoint_.resolved = true;
+            return true;
+        }
+
+        addrinfo hints{};
+        hints.ai_family = AF_INET;          // IPv4
+        hints.ai_socktype = SOCK_STREAM;    // TCP
+
+        addrinfo* info = nullptr;
+        if (getaddrinfo(endpoint_.host.c_str(), nullptr, &hints, &info) != 0 || info == nullptr) {
+            return false;
+        }
+
+        auto* address = reinterpret_cast<sockaddr_in*>(&endpoint_.address);
+        memcpy(address, info->ai_addr, sizeof(sockaddr_in));
+        address->sin_port = htons(url.port);
+        freeaddrinfo(info);
 
-        // Parse url to get path
-        ParsedUrl url = parse_url(request.url);
+        endpoint_.family = AF_INET;
+        endpoint_.address_length = static_cast<socklen_t>(sizeof(sockaddr_in));
+
+        endpoint_.resolved = true;
+        return true;
+    }
+
+    // Write the request head into request_buffer_ (reuses its capacity)
+    // Extra headers and the body are not copied in, execute() sends them from the request
+    void Client::build_request(const Request& request, const ParsedUrl& url, std::string_view connection) {
+        std::string& result = request_buffer_;
+        result.clear();
 
         // Request line: "GET /api/users HTTP/1.1\r\n"
-        result += request.method + " " + url.path + " HTTP/1.1\r\n";
+        result.append(request.method).append(" ").append(url.path).append(" HTTP/1.1\r\n");
 
         // Host header (Required in HTTP 1.1)
-        result += "Host: " + host + "\r\n";
+        result.append("Host: ").append(request.host.empty() ? url.host : std::string_view(request.host)).append("\r\n");
 
         // Connection header
-        result += "Connection: close\r\n";
+        result.append("Connection: ").append(connection).append("\r\n");
+
+        if (!receive_.accept_encoding.empty()) {
+            result.append("Accept-Encoding: ").append(receive_.accept_encoding).append("\r\n");
+        }
+
+        // Extra headers are sent from request.headers at this point
+        extra_headers_at_ = result.size();
 
         // If theres a body, add content length header
-        if (!request.body.empty()) {
-            result += "Content-Length: " + std::to_string(request.body.length()) + "\r\n";
+        std::uint64_t body_length = request.body_file ? request.body_file->size() : request.body.length();
+        if (body_length > 0) {
+            char length[20];
+            auto [end, ec] = std::to_chars(length, length + sizeof(length), body_length);
+            result.append("Content-Length: ").append(length, end).append("\r\n");
         }
 
         // End of headers
-        result += "\r\n";
+        result.append("\r\n");
+    }
+
+    // Send the head, extra headers and an in-memory body in one scatter-gather write
+    // more = data follows (MSG_MORE), so the head is coalesced with a file body
+    bool Client::send_request(int sock, std::string_view headers, std::string_view body, bool more) {
+        std::string_view head(request_buffer_);
+        std::string_view pieces[] = {head.substr(0, extra_headers_at_), headers, head.substr(extra_headers_at_), body};
+
+        iovec parts[4];
+        size_t remaining = 0;
+        for (std::string_view piece : pieces) {
+            if (!piece.empty()) {
+                parts[remaining++] = {const_cast<char*>(piece.data()), piece.size()};
+            }
+        }
+        iovec* next = parts;
+
+        while (remaining > 0) {
+            msghdr message{};
+            message.msg_iov = next;
+            message.msg_iovlen = remaining;
+
+            ssize_t bytes_sent = sendmsg(sock, &message, MSG_NOSIGNAL | (more ? MSG_MORE : 0));
+            if (bytes_sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
 
-        // Add body if present
-        if (!request.body.empty()) {
-            result += request.body;
+            // Skip what was written, possibly part way into a buffer
+            auto sent = static_cast<size_t>(bytes_sent);
+            while (remaining > 0 && sent >= next->iov_len) {
+                sent -= next->iov_len;
+                ++next;
+                --remaining;
+            }
+            if (remaining > 0) {
+                next->iov_base = static_cast<char*>(next->iov_base) + sent;
+                next->iov_len -= sent;
+            }
         }
+        return true;
+    }
 
-        return result;
+    // "db;dur=3.2;desc=\"Query\", app;dur=7.1", metrics without a duration are skipped
+    void Client::parse_server_timing(std::string_view value, Result& result) {
+        while (!value.empty() && result.server_timing_count < Result::MAX_SERVER_TIMINGS) {
+            size_t comma = value.find(',');
+            std::string_view metric = value.substr(0, comma);
+            value = comma == std::string_view::npos ? std::string_view{} : value.substr(comma + 1);
+
+            size_t separator = metric.find(';');
+            std::string_view name = trim(metric.substr(0, separator));
+            while (separator != std::string_view::npos) {
+                metric.remove_prefix(separator + 1);
+                separator = metric.find(';');
+                std::string_view parameter = trim(metric.substr(0, separator));
+
+                double milliseconds = 0.0;
+                if (parameter.starts_with("dur=") && !name.empty() && parse_milliseconds(parameter.substr(4), milliseconds)) {
+                    result.server_timings[result.server_timing_count++] = ServerTiming{name, milliseconds};
+                    break;
+                }
+            }
+        }
     }
 
-    // Parse raw HTTP response into Response struct
-    Response Client::parse_response(const std::string& raw_response) {
-        Response response;
+    // Set up the decoder for the body that follows head, false if its coding is not supported
+    bool Client::begin_decode(std::string_view head, Result& result) {
+        ContentEncoding encoding = ContentEncoding::Identity;
+        bool chunked = false;
+        size_t line_start = head.find("\r\n");
+        while (line_start != std::string_view::npos) {
+            head.remove_prefix(line_start + 2);
+            line_start = head.find("\r\n");
+            std::string_view header = head.substr(0, line_start);
+            size_t colon = header.find(':');
+            if (colon == std::string_view::npos) {
+                continue;
+            }
+            std::string_view name = trim(header.substr(0, colon));
+            if (equals_ignore_case(name, CONTENT_ENCODING)) {
+                encoding = parse_content_encoding(header.substr(colon + 1));
+            } else if (equals_ignore_case(name, TRANSFER_ENCODING)) {
+                chunked = equals_ignore_case(trim(header.substr(colon + 1)), "chunked");
+            }
+        }
+        result.compressed = encoding != ContentEncoding::Identity;
+        return decoder_.begin(encoding, chunked);
+    }
 
+    // Parse the raw response head into result
+    bool Client::parse_response(std::string_view raw_response, Result& result) const {
         // Find end of the status line
         size_t status_line_end = raw_response.find("\r\n");
-        if (status_line_end == std::string::npos) {
-            response.success = false;
-            response.error_message = "Invalid HTTP Response: no status line.";
-            return response;
+        if (status_line_end == std::string_view::npos) {
+            result.error = "Invalid HTTP Response: no status line.";
+            return false;
         }
 
-        // Extract status line: "HTTP/1.1 200 OK"
-        std::string status_line = raw_response.substr(0, status_line_end);
-
-        // Parse status code (second token)
-        std::istringstream status_stream(status_line);
-        std::string http_version, status_code_str;
-        status_stream >> http_version >> status_code_str;
+        // Status line: "HTTP/1.1 200 OK", code is the second token
+        std::string_view status_line = raw_response.substr(0, status_line_end);
+        size_t code_start = status_line.find(' ');
+        if (code_start == std::string_view::npos) {
+            result.error = "Invalid status code";
+            return false;
+        }
+        status_line.remove_prefix(code_start + 1);
 
-        // Convert status response to integer
-        try {
-            response.status_code = static_cast<std::uint16_t>(std::stoi(status_code_str));
-        } catch (...) {
-            response.success = false;
-            response.error_message = "Invalid status code";
-            return response;
+        auto [end, ec] = std::from_chars(status_line.data(), status_line.data() + status_line.size(), result.status_code);
+        if (ec != std::errc{} || end == status_line.data()) {
+            result.error = "Invalid status code";
+            return false;
         }
 
         // Find where headers end "\r\n\r\n"
-        size_t headers_end = raw_response.find("\r\n\r\n");
-        if (headers_end == std::string::npos) {
-            response.success = false;
-            response.error_message = "Invalid HTTP response: no header/body seperator";
-            return response;
+        size_t headers_end = raw_response.find(HEADER_END);
+        if (headers_end == std::string_view::npos) {
+            result.error = "Invalid HTTP response: no header/body seperator";
+            return false;
         }
 
-        // Extract body (everything after headers)
-        response.body = raw_response.substr(headers_end + 4);
-        response.success = true;
-
-        return response;
-    }
-
-    // Main method: execute HTTP request
-    Response Client::execute(const Request& request) {
-        Response response;
+        // Server reported timings, views into the head
+        std::string_view headers = raw_response.substr(status_line_end + 2, headers_end - status_line_end);
+        double header_time = -1.0;
+        while (!headers.empty()) {
+            size_t line_end = headers.find("\r\n");
+            std::string_view header = headers.substr(0, line_end);
+            headers.remove_prefix(line_end == std::string_view::npos ? headers.size() : line_end + 2);
+
+            size_t colon = header.find(':');
+            if (colon == std::string_view::npos) {
+                continue;
+            }
+            std::string_view name = trim(header.substr(0, colon));
+            std::string_view value = header.substr(colon + 1);
+
+            if (equals_ignore_case(name, SERVER_TIMING)) {
+                parse_server_timing(value, result);
+            } else if (!receive_.response_time_header.empty() && equals_ignore_case(name, receive_.response_time_header)) {
+                // A malformed value is ignored, server time then falls back to Server-Timing
+                double milliseconds = 0.0;
+                if (parse_milliseconds(value, milliseconds) && result.server_timing_count < Result::MAX_SERVER_TIMINGS) {
+                    header_time = milliseconds;
+                    result.server_timings[result.server_timing_count++] = ServerTiming{receive_.response_time_header, header_time};
+                }
+            }
+        }
 
-        // Start timing
-        auto start_time = std::chrono::high_resolution_clock::now();
+        if (result.server_timing_count > 0) {
+            double sum = 0.0;
+            double total = -1.0;
+            for (size_t i = 0; i < result.server_timing_count; ++i) {
+                const ServerTiming& timing = result.server_timings[i];
+                if (timing.name == TOTAL_METRIC) {
+                    total = timing.milliseconds;
+                }
+                if (timing.name != receive_.response_time_header) {
+                    sum += timing.milliseconds;
+                }
+            }
+            result.server_time_ms = header_time >= 0.0 ? header_time : total >= 0.0 ? total : sum;
+        }
 
-        // Parse URL
-        ParsedUrl url = parse_url(request.url);
+        return true;
+    }
 
-        if (url.host.empty()) {
-            response.success = false;
-            response.error_message = "Invalid URL: no host specified";
-            return response;
+    // Create a TCP (or Unix) socket with the configured options (and source address) and connect it
+    // -1 with the error and time to failure in result
+    int Client::open_socket(Result& result, std::uint64_t start_time) {
+        result.connect_attempted = true;
+        int sock = create_socket(endpoint_.family, options_);
+        if (sock < 0) {
+            result.error = errno == EADDRINUSE || errno == EADDRNOTAVAIL
+                ? "Failed to bind source address (ports exhausted)"
+                : "Failed to create socket";
+            result.latency = TscClock::elapsed(start_time, TscClock::now());
+            return -1;
         }
 
-        // Resolve hostname to an IP address
-        struct hostent* host_info = gethostbyname(url.host.c_str());
-        if (host_info == nullptr) {
-            response.success = false;
-            response.error_message = "Failed to resolve host: " + url.host;
-            return response;
+        // Connect to the server
+        if (connect(sock, reinterpret_cast<const sockaddr*>(&endpoint_.address), endpoint_.address_length) < 0) {
+            result.error = errno == EADDRNOTAVAIL
+                ? "Failed to connect (local ports exhausted)"
+                : "Failed to connect";
+            close(sock);    // Clean up socket before returning
+            result.latency = TscClock::elapsed(start_time, TscClock::now());
+            return -1;
         }
-
-        // Create a socket, AF_INET = IPv4, SOCK_STREAM = TCP, 0 = default protocol;
-        int sock = socket(AF_INET, SOCK_STREAM, 0);
-        if (sock < 0) {
-            response.success = false;
-            response.error_message = "Failed to create socket";
-            return response;
+        result.connected = true;
+        result.connect_time = TscClock::elapsed(start_time, TscClock::now());
+        connections_opened_++;
+        apply_connected_options(sock, endpoint_.family, options_);
+
+        if (options_.local_port && endpoint_.family == AF_INET) {
+            sockaddr_in local{};
+            socklen_t length = sizeof(local);
+            if (getsockname(sock, reinterpret_cast<sockaddr*>(&local), &length) == 0) {
+                result.local_port = ntohs(local.sin_port);
+            }
         }
+        return sock;
+    }
+
+    // Main method: execute HTTP request
+    Result Client::execute(const Request& request) {
+        Result result;
+        response_head_length_ = 0;
 
-        // Setup server address structure
-        struct sockaddr_in server_addr;
-        memset(&server_addr, 0, sizeof(server_addr));
+        // Parse URL
+        ParsedUrl url;
+        if (!parse_url(request.url, url)) {
+            result.error = "Invalid URL: no host specified";
+            return result;
+        }
 
-        server_addr.sin_family = AF_INET;
-        server_addr.sin_port = htons(url.port);
+        if (!resolve(url)) {
+            result.error = "Failed to resolve host";
+            return result;
+        }
 
-        // Copy IP address from host info
-        memcpy(&server_addr.sin_addr, host_info->h_addr_list[0], host_info->h_length);
+        // Start timing (connect + send + receive)
+        // Failures from here on carry the time until the error as their latency
+        std::uint64_t start_time = TscClock::now();
+        auto elapsed = [start_time]() {
+            return TscClock::elapsed(start_time, TscClock::now());
+        };
 
-        // Connect to the server
-        if (connect(sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-            close(sock);    // Clean up socket before returning
-            response.success = false;
-            response.error_message = "Failed to connect to " + url.host;
-            return response;
+        int sock = open_socket(result, start_time);
+        if (sock < 0) {
+            return result;
         }
 
-        // Build & send HTTP request
-        std::string request_str = build_request_string(request, url.host);
+        // Build & send HTTP request, a file body follows the head with sendfile()
+        build_request(request, url);
 
-        ssize_t bytes_sent = send(sock, request_str.c_str(), request_str.length(), 0);
-        if (bytes_sent < 0) {
+        bool sent = request.body_file
+            ? send_request(sock, request.headers, {}, true) && request.body_file->send_to(sock)
+            : send_request(sock, request.headers, request.body);
+        if (!sent) {
             close(sock);
-            response.success = false;
-            response.error_message = "Failed to send request";
-            return response;
+            result.error = "Failed to send request";
+            result.latency = elapsed();
+            return result;
         }
+        apply_connected_options(sock, endpoint_.family, options_);
+        result.bytes_sent = request_buffer_.size() + request.headers.size() +
+            (request.body_file ? request.body_file->size() : request.body.size());
 
         // Receive response
-        std::string response_data;
-        char buffer[4096];   // 4KB buffer
+        // The head is kept at the start of the buffer, once it is complete
+        // the body is read into the space after it and discarded
+        // (or dropped by the kernel without a copy in download mode)
+        size_t filled = 0;
+        size_t head_length = 0;
+        size_t body_space = std::max(MIN_BODY_SPACE, receive_.body_buffer);
+        bool discard = receive_.discard_in_kernel && endpoint_.family == AF_INET;
+
+        // Body decoding, timed apart from the request
+        bool decoding = false;
+        const char* decode_error = nullptr;
+        std::uint64_t decode_ticks = 0;
+        auto decode = [&](const char* data, size_t length) {
+            if (!decoding || length == 0) {
+                return;
+            }
+            std::uint64_t decode_start = TscClock::now();
+            if (!decoder_.feed(data, length)) {
+                decoding = false;
+                decode_error = "Failed to decode response body";
+            }
+            decode_ticks += TscClock::now() - decode_start;
+            result.body_wire_bytes += length;
+        };
+
+        // Kernel timestamps (ns, CLOCK_REALTIME) around the first response byte
+        bool timestamping = options_.kernel_timestamps && endpoint_.family == AF_INET;
+        std::int64_t first_received_at = 0;
+        std::int64_t first_read_at = 0;
 
         while (true) {
-            ssize_t bytes_received = recv(sock, buffer, sizeof(buffer), 0);
+            if (head_length == 0 && filled == receive_buffer_.size()) {
+                receive_buffer_.resize(receive_buffer_.size() * 2);
+            }
+            if (head_length != 0 && !discard && receive_buffer_.size() - head_length < body_space) {
+                receive_buffer_.resize(head_length + body_space);
+            }
+
+            char* destination = receive_buffer_.data() + (head_length == 0 ? filled : head_length);
+            size_t space = receive_buffer_.size() - (head_length == 0 ? filled : head_length);
+
+            ssize_t bytes_received;
+            if (timestamping && first_read_at == 0) {
+                bytes_received = receive_timestamped(sock, destination, space, first_received_at);
+                timespec now{};
+                clock_gettime(CLOCK_REALTIME, &now);
+                first_read_at = to_nanos(now);
+            } else if (head_length != 0 && discard) {
+                bytes_received = recv(sock, nullptr, DISCARD_CHUNK, MSG_TRUNC);
+            } else {
+                bytes_received = recv(sock, destination, space, 0);
+            }
 
             if (bytes_received < 0) {
                 close(sock);
-                response.success = false;
-                response.error_message = "Failed to received response";
-                return response;
+                result.error = "Failed to received response";
+                result.latency = elapsed();
+                return result;
             }
 
             if (bytes_received == 0) {
@@ -216,21 +611,143 @@ namespace surge::http {
                 break;
             }
 
-            response_data.append(buffer, bytes_received);
+            if (result.bytes_received == 0) {
+                result.first_byte = elapsed();
+            }
+            result.bytes_received += static_cast<std::uint64_t>(bytes_received);
+
+            if (head_length == 0) {
+                // Look for the end of headers, including a separator split across reads
+                size_t search_from = filled >= 3 ? filled - 3 : 0;
+                filled += static_cast<size_t>(bytes_received);
+
+                std::string_view received(receive_buffer_.data(), filled);
+                size_t headers_end = received.find(HEADER_END, search_from);
+                if (headers_end != std::string_view::npos) {
+                    head_length = headers_end + HEADER_END.size();
+                    if (receive_.decompress) {
+                        decoding = begin_decode(received.substr(0, head_length), result);
+                        if (!decoding) {
+                            decode_error = "Unsupported Content-Encoding";
+                        }
+                        decode(receive_buffer_.data() + head_length, filled - head_length);
+                    }
+                }
+            } else {
+                decode(destination, static_cast<size_t>(bytes_received));
+            }
+        }
+
+        if (decoding && result.body_wire_bytes > 0) {
+            std::uint64_t decode_start = TscClock::now();
+            if (!decoder_.finish()) {
+                decode_error = "Truncated response body";
+            }
+            decode_ticks += TscClock::now() - decode_start;
+            result.body_decoded_bytes = decoder_.decoded_bytes();
+        }
+
+        // Split the wait into network + server time and time before we read the socket
+        if (timestamping && first_received_at != 0) {
+            std::int64_t last_sent_at = last_sent_timestamp(sock);
+            if (last_sent_at != 0 && first_received_at >= last_sent_at && first_read_at >= first_received_at) {
+                result.timestamped = true;
+                result.network_time = std::chrono::microseconds((first_received_at - last_sent_at) / 1000);
+                result.read_delay = std::chrono::microseconds((first_read_at - first_received_at) / 1000);
+            }
         }
 
         close(sock);
 
-        // Calculate latency
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        // Calculate latency, decoding is client work and not part of it
+        result.decode_time = TscClock::to_micros(decode_ticks);
+        result.latency = elapsed() - result.decode_time;
+
+        // Parse response head
+        std::string_view head(receive_buffer_.data(), head_length == 0 ? filled : head_length);
+        response_head_length_ = head_length;
+        result.success = parse_response(head, result);
+        if (result.success && decode_error != nullptr) {
+            result.success = false;
+            result.error = decode_error;
+        }
+
+        return result;
+    }
+
+    std::string_view Client::response_head() const {
+        return {receive_buffer_.data(), response_head_length_};
+    }
+
+    int Client::upgrade(const Request& request, Result& result, std::string& leftover) {
+        ParsedUrl url;
+        if (!parse_url(request.url, url)) {
+            result.error = "Invalid URL: no host specified";
+            return -1;
+        }
+        if (!resolve(url)) {
+            result.error = "Failed to resolve host";
+            return -1;
+        }
+
+        std::uint64_t start_time = TscClock::now();
+        int sock = open_socket(result, start_time);
+        if (sock < 0) {
+            return -1;
+        }
 
-        response.latency = duration;
+        // Once per connection, the handshake goes with the extra headers
+        std::string headers = request.headers;
+        headers.append(WEBSOCKET_HANDSHAKE);
+        build_request(request, url, "Upgrade");
+        if (!send_request(sock, headers, {})) {
+            close(sock);
+            result.error = "Failed to send request";
+            result.latency = TscClock::elapsed(start_time, TscClock::now());
+            return -1;
+        }
+        result.bytes_sent = request_buffer_.size() + headers.size();
+
+        // Read just the head, the connection stays open for frames
+        size_t filled = 0;
+        size_t head_length = 0;
+        while (head_length == 0) {
+            if (filled == receive_buffer_.size()) {
+                receive_buffer_.resize(receive_buffer_.size() * 2);
+            }
+            ssize_t bytes_received = recv(sock, receive_buffer_.data() + filled, receive_buffer_.size() - filled, 0);
+            if (bytes_received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes_received <= 0) {
+                close(sock);
+                result.error = bytes_received == 0 ? "Connection closed during WebSocket handshake" : "Failed to received response";
+                result.latency = TscClock::elapsed(start_time, TscClock::now());
+                return -1;
+            }
+            size_t search_from = filled >= 3 ? filled - 3 : 0;
+            filled += static_cast<size_t>(bytes_received);
+            size_t headers_end = std::string_view(receive_buffer_.data(), filled).find(HEADER_END, search_from);
+            if (headers_end != std::string_view::npos) {
+                head_length = headers_end + HEADER_END.size();
+            }
+        }
+        result.bytes_received = filled;
+        result.latency = TscClock::elapsed(start_time, TscClock::now());
 
-        // Parse response
-        response = parse_response(response_data);
-        response.latency = duration;
+        std::string_view head(receive_buffer_.data(), head_length);
+        if (!parse_response(head, result)) {
+            close(sock);
+            return -1;
+        }
+        if (result.status_code != 101 || head.find(WEBSOCKET_ACCEPT) == std::string_view::npos) {
+            close(sock);
+            result.error = result.status_code != 101 ? "WebSocket upgrade refused" : "Invalid Sec-WebSocket-Accept";
+            return -1;
+        }
 
-        return response;
+        leftover.assign(receive_buffer_.data() + head_length, filled - head_length);
+        result.success = true;
+        return sock;
     }
-}
\ No newline at end of file
+}
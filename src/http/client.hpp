@@ -1,34 +1,90 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/socket.h>
+#include "http/decoder.hpp"
 #include "http/request.hpp"
-#include "http/response.hpp"
+#include "http/result.hpp"
+#include "http/socket.hpp"
 
 namespace surge::http {
 
+// How response bodies are drained, the body is never kept
+struct ReceiveOptions {
+    std::size_t body_buffer = 0;        // Bytes per read once the head is in, 0 = default (grows from 1 KB)
+    bool discard_in_kernel = false;     // TCP: drop the body with MSG_TRUNC, it is never copied to user space
+    std::string response_time_header;   // Numeric header with the server's own time (e.g. X-Response-Time), in ms
+    std::string accept_encoding;        // Accept-Encoding sent with every request, empty = none
+    bool decompress = false;            // Decode chunked / compressed bodies, count the decoded bytes and time it
+};
+
+// One Client per worker: it owns the request and receive buffers and
+// caches the resolved endpoint, so once warmed up execute() does not allocate
 class Client {
 public:
-    Client() = default;
+    explicit Client(const SocketOptions& options = {}, const ReceiveOptions& receive = {});
     ~Client() = default;
-    
+
     // Disable copy
     Client(const Client&) = delete;
     Client& operator=(const Client&) = delete;
-    
+
     // Make an HTTP request
-    Response execute(const Request& request);
+    Result execute(const Request& request);
+
+    // Connect and upgrade to WebSocket (RFC 6455), request.headers are sent with the handshake
+    // Returns the open socket (the caller closes it) or -1 with result.error set
+    // Bytes the server sent after its 101 head are left in leftover
+    int upgrade(const Request& request, Result& result, std::string& leftover);
+
+    // Status line and headers of the last execute() response, valid until the next call
+    std::string_view response_head() const;
+
+    // Connections opened so far, every request opens its own
+    std::uint64_t connections_opened() const { return connections_opened_; }
 
 private:
+    // Views into the request URL
     struct ParsedUrl {
+        std::string_view host;
+        std::uint16_t port = 80;
+        std::string_view path;
+        std::string_view socket_path;   // Set for http+unix:// targets
+    };
+
+    // Last resolved host (or socket path), reused while the target does not change
+    struct Endpoint {
         std::string host;
-        std::uint16_t port;
-        std::string path;
+        std::uint16_t port = 0;
+        int family = AF_INET;
+        sockaddr_storage address{};
+        socklen_t address_length = 0;
+        bool resolved = false;
     };
-    
-    ParsedUrl parse_url(const std::string& url);
-    std::string build_request_string(const Request& request, 
-                                     const std::string& host);
-    Response parse_response(const std::string& raw_response);
+
+    static bool parse_url(std::string_view url, ParsedUrl& result);
+    bool resolve(const ParsedUrl& url);
+    int open_socket(Result& result, std::uint64_t start_time);
+    void build_request(const Request& request, const ParsedUrl& url, std::string_view connection = "close");
+    bool send_request(int sock, std::string_view headers, std::string_view body, bool more = false);
+    bool parse_response(std::string_view raw_response, Result& result) const;
+    static void parse_server_timing(std::string_view value, Result& result);
+    bool begin_decode(std::string_view head, Result& result);
+
+    SocketOptions options_;
+    ReceiveOptions receive_;
+    Endpoint endpoint_;
+
+    // Reused per request, capacity is kept between calls
+    std::string request_buffer_;
+    std::size_t extra_headers_at_ = 0;  // Where request.headers go in request_buffer_
+    std::vector<char> receive_buffer_;
+    std::size_t response_head_length_ = 0;
+    Decoder decoder_;
+    std::uint64_t connections_opened_ = 0;
 };
 
-}  // namespace surge::http
\ No newline at end of file
+}  // namespace surge::http
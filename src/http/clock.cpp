@@ -0,0 +1,53 @@
+#include "http/clock.hpp"
+
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>          // __get_cpuid()
+#endif
+
+namespace surge::http {
+    namespace {
+        // Long enough that the two clock reads at either end are noise (< 0.01%)
+        constexpr auto CALIBRATION_TIME = std::chrono::milliseconds(20);
+
+        bool invariant_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+            // CPUID 0x80000007 EDX bit 8: invariant TSC
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+                return false;
+            }
+            __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+            return (edx & (1u << 8)) != 0;
+#else
+            return false;
+#endif
+        }
+    }
+
+    void TscClock::init() {
+        static std::once_flag once;
+        std::call_once(once, []() {
+#if defined(__x86_64__) || defined(__i386__)
+            if (!invariant_tsc()) {
+                return;
+            }
+
+            auto wall_start = std::chrono::steady_clock::now();
+            std::uint64_t tsc_start = __rdtsc();
+            std::this_thread::sleep_for(CALIBRATION_TIME);
+            auto wall_end = std::chrono::steady_clock::now();
+            std::uint64_t tsc_end = __rdtsc();
+
+            double micros = std::chrono::duration<double, std::micro>(wall_end - wall_start).count();
+            if (tsc_end <= tsc_start || micros <= 0) {
+                return;
+            }
+            us_per_tick_ = micros / static_cast<double>(tsc_end - tsc_start);
+            use_tsc_ = true;
+#endif
+        });
+    }
+}
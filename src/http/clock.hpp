@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>      // __rdtsc()
+#endif
+
+namespace surge::http {
+
+    // Low overhead timestamps for the request hot path
+    // Reads the TSC when the CPU reports it invariant (constant rate, synchronised
+    // across cores), calibrated against steady_clock once at startup
+    // Falls back to steady_clock nanoseconds anywhere else
+    class TscClock {
+        public:
+            // Detect and calibrate, runs once however often it is called
+            static void init();
+
+            // Current time in ticks, only differences are meaningful
+            static std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+                if (use_tsc_) {
+                    return __rdtsc();
+                }
+#endif
+                return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+            }
+
+            static std::chrono::microseconds to_micros(std::uint64_t ticks) {
+                return std::chrono::microseconds(static_cast<std::int64_t>(static_cast<double>(ticks) * us_per_tick_));
+            }
+
+            static std::chrono::microseconds elapsed(std::uint64_t start, std::uint64_t end) {
+                return to_micros(end > start ? end - start : 0);
+            }
+
+            static bool using_tsc() { return use_tsc_; }
+
+            // Tick rate, 1e9 when falling back to steady_clock
+            static double ticks_per_second() { return 1'000'000.0 / us_per_tick_; }
+
+        private:
+            inline static bool use_tsc_ = false;
+            inline static double us_per_tick_ = 0.001;
+    };
+
+}
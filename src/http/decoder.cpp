@@ -0,0 +1,323 @@
+#include "http/decoder.hpp"
+
+#include <zlib.h>
+
+#ifdef SURGE_HAVE_BROTLI
+#include <brotli/decode.h>
+#endif
+#ifdef SURGE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cctype>           // std::tolower
+
+namespace surge::http {
+    namespace {
+        // Decoded output is written here and dropped
+        constexpr std::size_t SCRATCH_SIZE = 16 * 1024;
+
+        // windowBits: 15 bit window, +32 detects a gzip or zlib header
+        constexpr int ZLIB_AUTO_HEADER = 15 + 32;
+
+        bool equals_ignore_case(std::string_view a, std::string_view b) {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+            });
+        }
+
+        int hex_digit(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+    }
+
+    ContentEncoding parse_content_encoding(std::string_view value) {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+            value.remove_suffix(1);
+        }
+
+        if (value.empty() || equals_ignore_case(value, "identity")) {
+            return ContentEncoding::Identity;
+        }
+        if (equals_ignore_case(value, "gzip") || equals_ignore_case(value, "x-gzip")) {
+            return ContentEncoding::Gzip;
+        }
+        if (equals_ignore_case(value, "deflate")) {
+            return ContentEncoding::Deflate;
+        }
+        if (equals_ignore_case(value, "br")) {
+            return ContentEncoding::Brotli;
+        }
+        if (equals_ignore_case(value, "zstd")) {
+            return ContentEncoding::Zstd;
+        }
+        // Stacked codings ("gzip, br") are not decoded
+        return ContentEncoding::Unsupported;
+    }
+
+    std::string_view supported_encodings() {
+#if defined(SURGE_HAVE_BROTLI) && defined(SURGE_HAVE_ZSTD)
+        return "gzip, deflate, br, zstd";
+#elif defined(SURGE_HAVE_BROTLI)
+        return "gzip, deflate, br";
+#elif defined(SURGE_HAVE_ZSTD)
+        return "gzip, deflate, zstd";
+#else
+        return "gzip, deflate";
+#endif
+    }
+
+    struct Decoder::State {
+        z_stream zlib{};
+        bool zlib_ready = false;
+#ifdef SURGE_HAVE_BROTLI
+        BrotliDecoderState* brotli = nullptr;
+#endif
+#ifdef SURGE_HAVE_ZSTD
+        ZSTD_DStream* zstd = nullptr;
+#endif
+        std::array<unsigned char, SCRATCH_SIZE> scratch{};
+
+        ~State() {
+            if (zlib_ready) {
+                inflateEnd(&zlib);
+            }
+#ifdef SURGE_HAVE_BROTLI
+            if (brotli != nullptr) {
+                BrotliDecoderDestroyInstance(brotli);
+            }
+#endif
+#ifdef SURGE_HAVE_ZSTD
+            if (zstd != nullptr) {
+                ZSTD_freeDStream(zstd);
+            }
+#endif
+        }
+    };
+
+    Decoder::Decoder() : state_(std::make_unique<State>()) {}
+
+    Decoder::~Decoder() = default;
+
+    bool Decoder::begin(ContentEncoding encoding, bool chunked) {
+        encoding_ = encoding;
+        decoded_bytes_ = 0;
+        stream_ended_ = false;
+        chunked_ = chunked;
+        chunk_state_ = ChunkState::Size;
+        chunk_remaining_ = 0;
+        size_digits_ = false;
+        trailer_line_empty_ = true;
+
+        State& state = *state_;
+        switch (encoding) {
+            case ContentEncoding::Identity:
+                return true;
+            case ContentEncoding::Gzip:
+            case ContentEncoding::Deflate:
+                if (!state.zlib_ready) {
+                    state.zlib_ready = inflateInit2(&state.zlib, ZLIB_AUTO_HEADER) == Z_OK;
+                    return state.zlib_ready;
+                }
+                return inflateReset(&state.zlib) == Z_OK;
+#ifdef SURGE_HAVE_BROTLI
+            case ContentEncoding::Brotli:
+                // Brotli has no reset, each body gets a fresh instance
+                if (state.brotli != nullptr) {
+                    BrotliDecoderDestroyInstance(state.brotli);
+                }
+                state.brotli = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+                return state.brotli != nullptr;
+#endif
+#ifdef SURGE_HAVE_ZSTD
+            case ContentEncoding::Zstd:
+                if (state.zstd == nullptr) {
+                    state.zstd = ZSTD_createDStream();
+                }
+                return state.zstd != nullptr && !ZSTD_isError(ZSTD_initDStream(state.zstd));
+#endif
+            default:
+                return false;
+        }
+    }
+
+    bool Decoder::feed(const char* data, std::size_t length) {
+        return chunked_ ? dechunk(data, length) : decode(data, length);
+    }
+
+    bool Decoder::finish() {
+        if (chunked_ && chunk_state_ != ChunkState::Done) {
+            return false;
+        }
+        return encoding_ == ContentEncoding::Identity || stream_ended_;
+    }
+
+    bool Decoder::dechunk(const char* data, std::size_t length) {
+        const char* end = data + length;
+        while (data < end) {
+            char c = *data;
+            switch (chunk_state_) {
+                case ChunkState::Size: {
+                    int digit = hex_digit(c);
+                    if (digit >= 0) {
+                        if (chunk_remaining_ > (UINT64_MAX >> 4)) {
+                            return false;
+                        }
+                        chunk_remaining_ = (chunk_remaining_ << 4) | static_cast<std::uint64_t>(digit);
+                        size_digits_ = true;
+                    } else if (c == ';' || c == ' ' || c == '\t') {
+                        chunk_state_ = ChunkState::Extension;
+                    } else if (c == '\n') {
+                        if (!size_digits_) {
+                            return false;
+                        }
+                        chunk_state_ = chunk_remaining_ == 0 ? ChunkState::Trailer : ChunkState::Data;
+                    } else if (c != '\r') {
+                        return false;
+                    }
+                    ++data;
+                    break;
+                }
+                case ChunkState::Extension:
+                    if (c == '\n') {
+                        if (!size_digits_) {
+                            return false;
+                        }
+                        chunk_state_ = chunk_remaining_ == 0 ? ChunkState::Trailer : ChunkState::Data;
+                    }
+                    ++data;
+                    break;
+                case ChunkState::Data: {
+                    auto take = static_cast<std::size_t>(std::min<std::uint64_t>(chunk_remaining_, end - data));
+                    if (!decode(data, take)) {
+                        return false;
+                    }
+                    data += take;
+                    chunk_remaining_ -= take;
+                    if (chunk_remaining_ == 0) {
+                        chunk_state_ = ChunkState::DataEnd;
+                    }
+                    break;
+                }
+                case ChunkState::DataEnd:
+                    if (c == '\n') {
+                        chunk_state_ = ChunkState::Size;
+                        size_digits_ = false;
+                    } else if (c != '\r') {
+                        return false;
+                    }
+                    ++data;
+                    break;
+                case ChunkState::Trailer:
+                    // Trailer fields until an empty line
+                    if (c == '\n') {
+                        if (trailer_line_empty_) {
+                            chunk_state_ = ChunkState::Done;
+                        }
+                        trailer_line_empty_ = true;
+                    } else if (c != '\r') {
+                        trailer_line_empty_ = false;
+                    }
+                    ++data;
+                    break;
+                case ChunkState::Done:
+                    return true;
+            }
+        }
+        return true;
+    }
+
+    bool Decoder::decode(const char* data, std::size_t length) {
+        State& state = *state_;
+        switch (encoding_) {
+            case ContentEncoding::Identity:
+                decoded_bytes_ += length;
+                return true;
+
+            case ContentEncoding::Gzip:
+            case ContentEncoding::Deflate: {
+                z_stream& zlib = state.zlib;
+                zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+                zlib.avail_in = static_cast<uInt>(length);
+                // A full scratch buffer may leave output pending with no input left
+                do {
+                    // Concatenated gzip members follow one another
+                    if (stream_ended_) {
+                        if (zlib.avail_in == 0) {
+                            break;
+                        }
+                        if (inflateReset(&zlib) != Z_OK) {
+                            return false;
+                        }
+                        stream_ended_ = false;
+                    }
+                    zlib.next_out = state.scratch.data();
+                    zlib.avail_out = static_cast<uInt>(state.scratch.size());
+                    int status = inflate(&zlib, Z_NO_FLUSH);
+                    decoded_bytes_ += state.scratch.size() - zlib.avail_out;
+                    if (status == Z_STREAM_END) {
+                        stream_ended_ = true;
+                    } else if (status == Z_BUF_ERROR) {
+                        break;      // No progress possible until more input
+                    } else if (status != Z_OK) {
+                        return false;
+                    }
+                } while (zlib.avail_in > 0 || zlib.avail_out == 0);
+                return true;
+            }
+
+#ifdef SURGE_HAVE_BROTLI
+            case ContentEncoding::Brotli: {
+                auto* next_in = reinterpret_cast<const std::uint8_t*>(data);
+                std::size_t available_in = length;
+                while (true) {
+                    std::uint8_t* next_out = state.scratch.data();
+                    std::size_t available_out = state.scratch.size();
+                    BrotliDecoderResult status = BrotliDecoderDecompressStream(
+                        state.brotli, &available_in, &next_in, &available_out, &next_out, nullptr);
+                    decoded_bytes_ += state.scratch.size() - available_out;
+                    if (status == BROTLI_DECODER_RESULT_SUCCESS) {
+                        stream_ended_ = true;
+                        return true;
+                    }
+                    if (status == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT) {
+                        return true;
+                    }
+                    if (status != BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) {
+                        return false;
+                    }
+                }
+            }
+#endif
+
+#ifdef SURGE_HAVE_ZSTD
+            case ContentEncoding::Zstd: {
+                ZSTD_inBuffer input{data, length, 0};
+                bool output_full = false;
+                while (input.pos < input.size || output_full) {
+                    ZSTD_outBuffer output{state.scratch.data(), state.scratch.size(), 0};
+                    std::size_t status = ZSTD_decompressStream(state.zstd, &output, &input);
+                    if (ZSTD_isError(status)) {
+                        return false;
+                    }
+                    decoded_bytes_ += output.pos;
+                    stream_ended_ = status == 0;
+                    output_full = output.pos == output.size;
+                }
+                return true;
+            }
+#endif
+
+            default:
+                return false;
+        }
+    }
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace surge::http {
+
+    // Content-Encoding of a response body
+    enum class ContentEncoding : std::uint8_t {
+        Identity,
+        Gzip,
+        Deflate,        // zlib wrapped (RFC 9110)
+        Brotli,
+        Zstd,
+        Unsupported,
+    };
+
+    ContentEncoding parse_content_encoding(std::string_view value);
+
+    // Accept-Encoding value listing what this build can decode, e.g. "gzip, deflate, br"
+    std::string_view supported_encodings();
+
+    // Streaming decoder for one response body at a time: removes chunked framing, then
+    // decompresses. Decoded bytes are counted and dropped into a fixed scratch buffer,
+    // and the zlib / zstd state is reset rather than reallocated between responses
+    class Decoder {
+        public:
+            Decoder();
+            ~Decoder();
+
+            // Disable copy
+            Decoder(const Decoder&) = delete;
+            Decoder& operator=(const Decoder&) = delete;
+
+            // Start a body, false when the encoding is not supported by this build
+            bool begin(ContentEncoding encoding, bool chunked);
+
+            // Feed body bytes as read from the socket, false on corrupt data
+            bool feed(const char* data, std::size_t length);
+
+            // Body ended (connection closed), false if it was cut short
+            bool finish();
+
+            std::uint64_t decoded_bytes() const { return decoded_bytes_; }
+
+        private:
+            struct State;
+
+            bool decode(const char* data, std::size_t length);
+
+            // Chunked framing, body data is passed on to decode()
+            enum class ChunkState : std::uint8_t { Size, Extension, Data, DataEnd, Trailer, Done };
+            bool dechunk(const char* data, std::size_t length);
+
+            std::unique_ptr<State> state_;
+            ContentEncoding encoding_ = ContentEncoding::Identity;
+            std::uint64_t decoded_bytes_ = 0;
+            bool stream_ended_ = false;
+
+            bool chunked_ = false;
+            ChunkState chunk_state_ = ChunkState::Size;
+            std::uint64_t chunk_remaining_ = 0;
+            bool size_digits_ = false;
+            bool trailer_line_empty_ = true;
+    };
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include "http/body_file.hpp"
 
 namespace surge::http {
 
@@ -8,7 +9,8 @@ namespace surge::http {
         std::string url;                // URL
         std::string method = "GET";     // HTTP Method
         std::string body;               // Request body
-
-        // Future: headers, timeout, etc.
+        const BodyFile* body_file = nullptr;    // Body sent from a file with sendfile(), replaces body
+        std::string host;               // Host header override, empty = host from URL
+        std::string headers;            // Extra header lines, each ending "\r\n"
     };
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace surge::http {
+
+    // One metric the server reported for a request, e.g. "db;dur=3.2"
+    struct ServerTiming {
+        std::string_view name;
+        double milliseconds = 0.0;
+    };
+
+    // Outcome of a single request
+    // Slim and non-owning: the body is never kept, and error points at a
+    // static string, so producing a Result never allocates
+    struct Result {
+        // HTTP Status Code, 200, 400 etc.
+        std::uint16_t status_code = 0;
+
+        // How long the request took
+        std::chrono::microseconds latency{0};
+
+        // Was a connection attempted / established for this request
+        bool connect_attempted = false;
+        bool connected = false;
+
+        // Time to establish the connection
+        std::chrono::microseconds connect_time{0};
+
+        // Ephemeral port of the connection, only with SocketOptions::local_port
+        std::uint16_t local_port = 0;
+
+        // Did we get a valid response
+        bool success = false;
+
+        // Time to the first response byte (latency is time to the last, the server closes)
+        std::chrono::microseconds first_byte{0};
+
+        // Bytes on the wire for this request, head and body
+        std::uint64_t bytes_sent = 0;
+        std::uint64_t bytes_received = 0;
+
+        // Kernel software timestamps (SO_TIMESTAMPING), only when timestamped
+        // network_time: request's last byte sent by the kernel -> response's first byte received by it
+        // read_delay: response's first byte received by the kernel -> read by the generator
+        bool timestamped = false;
+        std::chrono::microseconds network_time{0};
+        std::chrono::microseconds read_delay{0};
+
+        // Body decoding (ReceiveOptions::decompress): body bytes as received, after removing
+        // chunked framing and compression, and the time spent decoding (not part of latency)
+        bool compressed = false;
+        std::uint64_t body_wire_bytes = 0;
+        std::uint64_t body_decoded_bytes = 0;
+        std::chrono::microseconds decode_time{0};
+
+        // If didnt succeed, static error description
+        const char* error = nullptr;
+
+        // Server-Timing metrics and the configured response time header, in header order
+        // Names view into the client's receive buffer, valid until its next execute()
+        static constexpr std::size_t MAX_SERVER_TIMINGS = 8;
+        std::array<ServerTiming, MAX_SERVER_TIMINGS> server_timings{};
+        std::size_t server_timing_count = 0;
+
+        // Server's own total: the response time header, else a "total" metric,
+        // else the sum of all metrics; negative when the server reported nothing
+        double server_time_ms = -1.0;
+    };
+
+}
@@ -0,0 +1,166 @@
+#include "http/socket.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>    // TCP_NODELAY, TCP_QUICKACK, TCP_FASTOPEN_CONNECT
+#include <linux/net_tstamp.h>   // SOF_TIMESTAMPING_*
+#include <arpa/inet.h>      // inet_pton(), ntohl()
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace surge::http {
+    namespace {
+        bool parse_address(std::string_view text, in_addr& out) {
+            std::string address(text);
+            return inet_pton(AF_INET, address.c_str(), &out) == 1;
+        }
+
+        void set_int_option(int sock, int level, int name, int value) {
+            setsockopt(sock, level, name, &value, sizeof(value));
+        }
+    }
+
+    std::optional<std::vector<in_addr>> SourceAddressPool::parse(std::string_view spec) {
+        std::vector<in_addr> addresses;
+
+        while (!spec.empty()) {
+            size_t comma = spec.find(',');
+            std::string_view item = spec.substr(0, comma);
+            spec = comma == std::string_view::npos ? std::string_view{} : spec.substr(comma + 1);
+
+            size_t dash = item.find('-');
+            in_addr first{};
+            if (!parse_address(item.substr(0, dash), first)) {
+                return std::nullopt;
+            }
+
+            if (dash == std::string_view::npos) {
+                addresses.push_back(first);
+                continue;
+            }
+
+            // Inclusive range, host order for the arithmetic
+            in_addr last{};
+            if (!parse_address(item.substr(dash + 1), last)) {
+                return std::nullopt;
+            }
+            std::uint32_t from = ntohl(first.s_addr);
+            std::uint32_t to = ntohl(last.s_addr);
+            if (to < from || to - from > 65535) {
+                return std::nullopt;
+            }
+            for (std::uint32_t address = from; address <= to; ++address) {
+                in_addr next{};
+                next.s_addr = htonl(address);
+                addresses.push_back(next);
+            }
+        }
+
+        if (addresses.empty()) {
+            return std::nullopt;
+        }
+        return addresses;
+    }
+
+    SourceAddressPool::SourceAddressPool(std::vector<in_addr> addresses)
+        : addresses_(std::move(addresses))
+    {}
+
+    const in_addr& SourceAddressPool::next() {
+        return addresses_[next_.fetch_add(1, std::memory_order_relaxed) % addresses_.size()];
+    }
+
+    int create_socket(int family, const SocketOptions& options, bool non_blocking) {
+        int type = SOCK_STREAM | SOCK_CLOEXEC | (non_blocking ? SOCK_NONBLOCK : 0);
+        int sock = socket(family, type, 0);
+        if (sock < 0) {
+            return -1;
+        }
+
+        if (options.send_buffer > 0) {
+            set_int_option(sock, SOL_SOCKET, SO_SNDBUF, options.send_buffer);
+        }
+        if (options.receive_buffer > 0) {
+            set_int_option(sock, SOL_SOCKET, SO_RCVBUF, options.receive_buffer);
+        }
+
+        if (family != AF_INET) {
+            return sock;
+        }
+
+        if (options.tcp_nodelay) {
+            set_int_option(sock, IPPROTO_TCP, TCP_NODELAY, 1);
+        }
+        if (options.fast_open) {
+            set_int_option(sock, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1);
+        }
+        if (options.linger_reset) {
+            linger reset{1, 0};
+            setsockopt(sock, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+        }
+        if (options.kernel_timestamps) {
+            // TX stamps come back on the error queue without payload (OPT_TSONLY)
+            set_int_option(sock, SOL_SOCKET, SO_TIMESTAMPING,
+                SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE |
+                SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_OPT_TSONLY);
+        }
+
+        if (options.source_addresses != nullptr) {
+            // Defer port choice to connect() so the 4-tuple, not the local port alone, must be unique
+            set_int_option(sock, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, 1);
+
+            sockaddr_in local{};
+            local.sin_family = AF_INET;
+            local.sin_addr = options.source_addresses->next();
+            local.sin_port = 0;
+            if (bind(sock, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+                int saved = errno;
+                close(sock);
+                errno = saved;
+                return -1;
+            }
+        }
+
+        return sock;
+    }
+
+    void apply_connected_options(int sock, int family, const SocketOptions& options) {
+        // Quick ack mode is not sticky, the kernel may leave it after each ack
+        if (family == AF_INET && options.quickack) {
+            set_int_option(sock, IPPROTO_TCP, TCP_QUICKACK, 1);
+        }
+    }
+
+    std::uint64_t count_time_wait_sockets() {
+        constexpr std::string_view TIME_WAIT_STATE = "06";
+        std::uint64_t count = 0;
+
+        for (const char* path : {"/proc/net/tcp", "/proc/net/tcp6"}) {
+            std::ifstream file(path);
+            std::string line;
+            std::getline(file, line);  // Header
+
+            // "sl local_address rem_address st ...", state is the 4th column
+            while (std::getline(file, line)) {
+                std::string_view rest(line);
+                for (int column = 0; column < 3; ++column) {
+                    size_t start = rest.find_first_not_of(' ');
+                    size_t end = rest.find(' ', start);
+                    rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end);
+                }
+                size_t start = rest.find_first_not_of(' ');
+                if (start != std::string_view::npos && rest.substr(start, 2) == TIME_WAIT_STATE) {
+                    count++;
+                }
+            }
+        }
+
+        return count;
+    }
+
+}
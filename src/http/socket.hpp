@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <netinet/in.h>
+
+namespace surge::http {
+
+    // Local IPv4 addresses that outgoing connections are spread across
+    // Each source address has its own ephemeral port range towards a destination,
+    // so N addresses give roughly N x 28k concurrent / TIME_WAIT connections
+    class SourceAddressPool {
+        public:
+            // "127.0.0.2-127.0.0.50", "10.0.0.1,10.0.0.2" or a mix, nullopt if invalid
+            static std::optional<std::vector<in_addr>> parse(std::string_view spec);
+
+            explicit SourceAddressPool(std::vector<in_addr> addresses);
+
+            // Disable copy
+            SourceAddressPool(const SourceAddressPool&) = delete;
+            SourceAddressPool& operator=(const SourceAddressPool&) = delete;
+
+            // Round robin across all callers
+            const in_addr& next();
+
+            std::size_t size() const { return addresses_.size(); }
+
+        private:
+            std::vector<in_addr> addresses_;
+            std::atomic<std::size_t> next_{0};
+    };
+
+    // Options applied to every outgoing socket
+    struct SocketOptions {
+        bool tcp_nodelay = false;       // TCP_NODELAY, disable Nagle
+        int send_buffer = 0;            // SO_SNDBUF bytes, 0 = kernel default
+        int receive_buffer = 0;         // SO_RCVBUF bytes, 0 = kernel default
+        bool quickack = false;          // TCP_QUICKACK, ack immediately
+        bool fast_open = false;         // TCP_FASTOPEN_CONNECT, data in the SYN when a cookie is cached
+        bool linger_reset = false;      // SO_LINGER 0, close() sends RST and skips TIME_WAIT
+        bool kernel_timestamps = false; // SO_TIMESTAMPING software TX/RX stamps (TCP only)
+        bool local_port = false;        // getsockname() after connect into Result::local_port (TCP only)
+
+        // Bind to pooled local addresses (IP_BIND_ADDRESS_NO_PORT), nullptr = kernel choice
+        SourceAddressPool* source_addresses = nullptr;
+    };
+
+    // Create a stream socket (AF_INET or AF_UNIX) with options applied
+    // TCP sockets are bound to the next source address, TCP only options are skipped for AF_UNIX
+    // Returns -1 (errno set) on failure
+    int create_socket(int family, const SocketOptions& options, bool non_blocking = false);
+
+    // Options that must be (re)applied on a connected socket
+    void apply_connected_options(int sock, int family, const SocketOptions& options);
+
+    // Sockets currently in TIME_WAIT (from /proc/net/tcp and tcp6), 0 if unavailable
+    std::uint64_t count_time_wait_sockets();
+
+}
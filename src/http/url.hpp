@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string_view>
+
+namespace surge::http {
+
+    // Scheme prefix for Unix domain socket targets: http+unix:///run/app.sock:/path
+    inline constexpr std::string_view UNIX_SCHEME = "http+unix://";
+
+    inline bool is_unix_url(std::string_view url) {
+        return url.starts_with(UNIX_SCHEME);
+    }
+
+    // Everything before the request path, so that url_base(url) + url_path(url) == url
+    // "http://host:port/path"              -> "http://host:port"
+    // "http+unix:///run/app.sock:/path"    -> "http+unix:///run/app.sock:"
+    inline std::string_view url_base(std::string_view url) {
+        if (is_unix_url(url)) {
+            size_t separator = url.find(":/", UNIX_SCHEME.size());
+            return separator == std::string_view::npos ? url : url.substr(0, separator + 1);
+        }
+        size_t host_start = url.find("://");
+        host_start = host_start == std::string_view::npos ? 0 : host_start + 3;
+        return url.substr(0, url.find('/', host_start));
+    }
+
+    // Request path of a URL, "/" when there is none
+    inline std::string_view url_path(std::string_view url) {
+        std::string_view base = url_base(url);
+        return base.size() == url.size() ? std::string_view("/") : url.substr(base.size());
+    }
+
+}
@@ -0,0 +1,240 @@
+#include "http/websocket.hpp"
+
+#include <sys/socket.h>     // send(), recv()
+#include <sys/uio.h>        // writev()
+#include <unistd.h>         // close()
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>          // IOV_MAX
+#include <cstring>          // memcpy()
+#include <vector>
+
+namespace surge::http {
+    namespace {
+        constexpr std::size_t RECEIVE_BUFFER_SIZE = 64 * 1024;
+
+        // Most frames written by one send() call
+        constexpr std::size_t MAX_BATCH = 64;
+
+        constexpr std::uint8_t FIN = 0x80;
+        constexpr std::uint8_t MASKED = 0x80;
+        constexpr std::uint16_t CLOSE_NORMAL = 1000;
+
+        // Frame header: FIN + opcode, masked length (7, 16 or 64 bit), masking key
+        void append_header(std::string& out, Opcode opcode, std::uint64_t length, std::uint32_t mask_key) {
+            out.push_back(static_cast<char>(FIN | static_cast<std::uint8_t>(opcode)));
+            if (length < 126) {
+                out.push_back(static_cast<char>(MASKED | length));
+            } else if (length <= UINT16_MAX) {
+                out.push_back(static_cast<char>(MASKED | 126));
+                out.push_back(static_cast<char>(length >> 8));
+                out.push_back(static_cast<char>(length));
+            } else {
+                out.push_back(static_cast<char>(MASKED | 127));
+                for (int shift = 56; shift >= 0; shift -= 8) {
+                    out.push_back(static_cast<char>(length >> shift));
+                }
+            }
+            char key[4];
+            memcpy(key, &mask_key, sizeof(key));
+            out.append(key, sizeof(key));
+        }
+
+        // Masked frame carrying payload
+        std::string build_frame(Opcode opcode, std::string_view payload, std::uint32_t mask_key) {
+            std::string frame;
+            frame.reserve(payload.size() + 14);
+            append_header(frame, opcode, payload.size(), mask_key);
+            std::size_t payload_at = frame.size();
+            frame.append(payload);
+            mask_payload(frame.data() + payload_at, payload.size(), mask_key);
+            return frame;
+        }
+
+        bool send_all(int sock, std::string_view data) {
+            while (!data.empty()) {
+                ssize_t sent = ::send(sock, data.data(), data.size(), MSG_NOSIGNAL);
+                if (sent < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                data.remove_prefix(static_cast<size_t>(sent));
+            }
+            return true;
+        }
+    }
+
+    void mask_payload(char* data, std::size_t length, std::uint32_t key) {
+        // The key bytes in memory order repeat every 4 bytes, so one 64 bit word covers two periods
+        std::uint64_t wide = (std::uint64_t{key} << 32) | key;
+        std::size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            std::uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            word ^= wide;
+            memcpy(data + i, &word, sizeof(word));
+        }
+
+        char key_bytes[4];
+        memcpy(key_bytes, &key, sizeof(key_bytes));
+        for (; i < length; ++i) {
+            data[i] ^= key_bytes[i % 4];
+        }
+    }
+
+    WebSocket::WebSocket(int sock, std::string_view leftover)
+        : sock_(sock)
+        , buffer_(std::max(RECEIVE_BUFFER_SIZE, leftover.size()))
+    {
+        std::copy(leftover.begin(), leftover.end(), buffer_.begin());
+        end_ = leftover.size();
+    }
+
+    WebSocket::~WebSocket() {
+        if (sock_ < 0) {
+            return;
+        }
+        char code[2] = {static_cast<char>(CLOSE_NORMAL >> 8), static_cast<char>(CLOSE_NORMAL & 0xff)};
+        send_all(sock_, build_frame(Opcode::Close, std::string_view(code, sizeof(code)), mask_key_));
+        close(sock_);
+    }
+
+    void WebSocket::prepare(Opcode opcode, std::string_view payload, std::uint32_t mask_key) {
+        mask_key_ = mask_key;
+        frame_ = build_frame(opcode, payload, mask_key);
+        reply_opcode_ = opcode == Opcode::Ping ? Opcode::Pong : opcode;
+    }
+
+    // Several frames go out as one writev() of the same buffer
+    bool WebSocket::send(std::size_t count) {
+        iovec parts[MAX_BATCH];
+        while (count > 0) {
+            std::size_t batch = std::min({count, MAX_BATCH, static_cast<std::size_t>(IOV_MAX)});
+            for (std::size_t i = 0; i < batch; ++i) {
+                parts[i] = {frame_.data(), frame_.size()};
+            }
+
+            iovec* next = parts;
+            std::size_t remaining = batch;
+            while (remaining > 0) {
+                msghdr message{};
+                message.msg_iov = next;
+                message.msg_iovlen = remaining;
+                ssize_t bytes_sent = sendmsg(sock_, &message, MSG_NOSIGNAL);
+                if (bytes_sent < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+
+                auto sent = static_cast<std::size_t>(bytes_sent);
+                while (remaining > 0 && sent >= next->iov_len) {
+                    sent -= next->iov_len;
+                    ++next;
+                    --remaining;
+                }
+                if (remaining > 0) {
+                    next->iov_base = static_cast<char*>(next->iov_base) + sent;
+                    next->iov_len -= sent;
+                }
+            }
+            count -= batch;
+        }
+        return true;
+    }
+
+    bool WebSocket::send_pong(std::string_view payload) {
+        return send_all(sock_, build_frame(Opcode::Pong, payload, mask_key_));
+    }
+
+    bool WebSocket::receive(std::size_t& replies, std::uint64_t& bytes) {
+        replies = 0;
+        bytes = 0;
+
+        // Read everything the socket has
+        bool closed = false;
+        while (true) {
+            if (end_ == buffer_.size()) {
+                if (start_ > 0) {
+                    std::copy(buffer_.begin() + static_cast<std::ptrdiff_t>(start_),
+                              buffer_.begin() + static_cast<std::ptrdiff_t>(end_), buffer_.begin());
+                    end_ -= start_;
+                    start_ = 0;
+                } else {
+                    buffer_.resize(buffer_.size() * 2);
+                }
+            }
+            ssize_t received = recv(sock_, buffer_.data() + end_, buffer_.size() - end_, MSG_DONTWAIT);
+            if (received > 0) {
+                end_ += static_cast<std::size_t>(received);
+                bytes += static_cast<std::uint64_t>(received);
+                continue;
+            }
+            if (received == 0) {
+                closed = true;
+            } else if (errno == EINTR) {
+                continue;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+            break;
+        }
+
+        // Parse complete frames, server frames are not masked
+        while (end_ - start_ >= 2) {
+            const auto* frame = reinterpret_cast<const std::uint8_t*>(buffer_.data() + start_);
+            std::size_t available = end_ - start_;
+            bool fin = (frame[0] & FIN) != 0;
+            auto opcode = static_cast<Opcode>(frame[0] & 0x0f);
+
+            std::size_t header = 2;
+            std::uint64_t length = frame[1] & 0x7f;
+            if (length == 126) {
+                header = 4;
+                if (available < header) {
+                    break;
+                }
+                length = (std::uint64_t{frame[2]} << 8) | frame[3];
+            } else if (length == 127) {
+                header = 10;
+                if (available < header) {
+                    break;
+                }
+                length = 0;
+                for (std::size_t i = 2; i < 10; ++i) {
+                    length = (length << 8) | frame[i];
+                }
+            }
+            if ((frame[1] & MASKED) != 0) {
+                header += 4;
+            }
+            if (available < header || available - header < length) {
+                break;
+            }
+
+            std::string_view payload(buffer_.data() + start_ + header, static_cast<std::size_t>(length));
+            if (opcode == Opcode::Close) {
+                return false;
+            }
+            if (opcode == Opcode::Ping && !send_pong(payload)) {
+                return false;
+            }
+            // A fragmented echo counts once, on its final frame
+            if (fin && (opcode == reply_opcode_ || (opcode == Opcode::Continuation && reply_opcode_ != Opcode::Pong))) {
+                ++replies;
+            }
+            start_ += header + static_cast<std::size_t>(length);
+        }
+
+        if (start_ == end_) {
+            start_ = 0;
+            end_ = 0;
+        }
+        return !closed;
+    }
+
+}
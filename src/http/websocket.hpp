@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace surge::http {
+
+    // RFC 6455 opcodes
+    enum class Opcode : std::uint8_t {
+        Continuation = 0x0,
+        Text = 0x1,
+        Binary = 0x2,
+        Close = 0x8,
+        Ping = 0x9,
+        Pong = 0xA,
+    };
+
+    // XOR data with a 4 byte masking key, 8 bytes per step (the loop vectorises)
+    void mask_payload(char* data, std::size_t length, std::uint32_t key);
+
+    // Client end of an upgraded connection (see Client::upgrade)
+    // The outgoing frame is built and masked once in prepare(), every send writes
+    // the same bytes, so sending costs no framing or masking work
+    class WebSocket {
+        public:
+            // Takes ownership of sock, leftover = bytes read past the handshake
+            WebSocket(int sock, std::string_view leftover);
+
+            // Sends a close frame and closes the socket
+            ~WebSocket();
+
+            // Disable copy
+            WebSocket(const WebSocket&) = delete;
+            WebSocket& operator=(const WebSocket&) = delete;
+
+            int fd() const { return sock_; }
+
+            // Build the frame send() writes, Ping frames are answered by Pong, data frames by an echo
+            void prepare(Opcode opcode, std::string_view payload, std::uint32_t mask_key);
+
+            std::size_t frame_size() const { return frame_.size(); }
+
+            // Write the prepared frame count times in one call, false on error
+            bool send(std::size_t count = 1);
+
+            // Read what is available without blocking and count the complete replies
+            // False when the server closed the connection or it failed
+            bool receive(std::size_t& replies, std::uint64_t& bytes);
+
+        private:
+            // Answer a server ping, false on error
+            bool send_pong(std::string_view payload);
+
+            int sock_ = -1;
+            std::string frame_;
+            Opcode reply_opcode_ = Opcode::Binary;
+            std::uint32_t mask_key_ = 0;
+
+            // Received bytes not yet parsed into frames are [start_, end_)
+            std::vector<char> buffer_;
+            std::size_t start_ = 0;
+            std::size_t end_ = 0;
+    };
+
+}
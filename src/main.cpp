@@ -1,23 +1,156 @@
+#include <csignal>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 #include "cli/config.hpp"
 #include "cli/parser.hpp"
+#include "cli/signals.hpp"
 #include "core/engine.hpp"
+#include "core/hold.hpp"
+#include "core/sweep.hpp"
+#include "http/clock.hpp"
+#include "output/baseline.hpp"
+#include "output/metrics_server.hpp"
 #include "output/reporter.hpp"  // Add this
+#include "output/soak_log.hpp"
+#include "output/trace_export.hpp"
 
 int main(int argc, char* argv[]) {
     std::vector<std::string> args(argv, argv + argc);
+
+    // A server closing mid-upload must fail the request, not kill the process (sendfile has no MSG_NOSIGNAL)
+    std::signal(SIGPIPE, SIG_IGN);
     
     // Parse CLI arguments
     surge::cli::Config config;
     if (!surge::cli::parse_arguments(args, config)) {
         return 1;
     }
+
+    // Offline report from a soak log, no load is generated
+    if (!config.soak_report_file.empty()) {
+        double to = config.soak_to > 0 ? config.soak_to : std::numeric_limits<double>::infinity();
+        auto results = surge::output::SoakLog::load(config.soak_report_file, config.soak_from, to);
+        if (!results) {
+            return 1;
+        }
+        surge::output::Reporter::print_coloured(*results);
+        return 0;
+    }
     
+    // Connection capacity mode, its own event loops instead of the engine
+    if (config.hold_connections > 0) {
+        surge::http::TscClock::init();
+        surge::core::HoldTest hold(config);
+        if (!hold.prepare()) {
+            return 1;
+        }
+        std::cout << "\nHolding connections:\n";
+        std::cout << "  URL:         " << config.url << "\n";
+        std::cout << "  Connections: " << config.hold_connections;
+        if (config.hold_rate > 0) {
+            std::cout << " (" << config.hold_rate << "/s)";
+        }
+        std::cout << "\n";
+        if (config.hold_interval > 0) {
+            std::cout << "  Requests:    every " << config.hold_interval << "s per connection\n";
+        }
+        if (config.duration_seconds > 0) {
+            std::cout << "  Duration:    " << config.duration_seconds << "s\n";
+        }
+        std::cout << "\n";
+
+        surge::cli::StopSignals stop_signals([&hold]() {
+            hold.stop();
+        });
+        hold.on_sample(surge::output::Reporter::print_hold_sample);
+        surge::core::HoldResults results = hold.run();
+
+        surge::output::Reporter::print_coloured(results.results);
+        surge::output::Reporter::print_hold(results);
+        return results.results.interrupted ? 130 : 0;
+    }
+
+    // Parameter sweep, one run per combination in this process
+    if (!config.sweep_concurrency.empty() || !config.sweep_body_sizes.empty()) {
+        surge::http::TscClock::init();
+        surge::core::Sweep sweep(config);
+        std::size_t total = sweep.cells().size();
+
+        std::cout << "\nStarting sweep:\n";
+        std::cout << "  URL:         " << config.url << "\n";
+        std::cout << "  Cells:       " << total << " (" << config.sweep_cooldown << "s cooldown)\n";
+        if (config.requests > 0) {
+            std::cout << "  Requests:    " << config.requests << " per cell\n";
+        }
+        if (config.duration_seconds > 0) {
+            std::cout << "  Duration:    " << config.duration_seconds << "s per cell\n";
+        }
+        std::cout << "\n";
+
+        surge::cli::StopSignals stop_signals([&sweep]() {
+            sweep.stop();
+        });
+        sweep.on_cell([total](const surge::core::SweepCell& cell, std::size_t index) {
+            surge::output::Reporter::print_sweep_cell(cell, index, total);
+        });
+        std::vector<surge::core::SweepCell> cells = sweep.run();
+
+        surge::output::Reporter::print_sweep(cells);
+        if (!config.sweep_json.empty()) {
+            if (!surge::output::Reporter::save_sweep_json(cells, config.url, config.sweep_json)) {
+                return 1;
+            }
+            std::cout << "Sweep results saved to " << config.sweep_json << "\n";
+        }
+        if (sweep.interrupted()) {
+            return 130;
+        }
+        return cells.size() < total ? 1 : 0;
+    }
+
     std::cout << "\nStarting load test:\n";
     std::cout << "  URL:         " << config.url << "\n";
+    if (config.targets.size() > 1) {
+        std::cout << "  Backends:    " << config.targets.size() << " (" << config.balance_policy << ")\n";
+    }
     std::cout << "  Concurrency: " << config.concurrency << "\n";
+
+    surge::http::TscClock::init();
+    if (surge::http::TscClock::using_tsc()) {
+        std::cout << "  Clock:       TSC (" << std::fixed << std::setprecision(2)
+                  << surge::http::TscClock::ticks_per_second() / 1e9 << " GHz)\n";
+        std::cout.unsetf(std::ios::fixed);
+    } else {
+        std::cout << "  Clock:       steady_clock (no invariant TSC)\n";
+    }
+    if (!config.body_file.empty()) {
+        std::cout << "  Body:        " << config.body_file << " (" << config.method.value_or("GET") << ")\n";
+    }
+
+    if (config.websocket) {
+        std::cout << "  WebSocket:   " << config.concurrency << " connections, ";
+        if (config.ws_rate > 0) {
+            std::cout << config.ws_rate << " msg/s each";
+        } else {
+            std::cout << "ping-pong";
+        }
+        std::cout << (config.ws_ping ? " (ping frames)" : "") << "\n";
+    }
+
+    if (config.warmup_auto) {
+        std::cout << "  Warmup:      auto (max " << config.warmup_max_seconds << "s)\n";
+    } else if (config.warmup_seconds > 0) {
+        std::cout << "  Warmup:      " << config.warmup_seconds << "s\n";
+    } else if (config.warmup_requests > 0) {
+        std::cout << "  Warmup:      " << config.warmup_requests << " requests\n";
+    }
+    if (!config.replay_file.empty()) {
+        std::cout << "  Replay:      " << config.replay_file << " (x" << config.replay_speed << ")\n";
+    }
     
     if (config.requests > 0) {
         std::cout << "  Requests:    " << config.requests << "\n";
@@ -30,10 +163,102 @@ int main(int argc, char* argv[]) {
     
     // Create and run engine
     surge::core::Engine engine(config);
+    if (!engine.prepare()) {
+        return 1;
+    }
+
+    // Ctrl-C / SIGTERM end the run early, the partial results are still reported
+    // Set up before the metrics server and workers start their threads
+    surge::cli::StopSignals stop_signals([&engine]() {
+        engine.stop();
+    });
+
+    // Optional live metrics endpoint, scrapes read the engine's collector
+    std::unique_ptr<surge::output::MetricsServer> metrics_server;
+    if (config.metrics_port > 0) {
+        metrics_server = std::make_unique<surge::output::MetricsServer>(config.metrics_port, engine.collector());
+        if (!metrics_server->start()) {
+            return 1;
+        }
+        std::cout << "Serving metrics on port " << config.metrics_port << "\n\n";
+    }
+
+    // Optional soak log, one interval histogram every soak_interval seconds
+    std::unique_ptr<surge::output::SoakLog> soak_log;
+    if (!config.soak_log.empty()) {
+        soak_log = std::make_unique<surge::output::SoakLog>(
+            config.soak_log, std::chrono::seconds(config.soak_interval), engine.collector(), config.url);
+        if (!soak_log->start()) {
+            return 1;
+        }
+        std::cout << "Writing soak log to " << config.soak_log << " every " << config.soak_interval << "s\n\n";
+    }
+
     surge::core::Results results = engine.run();
+
+    if (metrics_server) {
+        metrics_server->stop();
+    }
+    if (soak_log) {
+        soak_log->finish();
+    }
     
     // Print results with colors!
     surge::output::Reporter::print_coloured(results);
-    
-    return 0;
+
+    // Exemplar trace, also for an interrupted run
+    if (!config.trace_file.empty()) {
+        surge::output::TraceFormat format = surge::output::TraceFormat::Chrome;
+        surge::output::parse_trace_format(config.trace_format, format);
+        if (!surge::output::write_trace(config.trace_file, format, results.exemplars)) {
+            return 1;
+        }
+        std::cout << "Wrote " << results.exemplars.size() << " exemplar requests to " << config.trace_file;
+        if (config.exemplar_threshold_ms > 0.0) {
+            std::cout << " (" << results.exemplar_threshold_requests << " at or above "
+                      << config.exemplar_threshold_ms << "ms)";
+        }
+        std::cout << "\n";
+    }
+
+    // Compare against a saved baseline (before overwriting it, if both point at one file)
+    int exit_code = 0;
+    if (!config.compare_file.empty()) {
+        auto baseline = surge::output::Baseline::load(config.compare_file);
+        if (!baseline) {
+            return 1;
+        }
+
+        surge::stats::RegressionThresholds thresholds{
+            .max_latency_increase_percent = config.max_latency_regression,
+            .max_throughput_drop_percent = config.max_throughput_drop,
+            .max_error_rate_increase = config.max_error_increase,
+            .alpha = config.significance,
+        };
+
+        surge::stats::Comparison comparison = surge::stats::compare(
+            *baseline, surge::output::Baseline::summarize(results), thresholds);
+        surge::output::Reporter::print_comparison(comparison);
+
+        if (comparison.regression()) {
+            exit_code = 2;
+        }
+    }
+
+    // A partial run is not a baseline
+    if (results.interrupted) {
+        if (!config.save_baseline_file.empty()) {
+            std::cout << "Run interrupted, baseline not saved\n";
+        }
+        return 130;
+    }
+
+    if (!config.save_baseline_file.empty()) {
+        if (!surge::output::Baseline::save(results, config.url, config.save_baseline_file)) {
+            return 1;
+        }
+        std::cout << "Baseline saved to " << config.save_baseline_file << "\n";
+    }
+
+    return exit_code;
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "output/baseline.hpp"
+#include "output/json.hpp"
+#include "stats/histogram.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace surge::output {
+    namespace {
+        constexpr int FORMAT_VERSION = 1;
+    }
+
+    stats::RunSummary Baseline::summarize(const core::Results& results) {
+        stats::RunSummary summary;
+        summary.total_requests = results.metrics.total_requests;
+        summary.successful_requests = results.metrics.successful_requests;
+        summary.failed_requests = results.metrics.failed_requests;
+        summary.requests_per_second = results.requests_per_second;
+        summary.latency_histogram = results.metrics.latency_histogram;
+        return summary;
+    }
+
+    bool Baseline::save(const core::Results& results, const std::string& url, const std::string& filepath) {
+        std::ofstream file(filepath);
+
+        if (!file.is_open()) {
+            std::cerr << "Error: could not open file to write: " << filepath << "\n";
+            return false;
+        }
+
+        const auto& m = results.metrics;
+        const auto& p = results.percentiles;
+        const auto& h = m.latency_histogram;
+
+        file << "{\n";
+        file << "  \"version\": " << FORMAT_VERSION << ",\n";
+        file << "  \"url\": \"" << json::escape(url) << "\",\n";
+        file << "  \"duration_us\": " << results.duration.count() << ",\n";
+        file << "  \"total_requests\": " << m.total_requests << ",\n";
+        file << "  \"successful_requests\": " << m.successful_requests << ",\n";
+        file << "  \"failed_requests\": " << m.failed_requests << ",\n";
+        file << "  \"requests_per_second\": " << results.requests_per_second << ",\n";
+        file << "  \"percentiles_us\": {\"p50\": " << p.p50 << ", \"p75\": " << p.p75 << ", \"p90\": " << p.p90
+             << ", \"p95\": " << p.p95 << ", \"p99\": " << p.p99 << ", \"p99.9\": " << p.p999 << "},\n";
+
+        // Sparse histogram: [bucket index, count] pairs for non-empty buckets
+        file << "  \"histogram\": {\n";
+        file << "    \"sub_bucket_bits\": " << stats::Histogram::SUB_BUCKET_BITS << ",\n";
+        file << "    \"buckets\": [";
+        bool first = true;
+        for (std::size_t i = 0; i < stats::Histogram::BUCKET_COUNT; ++i) {
+            if (h.count_at(i) == 0) {
+                continue;
+            }
+            file << (first ? "" : ", ") << "[" << i << ", " << h.count_at(i) << "]";
+            first = false;
+        }
+        file << "]\n";
+        file << "  }\n";
+        file << "}\n";
+
+        return file.good();
+    }
+
+    std::optional<stats::RunSummary> Baseline::load(const std::string& filepath) {
+        std::ifstream file(filepath);
+
+        if (!file.is_open()) {
+            std::cerr << "Error: could not open baseline: " << filepath << "\n";
+            return std::nullopt;
+        }
+
+        std::ostringstream contents;
+        contents << file.rdbuf();
+
+        std::optional<json::Value> document = json::parse(contents.str());
+        if (!document || document->type != json::Value::Type::Object) {
+            std::cerr << "Error: baseline is not valid JSON: " << filepath << "\n";
+            return std::nullopt;
+        }
+
+        if (document->number_or("version", 0) != FORMAT_VERSION) {
+            std::cerr << "Error: unsupported baseline version in " << filepath << "\n";
+            return std::nullopt;
+        }
+
+        const json::Value* histogram = document->find("histogram");
+        if (histogram == nullptr ||
+            histogram->number_or("sub_bucket_bits", 0) != static_cast<double>(stats::Histogram::SUB_BUCKET_BITS)) {
+            std::cerr << "Error: baseline histogram missing or incompatible in " << filepath << "\n";
+            return std::nullopt;
+        }
+
+        stats::RunSummary summary;
+        summary.total_requests = static_cast<std::uint64_t>(document->number_or("total_requests", 0));
+        summary.successful_requests = static_cast<std::uint64_t>(document->number_or("successful_requests", 0));
+        summary.failed_requests = static_cast<std::uint64_t>(document->number_or("failed_requests", 0));
+        summary.requests_per_second = document->number_or("requests_per_second", 0);
+
+        const json::Value* buckets = histogram->find("buckets");
+        if (buckets == nullptr || buckets->type != json::Value::Type::Array) {
+            std::cerr << "Error: baseline histogram has no buckets in " << filepath << "\n";
+            return std::nullopt;
+        }
+
+        for (const json::Value& bucket : buckets->array) {
+            if (bucket.type != json::Value::Type::Array || bucket.array.size() != 2 ||
+                bucket.array[0].number < 0 || bucket.array[0].number >= stats::Histogram::BUCKET_COUNT) {
+                std::cerr << "Error: malformed histogram bucket in " << filepath << "\n";
+                return std::nullopt;
+            }
+            summary.latency_histogram.set_count_at(static_cast<std::size_t>(bucket.array[0].number),
+                                                   static_cast<std::uint64_t>(bucket.array[1].number));
+        }
+
+        return summary;
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include "core/engine.hpp"
+#include "stats/comparison.hpp"
+
+namespace surge::output {
+    // Persist run summaries (with the full latency histogram) as JSON baselines
+    class Baseline {
+        public:
+            // Summary of a finished run
+            static stats::RunSummary summarize(const core::Results& results);
+
+            // Write results to filepath, false on IO error
+            static bool save(const core::Results& results, const std::string& url, const std::string& filepath);
+
+            // Read a baseline written by save(), nullopt (with message) on error
+            static std::optional<stats::RunSummary> load(const std::string& filepath);
+    };
+}
@@ -0,0 +1,253 @@
+#include "output/json.hpp"
+#include <charconv>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace surge::output::json {
+    namespace {
+        // Recursive descent parser over a string_view
+        class Parser {
+            public:
+                explicit Parser(std::string_view text) : text_(text) {}
+
+                std::optional<Value> parse_document() {
+                    Value value;
+                    if (!parse_value(value, 0)) {
+                        return std::nullopt;
+                    }
+                    skip_whitespace();
+                    if (pos_ != text_.size()) {
+                        return std::nullopt;
+                    }
+                    return value;
+                }
+
+            private:
+                static constexpr int MAX_DEPTH = 64;
+
+                void skip_whitespace() {
+                    while (pos_ < text_.size() &&
+                           (text_[pos_] == ' ' || text_[pos_] == '\n' || text_[pos_] == '\r' || text_[pos_] == '\t')) {
+                        ++pos_;
+                    }
+                }
+
+                bool consume(char expected) {
+                    skip_whitespace();
+                    if (pos_ < text_.size() && text_[pos_] == expected) {
+                        ++pos_;
+                        return true;
+                    }
+                    return false;
+                }
+
+                bool consume_literal(std::string_view literal) {
+                    if (text_.substr(pos_, literal.size()) == literal) {
+                        pos_ += literal.size();
+                        return true;
+                    }
+                    return false;
+                }
+
+                bool parse_value(Value& value, int depth) {
+                    if (depth > MAX_DEPTH) {
+                        return false;
+                    }
+
+                    skip_whitespace();
+                    if (pos_ >= text_.size()) {
+                        return false;
+                    }
+
+                    char c = text_[pos_];
+                    if (c == '{') {
+                        return parse_object(value, depth);
+                    }
+                    if (c == '[') {
+                        return parse_array(value, depth);
+                    }
+                    if (c == '"') {
+                        value.type = Value::Type::String;
+                        return parse_string(value.string);
+                    }
+                    if (consume_literal("true")) {
+                        value.type = Value::Type::Bool;
+                        value.boolean = true;
+                        return true;
+                    }
+                    if (consume_literal("false")) {
+                        value.type = Value::Type::Bool;
+                        value.boolean = false;
+                        return true;
+                    }
+                    if (consume_literal("null")) {
+                        value.type = Value::Type::Null;
+                        return true;
+                    }
+                    return parse_number(value);
+                }
+
+                bool parse_number(Value& value) {
+                    const char* begin = text_.data() + pos_;
+                    const char* end = text_.data() + text_.size();
+                    auto [ptr, ec] = std::from_chars(begin, end, value.number);
+                    if (ec != std::errc{}) {
+                        return false;
+                    }
+                    value.type = Value::Type::Number;
+                    pos_ += static_cast<size_t>(ptr - begin);
+                    return true;
+                }
+
+                bool parse_string(std::string& out) {
+                    ++pos_; // Opening quote
+                    while (pos_ < text_.size()) {
+                        char c = text_[pos_++];
+                        if (c == '"') {
+                            return true;
+                        }
+                        if (c != '\\') {
+                            out += c;
+                            continue;
+                        }
+                        if (pos_ >= text_.size()) {
+                            return false;
+                        }
+                        char escaped = text_[pos_++];
+                        switch (escaped) {
+                            case '"': out += '"'; break;
+                            case '\\': out += '\\'; break;
+                            case '/': out += '/'; break;
+                            case 'b': out += '\b'; break;
+                            case 'f': out += '\f'; break;
+                            case 'n': out += '\n'; break;
+                            case 'r': out += '\r'; break;
+                            case 't': out += '\t'; break;
+                            case 'u': {
+                                // Only the ASCII range is produced by escape()
+                                if (pos_ + 4 > text_.size()) {
+                                    return false;
+                                }
+                                unsigned int code = 0;
+                                auto [ptr, ec] = std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, code, 16);
+                                if (ec != std::errc{} || ptr != text_.data() + pos_ + 4) {
+                                    return false;
+                                }
+                                out += static_cast<char>(code < 0x80 ? code : '?');
+                                pos_ += 4;
+                                break;
+                            }
+                            default:
+                                return false;
+                        }
+                    }
+                    return false;
+                }
+
+                bool parse_array(Value& value, int depth) {
+                    value.type = Value::Type::Array;
+                    ++pos_; // '['
+                    if (consume(']')) {
+                        return true;
+                    }
+                    while (true) {
+                        Value element;
+                        if (!parse_value(element, depth + 1)) {
+                            return false;
+                        }
+                        value.array.push_back(std::move(element));
+                        if (consume(']')) {
+                            return true;
+                        }
+                        if (!consume(',')) {
+                            return false;
+                        }
+                    }
+                }
+
+                bool parse_object(Value& value, int depth) {
+                    value.type = Value::Type::Object;
+                    ++pos_; // '{'
+                    if (consume('}')) {
+                        return true;
+                    }
+                    while (true) {
+                        skip_whitespace();
+                        if (pos_ >= text_.size() || text_[pos_] != '"') {
+                            return false;
+                        }
+                        std::string key;
+                        if (!parse_string(key) || !consume(':')) {
+                            return false;
+                        }
+                        Value member;
+                        if (!parse_value(member, depth + 1)) {
+                            return false;
+                        }
+                        value.object.emplace_back(std::move(key), std::move(member));
+                        if (consume('}')) {
+                            return true;
+                        }
+                        if (!consume(',')) {
+                            return false;
+                        }
+                    }
+                }
+
+                std::string_view text_;
+                size_t pos_ = 0;
+        };
+    }
+
+    const Value* Value::find(std::string_view key) const {
+        if (type != Type::Object) {
+            return nullptr;
+        }
+        for (const auto& [name, member] : object) {
+            if (name == key) {
+                return &member;
+            }
+        }
+        return nullptr;
+    }
+
+    double Value::number_or(std::string_view key, double fallback) const {
+        const Value* member = find(key);
+        return (member != nullptr && member->type == Type::Number) ? member->number : fallback;
+    }
+
+    std::string Value::string_or(std::string_view key, std::string_view fallback) const {
+        const Value* member = find(key);
+        return (member != nullptr && member->type == Type::String) ? member->string : std::string(fallback);
+    }
+
+    std::optional<Value> parse(std::string_view text) {
+        Parser parser(text);
+        return parser.parse_document();
+    }
+
+    std::string escape(std::string_view text) {
+        std::string result;
+        result.reserve(text.size());
+        for (char c : text) {
+            switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char code[7];
+                        std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+                        result += code;
+                    } else {
+                        result += c;
+                    }
+            }
+        }
+        return result;
+    }
+}
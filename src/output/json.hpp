@@ -0,0 +1,36 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace surge::output::json {
+    // Small JSON document model, enough to read back files surge writes itself
+    struct Value {
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        Type type = Type::Null;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<Value> array;
+        std::vector<std::pair<std::string, Value>> object;
+
+        // Member lookup, nullptr if missing or not an object
+        const Value* find(std::string_view key) const;
+
+        // Numeric member or fallback
+        double number_or(std::string_view key, double fallback) const;
+
+        // String member or fallback
+        std::string string_or(std::string_view key, std::string_view fallback) const;
+    };
+
+    // Parse a complete document, nullopt on syntax error
+    std::optional<Value> parse(std::string_view text);
+
+    // Escape a string for embedding between quotes
+    std::string escape(std::string_view text);
+}
@@ -0,0 +1,226 @@
+#include "output/metrics_server.hpp"
+#include "stats/collector.hpp"
+#include "stats/histogram.hpp"
+#include "stats/metrics.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace surge::output {
+    namespace {
+        // How often the accept loop checks for stop
+        constexpr int POLL_INTERVAL_MS = 200;
+
+        // Latency bucket upper bounds exported to Prometheus (μs)
+        constexpr std::array<std::uint64_t, 16> LATENCY_BUCKETS_US = {
+            100, 250, 500,
+            1'000, 2'500, 5'000,
+            10'000, 25'000, 50'000,
+            100'000, 250'000, 500'000,
+            1'000'000, 2'500'000, 5'000'000,
+            10'000'000
+        };
+
+        void write_counter(std::ostringstream& out, std::string_view name, std::string_view help, std::uint64_t value) {
+            out << "# TYPE " << name << " counter\n";
+            out << "# HELP " << name << " " << help << "\n";
+            out << name << "_total " << value << "\n";
+        }
+
+        void write_gauge(std::ostringstream& out, std::string_view name, std::string_view help, std::uint64_t value) {
+            out << "# TYPE " << name << " gauge\n";
+            out << "# HELP " << name << " " << help << "\n";
+            out << name << " " << value << "\n";
+        }
+
+        void send_all(int fd, std::string_view data) {
+            while (!data.empty()) {
+                ssize_t sent = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+                if (sent <= 0) {
+                    return;
+                }
+                data.remove_prefix(static_cast<size_t>(sent));
+            }
+        }
+    }
+
+    MetricsServer::MetricsServer(std::uint16_t port, const stats::Collector& collector)
+        : port_(port)
+        , collector_(collector)
+    {}
+
+    MetricsServer::~MetricsServer() {
+        stop();
+    }
+
+    bool MetricsServer::start() {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) {
+            std::cerr << "Error: could not create metrics socket\n";
+            return false;
+        }
+
+        int reuse = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port_);
+
+        if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listen_fd_, 16) < 0) {
+            std::cerr << "Error: could not listen for metrics on port " << port_ << "\n";
+            close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+
+        thread_ = std::jthread([this](std::stop_token stop_token) {
+            serve(stop_token);
+        });
+
+        return true;
+    }
+
+    void MetricsServer::stop() {
+        if (thread_.joinable()) {
+            thread_.request_stop();
+            thread_.join();
+        }
+        if (listen_fd_ >= 0) {
+            close(listen_fd_);
+            listen_fd_ = -1;
+        }
+    }
+
+    void MetricsServer::serve(std::stop_token stop_token) {
+        pollfd listener{listen_fd_, POLLIN, 0};
+
+        while (!stop_token.stop_requested()) {
+            if (poll(&listener, 1, POLL_INTERVAL_MS) <= 0) {
+                continue;
+            }
+
+            int client_fd = accept(listen_fd_, nullptr, nullptr);
+            if (client_fd < 0) {
+                continue;
+            }
+
+            handle_connection(client_fd);
+            close(client_fd);
+        }
+    }
+
+    // One request per connection, scrapes are infrequent
+    void MetricsServer::handle_connection(int client_fd) {
+        // Wait briefly for the request head
+        timeval timeout{1, 0};
+        setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+            ssize_t received = recv(client_fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return;
+            }
+            request.append(buffer, static_cast<size_t>(received));
+        }
+
+        std::string_view request_line(request);
+        request_line = request_line.substr(0, request_line.find("\r\n"));
+
+        std::string status = "200 OK";
+        std::string body;
+        std::string content_type = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+        if (!request_line.starts_with("GET ")) {
+            status = "405 Method Not Allowed";
+            content_type = "text/plain";
+        } else if (!request_line.starts_with("GET /metrics ") && !request_line.starts_with("GET / ")) {
+            status = "404 Not Found";
+            content_type = "text/plain";
+        } else {
+            body = render(collector_);
+        }
+
+        std::ostringstream response;
+        response << "HTTP/1.1 " << status << "\r\n"
+                 << "Content-Type: " << content_type << "\r\n"
+                 << "Content-Length: " << body.size() << "\r\n"
+                 << "Connection: close\r\n\r\n"
+                 << body;
+
+        send_all(client_fd, response.str());
+    }
+
+    std::string MetricsServer::render(const stats::Collector& collector) {
+        stats::Metrics m = collector.get_metrics();
+
+        std::ostringstream out;
+
+        write_counter(out, "surge_requests", "Completed requests.", m.total_requests);
+        write_counter(out, "surge_requests_successful", "Requests with a valid HTTP response.", m.successful_requests);
+        write_counter(out, "surge_requests_failed", "Requests that failed before a valid response.", m.failed_requests);
+
+        // Per status totals
+        out << "# TYPE surge_responses counter\n";
+        out << "# HELP surge_responses Responses by HTTP status code.\n";
+        for (const auto& [code, count] : m.status_codes) {
+            out << "surge_responses_total{code=\"" << code << "\"} " << count << "\n";
+        }
+
+        write_gauge(out, "surge_requests_in_flight", "Requests currently in flight.", collector.in_flight());
+        write_gauge(out, "surge_connections_open", "Connections currently open.", collector.open_connections());
+        write_counter(out, "surge_connections_opened", "TCP connections established.", m.connections_opened);
+        write_counter(out, "surge_connect_failures", "Failed connection attempts.", m.connect_failures);
+
+        // Latency histogram, cumulative buckets in seconds
+        const stats::Histogram& h = m.latency_histogram;
+        out << "# TYPE surge_request_latency_seconds histogram\n";
+        out << "# UNIT surge_request_latency_seconds seconds\n";
+        out << "# HELP surge_request_latency_seconds Latency of successful requests.\n";
+        for (std::uint64_t bound : LATENCY_BUCKETS_US) {
+            out << "surge_request_latency_seconds_bucket{le=\"" << (bound / 1'000'000.0) << "\"} "
+                << h.count_at_or_below(bound) << "\n";
+        }
+        out << "surge_request_latency_seconds_bucket{le=\"+Inf\"} " << h.count() << "\n";
+        out << "surge_request_latency_seconds_count " << h.count() << "\n";
+        out << "surge_request_latency_seconds_sum " << (m.total_latency.count() / 1'000'000.0) << "\n";
+
+        // Same buckets split by outcome (status class or failed)
+        out << "# TYPE surge_request_latency_by_outcome_seconds histogram\n";
+        out << "# UNIT surge_request_latency_by_outcome_seconds seconds\n";
+        out << "# HELP surge_request_latency_by_outcome_seconds Latency by status class, failed = time until the error.\n";
+        for (std::size_t i = 0; i < stats::OUTCOME_COUNT; ++i) {
+            const stats::Histogram& outcome = m.outcome_histograms[i];
+            if (outcome.count() == 0) {
+                continue;
+            }
+            const char* name = stats::to_string(static_cast<stats::Outcome>(i));
+            for (std::uint64_t bound : LATENCY_BUCKETS_US) {
+                out << "surge_request_latency_by_outcome_seconds_bucket{outcome=\"" << name << "\",le=\""
+                    << (bound / 1'000'000.0) << "\"} " << outcome.count_at_or_below(bound) << "\n";
+            }
+            out << "surge_request_latency_by_outcome_seconds_bucket{outcome=\"" << name << "\",le=\"+Inf\"} "
+                << outcome.count() << "\n";
+            out << "surge_request_latency_by_outcome_seconds_count{outcome=\"" << name << "\"} " << outcome.count() << "\n";
+            out << "surge_request_latency_by_outcome_seconds_sum{outcome=\"" << name << "\"} "
+                << (m.outcome_latency_us[i] / 1'000'000.0) << "\n";
+        }
+
+        out << "# EOF\n";
+
+        return out.str();
+    }
+}
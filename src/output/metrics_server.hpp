@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "stats/collector.hpp"
+
+namespace surge::output {
+    // Minimal embedded HTTP listener serving live metrics in OpenMetrics text format
+    // Every scrape reads a lock free snapshot of the collector, workers are never blocked
+    class MetricsServer {
+        public:
+            MetricsServer(std::uint16_t port, const stats::Collector& collector);
+
+            // Stops the listener thread
+            ~MetricsServer();
+
+            // Disable copy
+            MetricsServer(const MetricsServer&) = delete;
+            MetricsServer& operator=(const MetricsServer&) = delete;
+
+            // Bind and start serving on a background thread, false if the port cant be bound
+            bool start();
+
+            void stop();
+
+            // Render the current metrics as an OpenMetrics exposition
+            static std::string render(const stats::Collector& collector);
+
+        private:
+            // Accept loop, runs until stop requested
+            void serve(std::stop_token stop_token);
+
+            void handle_connection(int client_fd);
+
+            std::uint16_t port_;
+            const stats::Collector& collector_;
+            int listen_fd_ = -1;
+            std::jthread thread_;
+    };
+}
@@ -1,13 +1,18 @@
 #include "output/reporter.hpp"
+#include "output/json.hpp"
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <ios>
 #include <iostream>
+#include <iterator>
 #include <iomanip>
 #include <sstream>
 #include <streambuf>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace surge::output {
     // Format microseconds
@@ -50,6 +55,28 @@ namespace surge::output {
         return result;
     }
 
+    // Format bytes with decimal units (1 MB = 1,000,000 bytes)
+    std::string Reporter::format_bytes(uint64_t bytes) {
+        constexpr const char* UNITS[] = {"B", "KB", "MB", "GB", "TB"};
+        double value = static_cast<double>(bytes);
+        size_t unit = 0;
+        while (value >= 1000.0 && unit + 1 < std::size(UNITS)) {
+            value /= 1000.0;
+            unit++;
+        }
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(unit == 0 ? 0 : 2) << value << " " << UNITS[unit];
+        return oss.str();
+    }
+
+    // Format bytes per second as MB/s
+    std::string Reporter::format_rate(double bytes_per_second) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << (bytes_per_second / 1'000'000.0) << " MB/s";
+        return oss.str();
+    }
+
     // Format percetage with 2 decimal places
     std::string Reporter::format_percent(double value) {
         std::ostringstream oss;
@@ -72,6 +99,172 @@ namespace surge::output {
         return oss.str();
     }
 
+    // One row per outcome (and per status code when split), skipped when every response was in
+    // one class (same as Latency)
+    void Reporter::print_outcomes(const stats::Metrics& metrics, bool coloured) {
+        using namespace Colours;
+
+        std::vector<std::pair<std::string, const stats::Histogram*>> rows;
+        for (std::size_t i = 0; i < stats::OUTCOME_COUNT; ++i) {
+            if (metrics.outcome_histograms[i].count() > 0) {
+                rows.emplace_back(stats::to_string(static_cast<stats::Outcome>(i)), &metrics.outcome_histograms[i]);
+            }
+        }
+        for (const auto& [code, histogram] : metrics.code_histograms) {
+            rows.emplace_back("  " + std::to_string(code), &histogram);
+        }
+        bool one_class = rows.size() == 1 && rows.front().first != "failed";
+        if (rows.empty() || one_class) {
+            return;
+        }
+
+        std::cout << (coloured ? BOLD : "") << "Latency by outcome:" << (coloured ? RESET : "") << "\n";
+        std::cout << "  " << std::left << std::setw(8) << "" << std::right
+                  << std::setw(12) << "Count" << std::setw(12) << "p50" << std::setw(12) << "p90"
+                  << std::setw(12) << "p99" << std::setw(12) << "Max" << "\n";
+
+        for (const auto& [name, histogram] : rows) {
+            const char* colour = "";
+            if (coloured) {
+                colour = name == "failed" || name == "5xx" ? RED.c_str()
+                       : name == "4xx" ? YELLOW.c_str()
+                       : name == "2xx" ? GREEN.c_str() : "";
+            }
+            std::cout << "  " << colour << std::left << std::setw(8) << name << std::right << (*colour ? RESET : "")
+                      << std::setw(12) << format_number(histogram->count())
+                      << std::setw(12) << format_latency(histogram->value_at(0.50))
+                      << std::setw(12) << format_latency(histogram->value_at(0.90))
+                      << std::setw(12) << format_latency(histogram->value_at(0.99))
+                      << std::setw(12) << format_latency(histogram->max()) << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    // One row per Server-Timing name, then what the client saw beyond the server's own total
+    void Reporter::print_server_timing(const stats::Metrics& metrics, bool coloured) {
+        using namespace Colours;
+
+        if (metrics.server_timing_histograms.empty()) {
+            return;
+        }
+
+        std::vector<std::pair<std::string, const stats::Histogram*>> rows;
+        for (const auto& [name, histogram] : metrics.server_timing_histograms) {
+            rows.emplace_back(name, &histogram);
+        }
+        if (metrics.outside_server_histogram.count() > 0) {
+            rows.emplace_back("outside server", &metrics.outside_server_histogram);
+        }
+
+        std::size_t width = 8;
+        for (const auto& row : rows) {
+            width = std::max(width, row.first.size() + 2);
+        }
+
+        std::cout << (coloured ? BOLD : "") << "Server timing:" << (coloured ? RESET : "") << "\n";
+        std::cout << "  " << std::left << std::setw(static_cast<int>(width)) << "" << std::right
+                  << std::setw(12) << "Count" << std::setw(12) << "p50" << std::setw(12) << "p90"
+                  << std::setw(12) << "p99" << std::setw(12) << "Max" << "\n";
+
+        for (const auto& [name, histogram] : rows) {
+            const char* colour = coloured && histogram == &metrics.outside_server_histogram ? CYAN.c_str() : "";
+            std::cout << "  " << colour << std::left << std::setw(static_cast<int>(width)) << name << std::right << (*colour ? RESET : "")
+                      << std::setw(12) << format_number(histogram->count())
+                      << std::setw(12) << format_latency(histogram->value_at(0.50))
+                      << std::setw(12) << format_latency(histogram->value_at(0.90))
+                      << std::setw(12) << format_latency(histogram->value_at(0.99))
+                      << std::setw(12) << format_latency(histogram->max()) << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    // Two rankings of the tracked paths, "~" marks counts that are Space-Saving lower bounds
+    void Reporter::print_paths(const core::Results& results, bool coloured) {
+        using namespace Colours;
+
+        auto table = [&](const char* title, const std::vector<stats::PathSummary>& paths, bool by_time) {
+            if (paths.empty()) {
+                return;
+            }
+            std::size_t width = 8;
+            for (const auto& path : paths) {
+                width = std::max(width, path.path.size() + 2);
+            }
+
+            std::cout << (coloured ? BOLD : "") << title << (coloured ? RESET : "") << "\n";
+            std::cout << "  " << std::left << std::setw(static_cast<int>(width)) << "Path" << std::right
+                      << std::setw(12) << "Count" << std::setw(12) << "Total" << std::setw(12) << "p50"
+                      << std::setw(12) << "p99" << std::setw(12) << "Max" << "\n";
+
+            for (const auto& path : paths) {
+                const char* highlight = coloured ? RED.c_str() : "";
+                std::string count = format_number(path.count);
+                if (path.error > 0) {
+                    count.insert(0, 1, '~');
+                }
+                std::string total = format_duration(std::chrono::microseconds(path.total_time_us));
+                std::cout << "  " << std::left << std::setw(static_cast<int>(width)) << path.path << std::right
+                          << std::setw(12) << count
+                          << (by_time ? highlight : "") << std::setw(12) << total << (by_time && coloured ? RESET : "")
+                          << std::setw(12) << format_latency(path.p50)
+                          << (by_time ? "" : highlight) << std::setw(12) << format_latency(path.p99) << (!by_time && coloured ? RESET : "")
+                          << std::setw(12) << format_latency(path.max) << "\n";
+            }
+            std::cout << "\n";
+        };
+
+        table("Slowest paths (p99):", results.slowest_paths, false);
+        table("Most time spent (total):", results.costliest_paths, true);
+    }
+
+    void Reporter::print_exemplars(const core::Results& results, bool coloured) {
+        using namespace Colours;
+
+        std::size_t slowest = 0;
+        for (const auto& exemplar : results.exemplars) {
+            slowest += exemplar.slowest ? 1 : 0;
+        }
+        if (slowest == 0) {
+            return;
+        }
+
+        std::cout << (coloured ? BOLD : "") << "Slowest requests:" << (coloured ? RESET : "") << "\n";
+        std::cout << "  " << std::right << std::setw(10) << "Latency" << std::setw(10) << "Connect"
+                  << std::setw(10) << "Wait" << std::setw(10) << "Receive" << std::setw(8) << "Status"
+                  << std::setw(10) << "Server" << "  Worker/conn  Port\n";
+
+        std::size_t shown = 0;
+        for (const auto& exemplar : results.exemplars) {
+            if (!exemplar.slowest) {
+                continue;
+            }
+            if (shown++ == MAX_EXEMPLARS_SHOWN) {
+                break;
+            }
+            auto connect = exemplar.connected ? exemplar.connect_time : exemplar.latency;
+            auto first_byte = exemplar.first_byte.count() > 0 ? exemplar.first_byte : exemplar.latency;
+            auto wait = std::max(first_byte - connect, std::chrono::microseconds(0));
+            auto receive = exemplar.latency - std::max(first_byte, connect);
+            std::string status = exemplar.status_code > 0 ? std::to_string(exemplar.status_code) : "-";
+            std::string server = exemplar.server_time_ms >= 0.0
+                ? format_latency(static_cast<uint64_t>(exemplar.server_time_ms * 1000.0)) : "-";
+
+            std::cout << "  " << (coloured ? RED : "") << std::setw(10) << format_latency(exemplar.latency.count())
+                      << (coloured ? RESET : "")
+                      << std::setw(10) << format_latency(connect.count())
+                      << std::setw(10) << format_latency(wait.count())
+                      << std::setw(10) << format_latency(std::max<int64_t>(receive.count(), 0))
+                      << std::setw(8) << status << std::setw(10) << server
+                      << "  " << std::left << std::setw(11) << (std::to_string(exemplar.worker) + "/" + std::to_string(exemplar.connection))
+                      << std::right << "  " << exemplar.local_port;
+            if (exemplar.error != nullptr) {
+                std::cout << "  " << exemplar.error;
+            }
+            std::cout << "\n";
+        }
+        std::cout << "\n";
+    }
+
     // Draw horizontal line
     std::string Reporter::line(size_t length, char ch) {
         return std::string(length, ch);
@@ -107,7 +300,14 @@ namespace surge::output {
 
         std::cout << "\n";
         std::cout << "  Requests/sec:    " << std::fixed << std::setprecision(2) 
-              << results.requests_per_second << "\n\n";
+              << results.requests_per_second << "\n";
+        if (results.cut_off_requests > 0) {
+            std::cout << "  Cut off:         " << format_number(results.cut_off_requests) << " (in flight at the end, excluded)\n";
+        }
+        if (results.interrupted) {
+            std::cout << "  Interrupted:     partial results\n";
+        }
+        std::cout << "\n";
 
         // Latency statistics
         if (m.successful_requests > 0) {
@@ -125,6 +325,112 @@ namespace surge::output {
             std::cout << "  p99.9:    " << format_latency(p.p999) << "\n\n";
         }
 
+        print_outcomes(m, false);
+        print_server_timing(m, false);
+        print_paths(results, false);
+        print_exemplars(results, false);
+
+        // Per backend breakdown
+        if (!results.backends.empty()) {
+            std::cout << "Backends:\n";
+            for (const auto& b : results.backends) {
+                std::cout << "  " << b.target << "\n";
+                std::cout << "    Requests: " << format_number(b.metrics.total_requests)
+                          << "  Failed: " << format_number(b.metrics.failed_requests)
+                          << "  Req/sec: " << std::fixed << std::setprecision(2) << b.requests_per_second
+                          << "  p50: " << format_latency(b.percentiles.p50)
+                          << "  p99: " << format_latency(b.percentiles.p99) << "\n";
+            }
+            std::cout << "\n";
+        }
+
+        // Bytes and transfer rates
+        if (m.bytes_received > 0) {
+            double seconds = results.duration.count() / 1'000'000.0;
+            const auto& rate = m.transfer_rate_histogram;
+            const auto& first = m.first_byte_histogram;
+            std::cout << "Transfer:\n";
+            std::cout << "  Sent:            " << format_bytes(m.bytes_sent)
+                      << " (" << format_rate(seconds > 0 ? m.bytes_sent / seconds : 0.0) << ")\n";
+            std::cout << "  Received:        " << format_bytes(m.bytes_received)
+                      << " (" << format_rate(seconds > 0 ? m.bytes_received / seconds : 0.0) << ")\n";
+            if (rate.count() > 0) {
+                std::cout << "  Per request:     p50 " << format_rate(rate.value_at(0.50) * 1000.0)
+                          << "  p99 " << format_rate(rate.value_at(0.01) * 1000.0) << " (slowest 1%)\n";
+            }
+            if (first.count() > 0) {
+                std::cout << "  First byte:      p50 " << format_latency(first.value_at(0.50))
+                          << "  p99 " << format_latency(first.value_at(0.99)) << "\n";
+            }
+            std::cout << "  Last byte:       p50 " << format_latency(p.p50)
+                      << "  p99 " << format_latency(p.p99) << "\n\n";
+        }
+
+        // Body decoding, its time is not in the latency above
+        if (m.body_wire_bytes > 0) {
+            const auto& d = m.decode_histogram;
+            std::cout << "Decoding:\n";
+            std::cout << "  Compressed:      " << format_number(m.compressed_responses) << " of "
+                      << format_number(d.count()) << " bodies\n";
+            std::cout << "  Body bytes:      " << format_bytes(m.body_wire_bytes) << " received, "
+                      << format_bytes(m.body_decoded_bytes) << " decoded (" << std::fixed << std::setprecision(2)
+                      << static_cast<double>(m.body_decoded_bytes) / static_cast<double>(m.body_wire_bytes) << "x)\n";
+            std::cout << "  Decode time:     p50 " << format_latency(d.value_at(0.50))
+                      << "  p99 " << format_latency(d.value_at(0.99))
+                      << "  max " << format_latency(d.max()) << "\n\n";
+        }
+
+        // Kernel timestamps: where the wait went
+        if (m.network_histogram.count() > 0) {
+            const auto& n = m.network_histogram;
+            const auto& r = m.read_delay_histogram;
+            std::cout << "Kernel timestamps:\n";
+            std::cout << "  Samples:         " << format_number(n.count()) << "\n";
+            std::cout << "  Network+server:  p50 " << format_latency(n.value_at(0.50))
+                      << "  p90 " << format_latency(n.value_at(0.90))
+                      << "  p99 " << format_latency(n.value_at(0.99)) << "\n";
+            std::cout << "  Read delay:      p50 " << format_latency(r.value_at(0.50))
+                      << "  p90 " << format_latency(r.value_at(0.90))
+                      << "  p99 " << format_latency(r.value_at(0.99)) << "\n\n";
+        }
+
+        // Connection churn
+        if (m.connections_opened > 0 || m.connect_failures > 0) {
+            std::cout << "Connections:\n";
+            std::cout << "  Opened:          " << format_number(m.connections_opened) << "\n";
+            std::cout << "  Failed:          " << format_number(m.connect_failures) << "\n";
+            std::cout << "  Connects/sec:    " << std::fixed << std::setprecision(2) << results.connects_per_second << "\n";
+            if (m.connections_opened > 0) {
+                std::cout << "  Avg connect:     " << format_latency(m.total_connect_time.count() / m.connections_opened) << "\n";
+            }
+            std::cout << "  TIME_WAIT:       " << format_number(results.time_wait_sockets) << "\n\n";
+        }
+
+        // Warmup phase (excluded above)
+        if (results.warmup) {
+            const auto& w = *results.warmup;
+            std::cout << "Warmup (excluded):\n";
+            std::cout << "  Duration:        " << format_duration(w.duration);
+            if (w.steady_state_detected) {
+                std::cout << " (steady state detected)";
+            }
+            std::cout << "\n";
+            std::cout << "  Requests:        " << format_number(w.metrics.total_requests) << "\n";
+            std::cout << "  Requests/sec:    " << std::fixed << std::setprecision(2) << w.requests_per_second << "\n";
+            std::cout << "  p50:             " << format_latency(w.percentiles.p50) << "\n";
+            std::cout << "  p99:             " << format_latency(w.percentiles.p99) << "\n\n";
+        }
+
+        // Replay timing
+        if (results.replay) {
+            const auto& r = *results.replay;
+            std::cout << "Replay:\n";
+            std::cout << "  Dispatched:      " << format_number(r.dispatched) << "\n";
+            std::cout << "  Skipped lines:   " << format_number(r.skipped_lines) << "\n";
+            std::cout << "  Late (>10ms):    " << format_number(r.late) << "\n";
+            std::cout << "  Max lag:         " << format_duration(r.max_lag) << "\n\n";
+        }
+
         // Status code breakdown
         std::cout << "Status Codes:\n";
         for (const auto& [code, count] : m.status_codes) {
@@ -177,7 +483,15 @@ namespace surge::output {
         std::cout << "\n";
 
         std::cout << "\tRequests/sec:   " << YELLOW << std::fixed << std::setprecision(2)
-                  << results.requests_per_second << RESET << "\n\n";
+                  << results.requests_per_second << RESET << "\n";
+        if (results.cut_off_requests > 0) {
+            std::cout << "\tCut off:        " << YELLOW << format_number(results.cut_off_requests) << RESET
+                      << "\t(in flight at the end, excluded)\n";
+        }
+        if (results.interrupted) {
+            std::cout << "\tInterrupted:    " << RED << "partial results" << RESET << "\n";
+        }
+        std::cout << "\n";
 
         // Latency
         if (m.successful_requests > 0) {
@@ -195,6 +509,118 @@ namespace surge::output {
             std::cout << "  p99.9:    " << RED << format_latency(p.p999) << RESET << "\n\n";
         }
 
+        print_outcomes(m, true);
+        print_server_timing(m, true);
+        print_paths(results, true);
+        print_exemplars(results, true);
+
+        // Per backend breakdown, slowest p99 highlighted
+        if (!results.backends.empty()) {
+            std::uint64_t worst_p99 = 0;
+            for (const auto& b : results.backends) {
+                worst_p99 = std::max(worst_p99, b.percentiles.p99);
+            }
+
+            std::cout << BOLD << "Backends:" << RESET << "\n";
+            for (const auto& b : results.backends) {
+                std::cout << "  " << CYAN << b.target << RESET << "\n";
+                std::cout << "    Requests: " << BLUE << format_number(b.metrics.total_requests) << RESET
+                          << "  Failed: " << (b.metrics.failed_requests > 0 ? RED : GREEN) << format_number(b.metrics.failed_requests) << RESET
+                          << "  Req/sec: " << YELLOW << std::fixed << std::setprecision(2) << b.requests_per_second << RESET
+                          << "  p50: " << BLUE << format_latency(b.percentiles.p50) << RESET
+                          << "  p99: " << (b.percentiles.p99 == worst_p99 ? RED : YELLOW) << format_latency(b.percentiles.p99) << RESET << "\n";
+            }
+            std::cout << "\n";
+        }
+
+        // Bytes and transfer rates
+        if (m.bytes_received > 0) {
+            double seconds = results.duration.count() / 1'000'000.0;
+            const auto& rate = m.transfer_rate_histogram;
+            const auto& first = m.first_byte_histogram;
+            std::cout << BOLD << "Transfer:" << RESET << "\n";
+            std::cout << "  Sent:           " << BLUE << format_bytes(m.bytes_sent) << RESET
+                      << " (" << YELLOW << format_rate(seconds > 0 ? m.bytes_sent / seconds : 0.0) << RESET << ")\n";
+            std::cout << "  Received:       " << BLUE << format_bytes(m.bytes_received) << RESET
+                      << " (" << YELLOW << format_rate(seconds > 0 ? m.bytes_received / seconds : 0.0) << RESET << ")\n";
+            // Not every mode records these (connection hold), an empty histogram has nothing to show
+            if (rate.count() > 0) {
+                std::cout << "  Per request:    p50 " << YELLOW << format_rate(rate.value_at(0.50) * 1000.0) << RESET
+                          << "  p99 " << RED << format_rate(rate.value_at(0.01) * 1000.0) << RESET << " (slowest 1%)\n";
+            }
+            if (first.count() > 0) {
+                std::cout << "  First byte:     p50 " << BLUE << format_latency(first.value_at(0.50)) << RESET
+                          << "  p99 " << RED << format_latency(first.value_at(0.99)) << RESET << "\n";
+            }
+            std::cout << "  Last byte:      p50 " << BLUE << format_latency(p.p50) << RESET
+                      << "  p99 " << RED << format_latency(p.p99) << RESET << "\n\n";
+        }
+
+        // Body decoding, its time is not in the latency above
+        if (m.body_wire_bytes > 0) {
+            const auto& d = m.decode_histogram;
+            std::cout << BOLD << "Decoding:" << RESET << "\n";
+            std::cout << "  Compressed:     " << BLUE << format_number(m.compressed_responses) << RESET << " of "
+                      << format_number(d.count()) << " bodies\n";
+            std::cout << "  Body bytes:     " << BLUE << format_bytes(m.body_wire_bytes) << RESET << " received, "
+                      << BLUE << format_bytes(m.body_decoded_bytes) << RESET << " decoded (" << YELLOW << std::fixed << std::setprecision(2)
+                      << static_cast<double>(m.body_decoded_bytes) / static_cast<double>(m.body_wire_bytes) << "x" << RESET << ")\n";
+            std::cout << "  Decode time:    p50 " << BLUE << format_latency(d.value_at(0.50)) << RESET
+                      << "  p99 " << RED << format_latency(d.value_at(0.99)) << RESET
+                      << "  max " << RED << format_latency(d.max()) << RESET << "\n\n";
+        }
+
+        // Kernel timestamps: where the wait went
+        if (m.network_histogram.count() > 0) {
+            const auto& n = m.network_histogram;
+            const auto& r = m.read_delay_histogram;
+            std::cout << BOLD << "Kernel timestamps:" << RESET << "\n";
+            std::cout << "  Samples:        " << BLUE << format_number(n.count()) << RESET << "\n";
+            std::cout << "  Network+server: p50 " << BLUE << format_latency(n.value_at(0.50)) << RESET
+                      << "  p90 " << YELLOW << format_latency(n.value_at(0.90)) << RESET
+                      << "  p99 " << RED << format_latency(n.value_at(0.99)) << RESET << "\n";
+            std::cout << "  Read delay:     p50 " << BLUE << format_latency(r.value_at(0.50)) << RESET
+                      << "  p90 " << YELLOW << format_latency(r.value_at(0.90)) << RESET
+                      << "  p99 " << RED << format_latency(r.value_at(0.99)) << RESET << "\n\n";
+        }
+
+        // Connection churn
+        if (m.connections_opened > 0 || m.connect_failures > 0) {
+            std::cout << BOLD << "Connections:" << RESET << "\n";
+            std::cout << "  Opened:         " << BLUE << format_number(m.connections_opened) << RESET << "\n";
+            std::cout << "  Failed:         " << (m.connect_failures > 0 ? RED : GREEN) << format_number(m.connect_failures) << RESET << "\n";
+            std::cout << "  Connects/sec:   " << YELLOW << std::fixed << std::setprecision(2) << results.connects_per_second << RESET << "\n";
+            if (m.connections_opened > 0) {
+                std::cout << "  Avg connect:    " << YELLOW << format_latency(m.total_connect_time.count() / m.connections_opened) << RESET << "\n";
+            }
+            std::cout << "  TIME_WAIT:      " << MAGENTA << format_number(results.time_wait_sockets) << RESET << "\n\n";
+        }
+
+        // Warmup phase (excluded above)
+        if (results.warmup) {
+            const auto& w = *results.warmup;
+            std::cout << BOLD << "Warmup (excluded):" << RESET << "\n";
+            std::cout << "  Duration:       " << MAGENTA << format_duration(w.duration) << RESET;
+            if (w.steady_state_detected) {
+                std::cout << " (" << GREEN << "steady state detected" << RESET << ")";
+            }
+            std::cout << "\n";
+            std::cout << "  Requests:       " << BLUE << format_number(w.metrics.total_requests) << RESET << "\n";
+            std::cout << "  Requests/sec:   " << YELLOW << std::fixed << std::setprecision(2) << w.requests_per_second << RESET << "\n";
+            std::cout << "  p50:            " << BLUE << format_latency(w.percentiles.p50) << RESET << "\n";
+            std::cout << "  p99:            " << RED << format_latency(w.percentiles.p99) << RESET << "\n\n";
+        }
+
+        // Replay timing
+        if (results.replay) {
+            const auto& r = *results.replay;
+            std::cout << BOLD << "Replay:" << RESET << "\n";
+            std::cout << "  Dispatched:     " << BLUE << format_number(r.dispatched) << RESET << "\n";
+            std::cout << "  Skipped lines:  " << (r.skipped_lines > 0 ? YELLOW : GREEN) << format_number(r.skipped_lines) << RESET << "\n";
+            std::cout << "  Late (>10ms):   " << (r.late > 0 ? YELLOW : GREEN) << format_number(r.late) << RESET << "\n";
+            std::cout << "  Max lag:        " << MAGENTA << format_duration(r.max_lag) << RESET << "\n\n";
+        }
+
         // Status codes
         std::cout << BOLD << "Status Codes:" << RESET << "\n";
         for (const auto& [code, count] : m.status_codes) {
@@ -202,8 +628,8 @@ namespace surge::output {
             
             // Color based on status code
             std::string color;
-            if (code >= 200 && code < 300) {
-                color = GREEN;  // 2xx = success
+            if (code == 101 || (code >= 200 && code < 300)) {
+                color = GREEN;  // 2xx = success, 101 = WebSocket messages
             } else if (code >= 300 && code < 400) {
                 color = BLUE;   // 3xx = redirect
             } else if (code >= 400 && code < 500) {
@@ -238,4 +664,175 @@ namespace surge::output {
         file.close();
         return true;
     }
-}
\ No newline at end of file
+
+    void Reporter::print_comparison(const stats::Comparison& comparison) {
+        using namespace Colours;
+
+        // Colour a change where an increase is bad
+        auto change = [](double percent, bool higher_is_worse) {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2) << (percent >= 0 ? "+" : "") << percent << "%";
+            bool worse = higher_is_worse ? percent > 0 : percent < 0;
+            return (percent == 0 ? std::string() : (worse ? RED : GREEN)) + oss.str() + RESET;
+        };
+
+        std::cout << "\n" << CYAN << BOLD << line(60, '=') << RESET << "\n";
+        std::cout << CYAN << BOLD << "\t BASELINE COMPARISON" << RESET << "\n";
+        std::cout << CYAN << BOLD << line(60, '=') << RESET << "\n\n";
+
+        std::cout << BOLD << "Latency:" << RESET << "          baseline      current       change\n";
+        for (const auto& delta : comparison.percentiles) {
+            std::cout << "  " << std::left << std::setw(8) << delta.label << std::right
+                      << std::setw(14) << format_latency(delta.baseline_us)
+                      << std::setw(14) << format_latency(delta.current_us)
+                      << "    " << change(delta.change_percent, true) << "\n";
+        }
+
+        std::cout << "\n" << BOLD << "Throughput:" << RESET << "\n";
+        std::cout << "  Requests/sec:  " << std::fixed << std::setprecision(2) << comparison.baseline_rps
+                  << " -> " << comparison.current_rps << "  " << change(comparison.throughput_change_percent, false) << "\n";
+        std::cout << "  Error rate:    " << format_percent(comparison.baseline_error_rate)
+                  << " -> " << format_percent(comparison.current_error_rate) << "\n\n";
+
+        std::cout << BOLD << "Mann-Whitney U:" << RESET << "\n";
+        std::cout << "  z = " << std::setprecision(3) << comparison.test.z
+                  << ", p = " << std::setprecision(4) << comparison.test.p_value
+                  << ", P(slower) = " << std::setprecision(3) << comparison.test.prob_slower << "  "
+                  << (comparison.significant ? YELLOW + "significant" : GREEN + "not significant") << RESET << "\n\n";
+
+        if (comparison.regression()) {
+            std::cout << RED << BOLD << "REGRESSION:" << RESET << "\n";
+            for (const auto& violation : comparison.violations) {
+                std::cout << "  " << RED << violation << RESET << "\n";
+            }
+        } else {
+            std::cout << GREEN << BOLD << "No regression" << RESET << "\n";
+        }
+        std::cout << "\n" << CYAN << BOLD << line(60, '=') << RESET << "\n";
+    }
+
+    void Reporter::print_hold_sample(const core::HoldSample& sample) {
+        using namespace Colours;
+        std::cout << "  " << std::setw(7) << format_duration(sample.elapsed)
+                  << "  held " << BLUE << std::setw(9) << format_number(sample.open_connections) << RESET
+                  << "  +" << YELLOW << std::setw(8) << format_number(static_cast<std::uint64_t>(sample.connects_per_second)) << "/s" << RESET
+                  << "  rss " << MAGENTA << std::setw(10) << format_bytes(sample.rss_bytes) << RESET;
+        if (sample.requests > 0) {
+            std::cout << "  " << format_number(sample.requests) << " req"
+                      << "  p50 " << BLUE << format_latency(sample.p50) << RESET
+                      << "  p99 " << RED << format_latency(sample.p99) << RESET;
+        }
+        std::cout << "\n";
+    }
+
+    void Reporter::print_hold(const core::HoldResults& results) {
+        using namespace Colours;
+        std::cout << BOLD << "Connection capacity:" << RESET << "\n";
+        std::cout << "  Target:         " << BLUE << format_number(results.target) << RESET << "\n";
+        std::cout << "  Peak held:      " << (results.peak_connections >= results.target ? GREEN : RED)
+                  << format_number(results.peak_connections) << RESET << "\n";
+        if (results.time_to_target.count() >= 0) {
+            std::cout << "  Time to target: " << YELLOW << format_duration(results.time_to_target) << RESET << "\n";
+        }
+        std::cout << "  Server closed:  " << (results.server_closed > 0 ? YELLOW : GREEN)
+                  << format_number(results.server_closed) << RESET << " (reopened)\n";
+        if (results.local_failures > 0) {
+            std::cout << "  Local failures: " << RED << format_number(results.local_failures) << RESET << " (send failed, reopened)\n";
+        }
+        std::cout << "  State/conn:     " << BLUE << results.state_bytes << " B" << RESET << "\n";
+        if (results.peak_connections > 0) {
+            std::cout << "  Memory/conn:    " << MAGENTA << format_bytes(results.rss_growth_bytes / results.peak_connections) << RESET
+                      << " (resident growth " << format_bytes(results.rss_growth_bytes) << ")\n";
+        }
+        std::cout << "\n";
+    }
+
+    void Reporter::print_sweep_cell(const core::SweepCell& cell, std::size_t index, std::size_t total) {
+        const auto& r = cell.results;
+        std::cout << "  [" << (index + 1) << "/" << total << "]"
+                  << "  c=" << cell.concurrency << "  body=" << format_bytes(cell.body_bytes)
+                  << "  " << std::fixed << std::setprecision(2) << r.requests_per_second << " req/s"
+                  << "  p50 " << format_latency(r.percentiles.p50)
+                  << "  p99 " << format_latency(r.percentiles.p99);
+        if (r.metrics.failed_requests > 0) {
+            std::cout << "  failed " << format_number(r.metrics.failed_requests);
+        }
+        std::cout << "\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    void Reporter::print_sweep(const std::vector<core::SweepCell>& cells) {
+        using namespace Colours;
+
+        std::cout << "\n" << line(60, '=') << "\n";
+        std::cout << BOLD << "\tSWEEP RESULTS" << RESET << "\n";
+        std::cout << line(60, '=') << "\n\n";
+
+        std::cout << std::right << std::setw(10) << "Body" << std::setw(8) << "Conc" << std::setw(12) << "Requests"
+                  << std::setw(9) << "Failed" << std::setw(12) << "Req/sec" << std::setw(11) << "p50"
+                  << std::setw(11) << "p90" << std::setw(11) << "p99" << std::setw(11) << "p99.9" << "\n";
+
+        // Highlight each body size's best throughput, the knee of its scaling curve
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            double best = 0.0;
+            for (const auto& other : cells) {
+                if (other.body_bytes == cells[i].body_bytes) {
+                    best = std::max(best, other.results.requests_per_second);
+                }
+            }
+
+            const auto& r = cells[i].results;
+            bool peak = r.requests_per_second == best && best > 0.0;
+            std::ostringstream rate;
+            rate << std::fixed << std::setprecision(2) << r.requests_per_second;
+
+            std::cout << std::setw(10) << format_bytes(cells[i].body_bytes) << std::setw(8) << cells[i].concurrency
+                      << std::setw(12) << format_number(r.metrics.total_requests)
+                      << (r.metrics.failed_requests > 0 ? RED : "") << std::setw(9) << format_number(r.metrics.failed_requests)
+                      << (r.metrics.failed_requests > 0 ? RESET : "")
+                      << (peak ? GREEN : "") << std::setw(12) << rate.str() << (peak ? RESET : "")
+                      << std::setw(11) << format_latency(r.percentiles.p50)
+                      << std::setw(11) << format_latency(r.percentiles.p90)
+                      << std::setw(11) << format_latency(r.percentiles.p99)
+                      << std::setw(11) << format_latency(r.percentiles.p999) << "\n";
+        }
+        std::cout << "\n" << line(60, '=') << "\n";
+    }
+
+    bool Reporter::save_sweep_json(const std::vector<core::SweepCell>& cells, const std::string& url,
+                                   const std::string& filepath) {
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            std::cerr << "Error: could not open file to write: " << filepath << "\n";
+            return false;
+        }
+
+        file << "{\n";
+        file << "  \"url\": \"" << json::escape(url) << "\",\n";
+        file << "  \"cells\": [";
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            const auto& r = cells[i].results;
+            const auto& p = r.percentiles;
+            file << (i == 0 ? "\n" : ",\n")
+                 << "    {\"concurrency\": " << cells[i].concurrency
+                 << ", \"body_bytes\": " << cells[i].body_bytes
+                 << ", \"duration_us\": " << r.duration.count()
+                 << ", \"total_requests\": " << r.metrics.total_requests
+                 << ", \"failed_requests\": " << r.metrics.failed_requests
+                 << ", \"requests_per_second\": " << r.requests_per_second
+                 << ", \"bytes_sent\": " << r.metrics.bytes_sent
+                 << ", \"bytes_received\": " << r.metrics.bytes_received
+                 << ", \"percentiles_us\": {\"p50\": " << p.p50 << ", \"p75\": " << p.p75 << ", \"p90\": " << p.p90
+                 << ", \"p95\": " << p.p95 << ", \"p99\": " << p.p99 << ", \"p99.9\": " << p.p999 << "}"
+                 << ", \"max_us\": " << r.metrics.max_latency.count()
+                 << ", \"interrupted\": " << (r.interrupted ? "true" : "false") << "}";
+        }
+        file << "\n  ]\n}\n";
+
+        if (!file) {
+            std::cerr << "Error: failed writing sweep results: " << filepath << "\n";
+            return false;
+        }
+        return true;
+    }
+}
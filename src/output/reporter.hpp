@@ -1,8 +1,12 @@
 #pragma once
 
 #include "core/engine.hpp"
+#include "core/hold.hpp"
+#include "core/sweep.hpp"
+#include "stats/comparison.hpp"
 #include <chrono>
 #include <string>
+#include <vector>
 
 namespace surge::output {
     // ANSI Colour codes for terminal
@@ -30,7 +34,37 @@ namespace surge::output {
             // Save to file
             static bool save_to_file(const core::Results& results, const std::string& filepath);
 
+            // Print a comparison against a baseline run
+            static void print_comparison(const stats::Comparison& comparison);
+
+            // Hold mode: one progress line per sample, then the capacity summary
+            static void print_hold_sample(const core::HoldSample& sample);
+            static void print_hold(const core::HoldResults& results);
+
+            // Sweep: one progress line per finished cell, then every cell in one table
+            static void print_sweep_cell(const core::SweepCell& cell, std::size_t index, std::size_t total);
+            static void print_sweep(const std::vector<core::SweepCell>& cells);
+
+            // Sweep cells as JSON (one object per cell), for plotting
+            static bool save_sweep_json(const std::vector<core::SweepCell>& cells, const std::string& url,
+                                        const std::string& filepath);
+
         private:
+            // Exemplar rows in the console report, the trace file has them all
+            static constexpr std::size_t MAX_EXEMPLARS_SHOWN = 5;
+
+            // Latency by outcome (and status code) side by side
+            static void print_outcomes(const stats::Metrics& metrics, bool coloured);
+
+            // Server-Timing metrics and the time spent outside the server
+            static void print_server_timing(const stats::Metrics& metrics, bool coloured);
+
+            // Worst paths by p99 and by total time (--top-paths)
+            static void print_paths(const core::Results& results, bool coloured);
+
+            // Where the time of the slowest kept exemplars went
+            static void print_exemplars(const core::Results& results, bool coloured);
+
             // Helper format duration
             static std::string format_duration(std::chrono::microseconds duration);
 
@@ -40,6 +74,12 @@ namespace surge::output {
             // Helper format percentage
             static std::string format_percent(double value);
 
+            // Helper format byte count (decimal units)
+            static std::string format_bytes(uint64_t bytes);
+
+            // Helper format a transfer rate in MB/s
+            static std::string format_rate(double bytes_per_second);
+
             // Helper format latency value
             static std::string format_latency(uint64_t microseconds);
 
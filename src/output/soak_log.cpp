@@ -0,0 +1,579 @@
+#include "output/soak_log.hpp"
+#include "stats/histogram.hpp"
+
+#include <zlib.h>
+#include <fcntl.h>          // open()
+#include <unistd.h>         // write(), fdatasync(), close()
+#include <cstdio>           // std::rename()
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace surge::output {
+    namespace {
+        constexpr std::string_view FORMAT_HEADER = "#[surge soak log v2]";
+        constexpr std::string_view COLUMNS =
+            "\"StartOffset\",\"Interval\",\"Requests\",\"Successful\",\"Failed\",\"BytesSent\",\"BytesReceived\","
+            "\"Connections\",\"ConnectFailures\",\"Compressed\",\"BodyWireBytes\",\"BodyDecodedBytes\",\"ConnectTimeUs\","
+            "\"StatusCodes\",\"Histogram\",\"FirstByte\",\"TransferRate\",\"OutsideServer\",\"Network\",\"ReadDelay\","
+            "\"Decode\",\"Outcomes\",\"CodeHistograms\",\"ServerTiming\"";
+        constexpr std::size_t FIELD_COUNT = 24;
+
+        // Counters logged one per column after the interval, in COLUMNS order
+        constexpr std::array<std::uint64_t stats::Metrics::*, 10> COUNTERS = {
+            &stats::Metrics::total_requests, &stats::Metrics::successful_requests, &stats::Metrics::failed_requests,
+            &stats::Metrics::bytes_sent, &stats::Metrics::bytes_received,
+            &stats::Metrics::connections_opened, &stats::Metrics::connect_failures,
+            &stats::Metrics::compressed_responses, &stats::Metrics::body_wire_bytes, &stats::Metrics::body_decoded_bytes,
+        };
+
+        // Histograms logged one per column after the status codes, in COLUMNS order
+        constexpr std::array<stats::Histogram stats::Metrics::*, 7> HISTOGRAMS = {
+            &stats::Metrics::latency_histogram, &stats::Metrics::first_byte_histogram,
+            &stats::Metrics::transfer_rate_histogram, &stats::Metrics::outside_server_histogram,
+            &stats::Metrics::network_histogram, &stats::Metrics::read_delay_histogram, &stats::Metrics::decode_histogram,
+        };
+        constexpr std::size_t COUNTERS_AT = 2;
+        constexpr std::size_t CONNECT_TIME_AT = COUNTERS_AT + COUNTERS.size();
+        constexpr std::size_t STATUS_CODES_AT = CONNECT_TIME_AT + 1;
+        constexpr std::size_t HISTOGRAMS_AT = STATUS_CODES_AT + 1;
+        constexpr std::size_t OUTCOMES_AT = HISTOGRAMS_AT + HISTOGRAMS.size();
+        constexpr std::size_t CODE_HISTOGRAMS_AT = OUTCOMES_AT + 1;
+        constexpr std::size_t SERVER_TIMING_AT = CODE_HISTOGRAMS_AT + 1;
+        static_assert(SERVER_TIMING_AT + 1 == FIELD_COUNT);
+
+        constexpr std::string_view BASE64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        // Longest payload before deflate: every bucket set, 10 bytes per varint at most
+        constexpr std::size_t MAX_RAW_BYTES = stats::Histogram::BUCKET_COUNT * 10;
+
+        // Zigzag LEB128 (HdrHistogram V2 payload): a positive value is a bucket count,
+        // a negative one skips that many empty buckets
+        void append_varint(std::string& out, std::int64_t value) {
+            auto zigzag = (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+            while (zigzag >= 0x80) {
+                out.push_back(static_cast<char>((zigzag & 0x7f) | 0x80));
+                zigzag >>= 7;
+            }
+            out.push_back(static_cast<char>(zigzag));
+        }
+
+        bool read_varint(std::string_view& in, std::int64_t& value) {
+            std::uint64_t zigzag = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (in.empty()) {
+                    return false;
+                }
+                auto byte = static_cast<std::uint8_t>(in.front());
+                in.remove_prefix(1);
+                zigzag |= std::uint64_t{byte & 0x7fu} << shift;
+                if ((byte & 0x80) == 0) {
+                    value = static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::string to_base64(std::string_view raw) {
+            std::string encoded;
+            encoded.reserve((raw.size() + 2) / 3 * 4);
+            for (std::size_t i = 0; i < raw.size(); i += 3) {
+                std::uint32_t chunk = static_cast<std::uint8_t>(raw[i]) << 16;
+                if (i + 1 < raw.size()) chunk |= static_cast<std::uint8_t>(raw[i + 1]) << 8;
+                if (i + 2 < raw.size()) chunk |= static_cast<std::uint8_t>(raw[i + 2]);
+                encoded.push_back(BASE64[(chunk >> 18) & 63]);
+                encoded.push_back(BASE64[(chunk >> 12) & 63]);
+                encoded.push_back(i + 1 < raw.size() ? BASE64[(chunk >> 6) & 63] : '=');
+                encoded.push_back(i + 2 < raw.size() ? BASE64[chunk & 63] : '=');
+            }
+            return encoded;
+        }
+
+        bool from_base64(std::string_view encoded, std::string& raw) {
+            if (encoded.size() % 4 != 0) {
+                return false;
+            }
+            for (std::size_t i = 0; i < encoded.size(); i += 4) {
+                std::uint32_t chunk = 0;
+                int padding = 0;
+                for (std::size_t j = 0; j < 4; ++j) {
+                    char c = encoded[i + j];
+                    std::size_t value = 0;
+                    if (c == '=') {
+                        ++padding;
+                    } else if ((value = BASE64.find(c)) == std::string_view::npos || padding > 0) {
+                        return false;
+                    }
+                    chunk = (chunk << 6) | static_cast<std::uint32_t>(value);
+                }
+                raw.push_back(static_cast<char>(chunk >> 16));
+                if (padding < 2) raw.push_back(static_cast<char>(chunk >> 8));
+                if (padding < 1) raw.push_back(static_cast<char>(chunk));
+            }
+            return true;
+        }
+
+        // Metrics gained between two snapshots of the same collector
+        template <typename Key>
+        void difference(std::map<Key, stats::Histogram>& delta, const std::map<Key, stats::Histogram>& current,
+                        const std::map<Key, stats::Histogram>& previous) {
+            for (const auto& [key, histogram] : current) {
+                stats::Histogram gained = histogram;
+                auto before = previous.find(key);
+                if (before != previous.end()) {
+                    gained.subtract(before->second);
+                }
+                if (gained.count() > 0) {
+                    delta.emplace(key, std::move(gained));
+                }
+            }
+        }
+
+        stats::Metrics difference(const stats::Metrics& current, const stats::Metrics& previous) {
+            stats::Metrics delta;
+            for (auto counter : COUNTERS) {
+                delta.*counter = current.*counter - previous.*counter;
+            }
+            delta.total_connect_time = current.total_connect_time - previous.total_connect_time;
+            for (const auto& [code, count] : current.status_codes) {
+                auto before = previous.status_codes.find(code);
+                std::uint64_t gained = count - (before == previous.status_codes.end() ? 0 : before->second);
+                if (gained > 0) {
+                    delta.status_codes[code] = gained;
+                }
+            }
+            for (auto histogram : HISTOGRAMS) {
+                delta.*histogram = current.*histogram;
+                (delta.*histogram).subtract(previous.*histogram);
+            }
+            for (std::size_t i = 0; i < stats::OUTCOME_COUNT; ++i) {
+                delta.outcome_histograms[i] = current.outcome_histograms[i];
+                delta.outcome_histograms[i].subtract(previous.outcome_histograms[i]);
+            }
+            difference(delta.code_histograms, current.code_histograms, previous.code_histograms);
+            difference(delta.server_timing_histograms, current.server_timing_histograms, previous.server_timing_histograms);
+            return delta;
+        }
+
+        // "name:payload;name:payload", "-" if empty
+        template <typename Key>
+        void format_named(std::ostringstream& line, const std::map<Key, stats::Histogram>& histograms) {
+            if (histograms.empty()) {
+                line << "-";
+            }
+            bool first = true;
+            for (const auto& [name, histogram] : histograms) {
+                line << (first ? "" : ";") << name << ":" << encode_histogram(histogram);
+                first = false;
+            }
+        }
+
+        std::string format_line(double start, double length, const stats::Metrics& m) {
+            std::ostringstream line;
+            line.setf(std::ios::fixed);
+            line.precision(3);
+            line << start << "," << length;
+            for (auto counter : COUNTERS) {
+                line << "," << m.*counter;
+            }
+            line << "," << m.total_connect_time.count() << ",";
+
+            if (m.status_codes.empty()) {
+                line << "-";
+            }
+            bool first = true;
+            for (const auto& [code, count] : m.status_codes) {
+                line << (first ? "" : ";") << code << ":" << count;
+                first = false;
+            }
+
+            for (auto histogram : HISTOGRAMS) {
+                line << "," << encode_histogram(m.*histogram);
+            }
+            line << ",";
+            for (std::size_t i = 0; i < stats::OUTCOME_COUNT; ++i) {
+                line << (i > 0 ? ";" : "") << encode_histogram(m.outcome_histograms[i]);
+            }
+            line << ",";
+            format_named(line, m.code_histograms);
+            line << ",";
+            format_named(line, m.server_timing_histograms);
+            line << "\n";
+            return line.str();
+        }
+
+        bool write_all(int fd, std::string_view data) {
+            while (!data.empty()) {
+                ssize_t written = ::write(fd, data.data(), data.size());
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                data.remove_prefix(static_cast<std::size_t>(written));
+            }
+            return true;
+        }
+
+        template <typename T>
+        bool parse_field(std::string_view text, T& out) {
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+            return ec == std::errc{} && end == text.data() + text.size();
+        }
+
+        bool parse_key(std::string_view text, std::uint16_t& key) {
+            return parse_field(text, key);
+        }
+
+        bool parse_key(std::string_view text, std::string& key) {
+            key = text;
+            return !key.empty();
+        }
+
+        // Calls entry(part) for each ';' separated part of a column, "-" is an empty list
+        template <typename Entry>
+        bool for_each_entry(std::string_view column, Entry entry) {
+            if (column == "-") {
+                return true;
+            }
+            while (true) {
+                std::size_t separator = column.find(';');
+                if (!entry(column.substr(0, separator))) {
+                    return false;
+                }
+                if (separator == std::string_view::npos) {
+                    return true;
+                }
+                column.remove_prefix(separator + 1);
+            }
+        }
+
+        template <typename Key>
+        bool parse_named(std::string_view column, std::map<Key, stats::Histogram>& histograms) {
+            return for_each_entry(column, [&](std::string_view entry) {
+                std::size_t colon = entry.find(':');
+                Key key{};
+                return colon != std::string_view::npos && parse_key(entry.substr(0, colon), key) &&
+                    decode_histogram(entry.substr(colon + 1), histograms[key]);
+            });
+        }
+
+        // One interval line, false if it is malformed (e.g. cut short by a crash)
+        bool parse_line(std::string_view line, double& start, double& length, stats::Metrics& m) {
+            std::array<std::string_view, FIELD_COUNT> fields;
+            std::size_t count = 0;
+            while (count < FIELD_COUNT) {
+                std::size_t comma = line.find(',');
+                fields[count++] = line.substr(0, comma);
+                if (comma == std::string_view::npos) {
+                    break;
+                }
+                line.remove_prefix(comma + 1);
+                if (count == FIELD_COUNT) {
+                    return false;   // More fields than columns
+                }
+            }
+            if (count != FIELD_COUNT) {
+                return false;
+            }
+
+            if (!parse_field(fields[0], start) || !parse_field(fields[1], length)) {
+                return false;
+            }
+            for (std::size_t i = 0; i < COUNTERS.size(); ++i) {
+                if (!parse_field(fields[COUNTERS_AT + i], m.*COUNTERS[i])) {
+                    return false;
+                }
+            }
+            std::int64_t connect_us = 0;
+            if (!parse_field(fields[CONNECT_TIME_AT], connect_us)) {
+                return false;
+            }
+            m.total_connect_time = std::chrono::microseconds(connect_us);
+
+            bool codes = for_each_entry(fields[STATUS_CODES_AT], [&](std::string_view entry) {
+                std::size_t colon = entry.find(':');
+                std::uint16_t code = 0;
+                std::uint64_t code_count = 0;
+                if (colon == std::string_view::npos || !parse_field(entry.substr(0, colon), code) ||
+                    !parse_field(entry.substr(colon + 1), code_count)) {
+                    return false;
+                }
+                m.status_codes[code] += code_count;
+                return true;
+            });
+            if (!codes) {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < HISTOGRAMS.size(); ++i) {
+                if (!decode_histogram(fields[HISTOGRAMS_AT + i], m.*HISTOGRAMS[i])) {
+                    return false;
+                }
+            }
+            std::size_t outcome = 0;
+            bool outcomes = for_each_entry(fields[OUTCOMES_AT], [&](std::string_view entry) {
+                return outcome < stats::OUTCOME_COUNT && decode_histogram(entry, m.outcome_histograms[outcome++]);
+            });
+            return outcomes && outcome == stats::OUTCOME_COUNT &&
+                parse_named(fields[CODE_HISTOGRAMS_AT], m.code_histograms) &&
+                parse_named(fields[SERVER_TIMING_AT], m.server_timing_histograms);
+        }
+
+        template <typename Key>
+        void merge(std::map<Key, stats::Histogram>& total, const std::map<Key, stats::Histogram>& interval) {
+            for (const auto& [key, histogram] : interval) {
+                total[key].merge(histogram);
+            }
+        }
+    }
+
+    std::string encode_histogram(const stats::Histogram& histogram) {
+        std::string raw;
+        std::int64_t zeros = 0;
+        for (std::size_t i = 0; i < stats::Histogram::BUCKET_COUNT; ++i) {
+            std::uint64_t count = histogram.count_at(i);
+            if (count == 0) {
+                ++zeros;
+                continue;
+            }
+            if (zeros > 0) {
+                append_varint(raw, -zeros);
+                zeros = 0;
+            }
+            append_varint(raw, static_cast<std::int64_t>(count));
+        }
+        if (raw.empty()) {
+            return {};
+        }
+
+        // Deflated (zlib stream) like HdrHistogram V2 logs, the run lengths compress well
+        std::string deflated(compressBound(static_cast<uLong>(raw.size())), '\0');
+        auto deflated_size = static_cast<uLongf>(deflated.size());
+        if (compress2(reinterpret_cast<Bytef*>(deflated.data()), &deflated_size,
+                      reinterpret_cast<const Bytef*>(raw.data()), static_cast<uLong>(raw.size()), Z_BEST_COMPRESSION) != Z_OK) {
+            return {};
+        }
+        deflated.resize(deflated_size);
+        return to_base64(deflated);
+    }
+
+    bool decode_histogram(std::string_view encoded, stats::Histogram& histogram) {
+        if (encoded.empty()) {
+            return true;
+        }
+        std::string deflated;
+        if (!from_base64(encoded, deflated)) {
+            return false;
+        }
+        std::string raw(MAX_RAW_BYTES, '\0');
+        auto raw_size = static_cast<uLongf>(raw.size());
+        if (uncompress(reinterpret_cast<Bytef*>(raw.data()), &raw_size,
+                       reinterpret_cast<const Bytef*>(deflated.data()), static_cast<uLong>(deflated.size())) != Z_OK) {
+            return false;
+        }
+        raw.resize(raw_size);
+
+        std::string_view in(raw);
+        std::size_t index = 0;
+        while (!in.empty()) {
+            std::int64_t value = 0;
+            if (!read_varint(in, value)) {
+                return false;
+            }
+            if (value < 0) {
+                index += static_cast<std::size_t>(-value);
+                continue;
+            }
+            if (index >= stats::Histogram::BUCKET_COUNT) {
+                return false;
+            }
+            histogram.set_count_at(index, histogram.count_at(index) + static_cast<std::uint64_t>(value));
+            ++index;
+        }
+        return true;
+    }
+
+    SoakLog::SoakLog(const std::string& filepath, std::chrono::seconds interval,
+                     const stats::Collector& collector, const std::string& url)
+        : filepath_(filepath)
+        , interval_(interval)
+        , collector_(collector)
+        , url_(url)
+    {}
+
+    SoakLog::~SoakLog() {
+        if (thread_.joinable()) {
+            thread_.request_stop();
+            thread_.join();
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool SoakLog::start() {
+        fd_ = open(filepath_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            std::cerr << "Error: could not open soak log: " << filepath_ << "\n";
+            return false;
+        }
+
+        std::ostringstream header;
+        header << FORMAT_HEADER << "\n";
+        header << "#[StartTime: " << std::time(nullptr) << "]\n";
+        header << "#[Url: " << url_ << "]\n";
+        header << "#[SubBucketBits: " << stats::Histogram::SUB_BUCKET_BITS << "]\n";
+        header << COLUMNS << "\n";
+        if (!write_all(fd_, header.str())) {
+            std::cerr << "Error: could not write soak log: " << filepath_ << "\n";
+            return false;
+        }
+
+        start_ = std::chrono::steady_clock::now();
+        previous_ = collector_.get_metrics();
+        thread_ = std::jthread([this](std::stop_token stop_token) {
+            run(stop_token);
+        });
+        return true;
+    }
+
+    void SoakLog::finish() {
+        if (thread_.joinable()) {
+            thread_.request_stop();
+            thread_.join();
+        }
+        write_interval();
+    }
+
+    void SoakLog::run(std::stop_token stop_token) {
+        auto next = start_;
+        while (true) {
+            next += interval_;
+            std::unique_lock lock(wait_mutex_);
+            if (wake_.wait_until(lock, stop_token, next, [] { return false; }) || stop_token.stop_requested()) {
+                return;
+            }
+            lock.unlock();
+            write_interval();
+        }
+    }
+
+    void SoakLog::write_interval() {
+        std::lock_guard lock(write_mutex_);
+        if (fd_ < 0) {
+            return;
+        }
+
+        stats::Metrics current = collector_.get_metrics();
+        double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+        std::string line = format_line(last_offset_, now - last_offset_, difference(current, previous_));
+        if (!write_all(fd_, line) || fdatasync(fd_) < 0) {
+            std::cerr << "Warning: could not write soak log: " << filepath_ << "\n";
+        }
+
+        // Whole run so far, swapped in with rename() so a reader never sees half a checkpoint
+        std::string checkpoint_path = filepath_ + ".checkpoint";
+        std::string temporary_path = checkpoint_path + ".tmp";
+        int checkpoint = open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (checkpoint >= 0) {
+            std::ostringstream contents;
+            contents << FORMAT_HEADER << "\n#[Url: " << url_ << "]\n" << COLUMNS << "\n";
+            contents << format_line(0.0, now, current);
+            bool written = write_all(checkpoint, contents.str()) && fdatasync(checkpoint) == 0;
+            close(checkpoint);
+            if (written) {
+                std::rename(temporary_path.c_str(), checkpoint_path.c_str());
+            }
+        }
+
+        previous_ = std::move(current);
+        last_offset_ = now;
+    }
+
+    std::optional<core::Results> SoakLog::load(const std::string& filepath, double from, double to) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            std::cerr << "Error: could not open soak log: " << filepath << "\n";
+            return std::nullopt;
+        }
+
+        std::string line;
+        if (!std::getline(file, line) || line != FORMAT_HEADER) {
+            std::cerr << "Error: not a surge soak log: " << filepath << "\n";
+            return std::nullopt;
+        }
+
+        core::Results results{};
+        stats::Metrics& total = results.metrics;
+        double covered = 0.0;
+        std::uint64_t skipped = 0;
+
+        while (std::getline(file, line)) {
+            if (line.empty() || line.front() == '#' || line.front() == '"') {
+                continue;
+            }
+
+            double start = 0.0;
+            double length = 0.0;
+            stats::Metrics interval;
+            if (!parse_line(line, start, length, interval)) {
+                skipped++;
+                continue;
+            }
+            // Intervals are kept whole, one counts if it starts inside the window
+            if (start < from || start >= to) {
+                continue;
+            }
+
+            covered += length;
+            for (auto counter : COUNTERS) {
+                total.*counter += interval.*counter;
+            }
+            total.total_connect_time += interval.total_connect_time;
+            for (const auto& [code, count] : interval.status_codes) {
+                total.status_codes[code] += count;
+            }
+            for (auto histogram : HISTOGRAMS) {
+                (total.*histogram).merge(interval.*histogram);
+            }
+            for (std::size_t i = 0; i < stats::OUTCOME_COUNT; ++i) {
+                total.outcome_histograms[i].merge(interval.outcome_histograms[i]);
+            }
+            merge(total.code_histograms, interval.code_histograms);
+            merge(total.server_timing_histograms, interval.server_timing_histograms);
+        }
+
+        if (skipped > 0) {
+            std::cerr << "Warning: skipped " << skipped << " malformed line(s) in " << filepath << "\n";
+        }
+
+        const stats::Histogram& latency = total.latency_histogram;
+        if (latency.count() > 0) {
+            total.min_latency = std::chrono::microseconds(latency.min());
+            total.max_latency = std::chrono::microseconds(latency.max());
+            total.total_latency = std::chrono::microseconds(
+                static_cast<std::int64_t>(latency.mean() * static_cast<double>(latency.count())));
+        }
+        total.test_duration = std::chrono::microseconds(static_cast<std::int64_t>(covered * 1'000'000));
+
+        results.percentiles = latency.percentiles();
+        results.duration = total.test_duration;
+        results.requests_per_second = covered > 0 ? static_cast<double>(total.total_requests) / covered : 0.0;
+        results.connects_per_second = covered > 0 ? static_cast<double>(total.connections_opened) / covered : 0.0;
+        return results;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "core/engine.hpp"
+#include "stats/collector.hpp"
+#include "stats/histogram.hpp"
+#include "stats/metrics.hpp"
+
+namespace surge::output {
+    // Histogram payload of a soak log column: zigzag LEB128 run lengths, deflated, base64
+    // An empty histogram is an empty string
+    std::string encode_histogram(const stats::Histogram& histogram);
+
+    // Adds the payload's counts into histogram, false if it is not a valid payload
+    bool decode_histogram(std::string_view encoded, stats::Histogram& histogram);
+
+    // Interval histogram log for long soak runs (HdrHistogram log style)
+    // Every interval appends one line with that interval's counts and every histogram the
+    // report uses (latency, first byte, transfer rate, outcomes, server timing, decoding,
+    // kernel timestamps), and fsyncs it. <file>.checkpoint is replaced atomically with the
+    // cumulative totals, so a crashed run still has a correct report up to its last interval.
+    // Memory stays constant: only the previous snapshot is kept
+    class SoakLog {
+        public:
+            SoakLog(const std::string& filepath, std::chrono::seconds interval,
+                    const stats::Collector& collector, const std::string& url);
+
+            // Stops the writer thread (without a final interval, see finish())
+            ~SoakLog();
+
+            // Disable copy
+            SoakLog(const SoakLog&) = delete;
+            SoakLog& operator=(const SoakLog&) = delete;
+
+            // Create the log and start writing, false if it cant be created
+            bool start();
+
+            // Write the last partial interval and checkpoint, then stop
+            void finish();
+
+            // Rebuild results for [from, to) seconds into the run, offline
+            // Lines cut short by a crash are skipped, nullopt (with message) if the log is unreadable
+            static std::optional<core::Results> load(const std::string& filepath, double from, double to);
+
+        private:
+            void run(std::stop_token stop_token);
+
+            // Append the interval ending now and replace the checkpoint
+            void write_interval();
+
+            std::string filepath_;
+            std::chrono::seconds interval_;
+            const stats::Collector& collector_;
+            std::string url_;
+
+            int fd_ = -1;
+            std::chrono::steady_clock::time_point start_;
+            double last_offset_ = 0.0;          // Seconds into the run where the next interval starts
+            stats::Metrics previous_;
+
+            std::mutex write_mutex_;
+            std::mutex wait_mutex_;
+            std::condition_variable_any wake_;
+            std::jthread thread_;
+    };
+}
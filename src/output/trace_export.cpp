@@ -0,0 +1,322 @@
+#include "output/trace_export.hpp"
+#include "output/json.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace surge::output {
+    namespace {
+        constexpr std::string_view TRACEPARENT = "traceparent";
+
+        // OTLP span kinds and status codes
+        constexpr int SPAN_KIND_INTERNAL = 1;
+        constexpr int SPAN_KIND_CLIENT = 3;
+        constexpr int STATUS_ERROR = 2;
+
+        // One phase of a request, offsets from its start
+        struct Phase {
+            std::string_view name;
+            std::int64_t start_us = 0;
+            std::int64_t duration_us = 0;
+        };
+
+        // connect, wait (until the first byte) and receive, whichever the request reached
+        std::vector<Phase> phases(const stats::Exemplar& exemplar) {
+            std::vector<Phase> result;
+            std::int64_t connect = exemplar.connect_time.count();
+            std::int64_t first_byte = exemplar.first_byte.count();
+            std::int64_t end = exemplar.latency.count();
+
+            if (exemplar.connected) {
+                result.push_back({"connect", 0, connect});
+                std::int64_t wait_end = first_byte > 0 ? std::min(first_byte, end) : end;
+                result.push_back({"wait", connect, std::max<std::int64_t>(wait_end - connect, 0)});
+                if (first_byte > 0) {
+                    result.push_back({"receive", wait_end, end - wait_end});
+                }
+            } else {
+                result.push_back({"connect", 0, end});
+            }
+            return result;
+        }
+
+        std::int64_t unix_micros(const stats::Exemplar& exemplar) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(exemplar.started.time_since_epoch()).count();
+        }
+
+        std::string_view trim(std::string_view text) {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        // "Name: value" lines, status line skipped
+        std::vector<std::pair<std::string_view, std::string_view>> header_lines(std::string_view text, bool has_status_line) {
+            std::vector<std::pair<std::string_view, std::string_view>> headers;
+            bool first = has_status_line;
+            while (!text.empty()) {
+                std::size_t end = text.find('\n');
+                std::string_view line = text.substr(0, end);
+                text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+                if (first) {
+                    first = false;
+                    continue;
+                }
+                std::size_t colon = line.find(':');
+                if (colon == std::string_view::npos) {
+                    continue;
+                }
+                headers.emplace_back(trim(line.substr(0, colon)), trim(line.substr(colon + 1)));
+            }
+            return headers;
+        }
+
+        std::string status_line(std::string_view head) {
+            return std::string(trim(head.substr(0, head.find('\n'))));
+        }
+
+        bool equals_ignore_case(std::string_view a, std::string_view b) {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+            });
+        }
+
+        bool is_hex(std::string_view text) {
+            return std::all_of(text.begin(), text.end(), [](char c) {
+                return std::isxdigit(static_cast<unsigned char>(c));
+            });
+        }
+
+        // W3C "00-<trace id>-<parent id>-<flags>" from the request's headers
+        bool find_traceparent(const stats::Exemplar& exemplar, std::string& trace_id, std::string& span_id) {
+            for (const auto& [name, value] : header_lines(exemplar.request_headers, false)) {
+                if (!equals_ignore_case(name, TRACEPARENT)) {
+                    continue;
+                }
+                if (value.size() < 55 || value[2] != '-' || value[35] != '-' || value[52] != '-' ||
+                    !is_hex(value.substr(3, 32)) || !is_hex(value.substr(36, 16))) {
+                    return false;
+                }
+                trace_id.assign(value.substr(3, 32));
+                span_id.assign(value.substr(36, 16));
+                std::transform(trace_id.begin(), trace_id.end(), trace_id.begin(), ::tolower);
+                std::transform(span_id.begin(), span_id.end(), span_id.begin(), ::tolower);
+                return true;
+            }
+            return false;
+        }
+
+        std::uint64_t mix(std::uint64_t value) {
+            value += 0x9e3779b97f4a7c15ULL;
+            value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+            return value ^ (value >> 31);
+        }
+
+        std::string hex64(std::uint64_t value) {
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+            return text;
+        }
+
+        std::string request_name(const stats::Exemplar& exemplar) {
+            std::string_view url = exemplar.url;
+            std::size_t scheme = url.find("://");
+            std::size_t path = scheme == std::string_view::npos ? std::string_view::npos : url.find('/', scheme + 3);
+            return exemplar.method + " " + std::string(path == std::string_view::npos ? "/" : url.substr(path));
+        }
+
+        std::string_view kind(const stats::Exemplar& exemplar) {
+            return exemplar.slowest && exemplar.sampled ? "slowest,sampled" : exemplar.slowest ? "slowest" : "sampled";
+        }
+
+        void write_chrome(std::ofstream& file, const std::vector<stats::Exemplar>& exemplars) {
+            file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+            file << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"surge\"}}";
+
+            std::vector<std::uint32_t> workers;
+            for (const auto& exemplar : exemplars) {
+                if (std::find(workers.begin(), workers.end(), exemplar.worker) == workers.end()) {
+                    workers.push_back(exemplar.worker);
+                    file << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << exemplar.worker
+                         << ", \"args\": {\"name\": \"worker " << exemplar.worker << "\"}}";
+                }
+            }
+
+            for (const auto& exemplar : exemplars) {
+                std::int64_t start = unix_micros(exemplar);
+
+                file << ",\n  {\"name\": \"" << json::escape(request_name(exemplar)) << "\", \"cat\": \"request\""
+                     << ", \"ph\": \"X\", \"ts\": " << start << ", \"dur\": " << exemplar.latency.count()
+                     << ", \"pid\": 1, \"tid\": " << exemplar.worker << ", \"args\": {"
+                     << "\"url\": \"" << json::escape(exemplar.url) << "\""
+                     << ", \"kept\": \"" << kind(exemplar) << "\""
+                     << ", \"status\": " << exemplar.status_code;
+                if (exemplar.error != nullptr) {
+                    file << ", \"error\": \"" << json::escape(exemplar.error) << "\"";
+                }
+                file << ", \"connection\": " << exemplar.connection
+                     << ", \"local_port\": " << exemplar.local_port
+                     << ", \"sequence\": " << exemplar.sequence
+                     << ", \"connect_us\": " << exemplar.connect_time.count()
+                     << ", \"first_byte_us\": " << exemplar.first_byte.count()
+                     << ", \"decode_us\": " << exemplar.decode_time.count()
+                     << ", \"bytes_sent\": " << exemplar.bytes_sent
+                     << ", \"bytes_received\": " << exemplar.bytes_received;
+                if (exemplar.timestamped) {
+                    file << ", \"network_us\": " << exemplar.network_time.count()
+                         << ", \"read_delay_us\": " << exemplar.read_delay.count();
+                }
+                if (exemplar.server_time_ms >= 0.0) {
+                    file << ", \"server_ms\": " << exemplar.server_time_ms;
+                }
+                if (!exemplar.response_head.empty()) {
+                    file << ", \"response\": \"" << json::escape(status_line(exemplar.response_head)) << "\"";
+                    file << ", \"response_headers\": {";
+                    bool first = true;
+                    for (const auto& [name, value] : header_lines(exemplar.response_head, true)) {
+                        file << (first ? "" : ", ") << "\"" << json::escape(name) << "\": \"" << json::escape(value) << "\"";
+                        first = false;
+                    }
+                    file << "}";
+                }
+                file << "}}";
+
+                for (const Phase& phase : phases(exemplar)) {
+                    file << ",\n  {\"name\": \"" << phase.name << "\", \"cat\": \"phase\", \"ph\": \"X\""
+                         << ", \"ts\": " << start + phase.start_us << ", \"dur\": " << phase.duration_us
+                         << ", \"pid\": 1, \"tid\": " << exemplar.worker << "}";
+                }
+            }
+            file << "\n]}\n";
+        }
+
+        void write_attribute(std::ofstream& file, bool& first, std::string_view key, std::string_view value) {
+            file << (first ? "" : ", ") << "{\"key\": \"" << json::escape(key)
+                 << "\", \"value\": {\"stringValue\": \"" << json::escape(value) << "\"}}";
+            first = false;
+        }
+
+        void write_attribute(std::ofstream& file, bool& first, std::string_view key, std::uint64_t value) {
+            file << (first ? "" : ", ") << "{\"key\": \"" << key << "\", \"value\": {\"intValue\": \"" << value << "\"}}";
+            first = false;
+        }
+
+        void write_span(std::ofstream& file, bool& first_span, const std::string& trace_id, const std::string& span_id,
+                        const std::string& parent_id, std::string_view name, int span_kind,
+                        std::int64_t start_us, std::int64_t duration_us) {
+            file << (first_span ? "" : ",\n") << "        {\"traceId\": \"" << trace_id << "\", \"spanId\": \"" << span_id << "\"";
+            if (!parent_id.empty()) {
+                file << ", \"parentSpanId\": \"" << parent_id << "\"";
+            }
+            file << ", \"name\": \"" << json::escape(name) << "\", \"kind\": " << span_kind
+                 << ", \"startTimeUnixNano\": \"" << start_us * 1000 << "\""
+                 << ", \"endTimeUnixNano\": \"" << (start_us + duration_us) * 1000 << "\"";
+            first_span = false;
+        }
+
+        void write_otlp(std::ofstream& file, const std::vector<stats::Exemplar>& exemplars) {
+            file << "{\"resourceSpans\": [{\n"
+                 << "  \"resource\": {\"attributes\": [{\"key\": \"service.name\", \"value\": {\"stringValue\": \"surge\"}}]},\n"
+                 << "  \"scopeSpans\": [{\n"
+                 << "    \"scope\": {\"name\": \"surge\"},\n"
+                 << "    \"spans\": [\n";
+
+            bool first_span = true;
+            for (const auto& exemplar : exemplars) {
+                std::int64_t start = unix_micros(exemplar);
+                std::uint64_t seed = mix(static_cast<std::uint64_t>(start) ^ mix(exemplar.worker) ^ mix(exemplar.connection));
+
+                std::string trace_id;
+                std::string span_id;
+                if (!find_traceparent(exemplar, trace_id, span_id)) {
+                    trace_id = hex64(seed) + hex64(mix(seed + 1));
+                    span_id = hex64(mix(seed + 2));
+                }
+
+                write_span(file, first_span, trace_id, span_id, {}, request_name(exemplar), SPAN_KIND_CLIENT,
+                           start, exemplar.latency.count());
+
+                file << ", \"attributes\": [";
+                bool first = true;
+                write_attribute(file, first, "http.request.method", exemplar.method);
+                write_attribute(file, first, "url.full", exemplar.url);
+                write_attribute(file, first, "http.response.status_code", exemplar.status_code);
+                write_attribute(file, first, "network.local.port", exemplar.local_port);
+                write_attribute(file, first, "surge.worker", exemplar.worker);
+                write_attribute(file, first, "surge.connection", exemplar.connection);
+                write_attribute(file, first, "surge.sequence", exemplar.sequence);
+                write_attribute(file, first, "surge.exemplar", kind(exemplar));
+                write_attribute(file, first, "surge.decode_us", static_cast<std::uint64_t>(exemplar.decode_time.count()));
+                if (exemplar.timestamped) {
+                    write_attribute(file, first, "surge.network_us", static_cast<std::uint64_t>(exemplar.network_time.count()));
+                    write_attribute(file, first, "surge.read_delay_us", static_cast<std::uint64_t>(exemplar.read_delay.count()));
+                }
+                if (exemplar.error != nullptr) {
+                    write_attribute(file, first, "error.type", exemplar.error);
+                }
+                for (const auto& [name, value] : header_lines(exemplar.response_head, true)) {
+                    std::string key = "http.response.header.";
+                    for (char c : name) {
+                        key += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                    }
+                    write_attribute(file, first, key, value);
+                }
+                file << "]";
+                if (!exemplar.success) {
+                    file << ", \"status\": {\"code\": " << STATUS_ERROR << "}";
+                }
+                file << "}";
+
+                std::uint64_t child = 3;
+                for (const Phase& phase : phases(exemplar)) {
+                    write_span(file, first_span, trace_id, hex64(mix(seed + child++)), span_id, phase.name,
+                               SPAN_KIND_INTERNAL, start + phase.start_us, phase.duration_us);
+                    file << "}";
+                }
+            }
+            file << "\n    ]\n  }]\n}]}\n";
+        }
+    }
+
+    bool parse_trace_format(std::string_view name, TraceFormat& format) {
+        if (name == "chrome") {
+            format = TraceFormat::Chrome;
+        } else if (name == "otlp") {
+            format = TraceFormat::Otlp;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    bool write_trace(const std::string& filepath, TraceFormat format, const std::vector<stats::Exemplar>& exemplars) {
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            std::cerr << "Error: could not open file to write: " << filepath << "\n";
+            return false;
+        }
+
+        if (format == TraceFormat::Chrome) {
+            write_chrome(file, exemplars);
+        } else {
+            write_otlp(file, exemplars);
+        }
+
+        if (!file) {
+            std::cerr << "Error: failed writing trace: " << filepath << "\n";
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "stats/exemplars.hpp"
+
+namespace surge::output {
+    enum class TraceFormat { Chrome, Otlp };
+
+    // "chrome" or "otlp", false if unknown
+    bool parse_trace_format(std::string_view name, TraceFormat& format);
+
+    // Write exemplars as one trace file, false (error printed) if it could not be written
+    // Chrome: trace-event JSON (chrome://tracing, Perfetto), one track per worker
+    // OTLP: an ExportTraceServiceRequest in OTLP/JSON, one client span per request with
+    // connect / wait / receive child spans. A request sent with a W3C traceparent header
+    // (e.g. -H "traceparent: 00-{{hex:32}}-{{hex:16}}-01") keeps its trace and span id,
+    // so the server's spans nest under it
+    // Timestamps are wall clock, to line up with server side traces
+    bool write_trace(const std::string& filepath, TraceFormat format, const std::vector<stats::Exemplar>& exemplars);
+}
@@ -1,63 +1,247 @@
 #include "stats/collector.hpp"
-#include "http/response.hpp"
+#include "http/result.hpp"
 #include "stats/histogram.hpp"
 #include "stats/metrics.hpp"
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <mutex>
-#include <vector>
 
 namespace surge::stats {
-    // Constructor
-    Collector::Collector() {}
+    Collector::Collector(bool per_code_latency) {
+        if (per_code_latency) {
+            code_histograms_ = std::make_unique<std::atomic<AtomicHistogram*>[]>(MAX_STATUS_CODE + 1);
+        }
+    }
+
+    Collector::~Collector() {
+        if (code_histograms_) {
+            for (std::size_t code = 0; code <= MAX_STATUS_CODE; ++code) {
+                delete code_histograms_[code].load(std::memory_order_relaxed);
+            }
+        }
+    }
 
-    // Record a single HTTP response
-    void Collector::record(const http::Response& response) {
-        // Acquire lock
-        std::lock_guard<std::mutex> lock(mutex_);
+    void Collector::request_started() {
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+    }
 
-        metrics_.total_requests++;
+    void Collector::request_abandoned() {
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    }
 
-        // Calculate min/max latencies + increment counts
-        if (response.success) {
-            metrics_.successful_requests++;
+    // Record a single HTTP result
+    // Only relaxed atomic increments, workers never wait on each other or on readers
+    void Collector::record(const http::Result& result) {
+        total_requests_.fetch_add(1, std::memory_order_relaxed);
 
-            std::chrono::microseconds latency = response.latency;
+        // Paired with request_started()
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
 
-            metrics_.total_latency += latency;
+        bytes_sent_.fetch_add(result.bytes_sent, std::memory_order_relaxed);
+        bytes_received_.fetch_add(result.bytes_received, std::memory_order_relaxed);
+
+        record_connection(result);
+
+        // Record latency + increment counts
+        if (result.success) {
+            successful_requests_.fetch_add(1, std::memory_order_relaxed);
+
+            auto latency = static_cast<std::uint64_t>(result.latency.count());
+            total_latency_us_.fetch_add(latency, std::memory_order_relaxed);
+            latency_histogram_.record(latency);
+
+            // No first byte time: the response was not timed as it arrived (connection hold),
+            // leave both empty rather than record zeros
+            if (result.first_byte.count() > 0) {
+                first_byte_histogram_.record(static_cast<std::uint64_t>(result.first_byte.count()));
+                if (latency > 0) {
+                    // bytes per μs * 1e6 / 1e3 = KB/s
+                    transfer_rate_histogram_.record(result.bytes_received * 1000 / latency);
+                }
+            }
+
+            if (result.server_timing_count > 0) {
+                record_server_timings(result, latency);
+            }
 
-            if (latency < metrics_.min_latency) {
-                metrics_.min_latency = latency;
+            if (result.body_wire_bytes > 0) {
+                body_wire_bytes_.fetch_add(result.body_wire_bytes, std::memory_order_relaxed);
+                body_decoded_bytes_.fetch_add(result.body_decoded_bytes, std::memory_order_relaxed);
+                decode_histogram_.record(static_cast<std::uint64_t>(result.decode_time.count()));
+                if (result.compressed) {
+                    compressed_responses_.fetch_add(1, std::memory_order_relaxed);
+                }
             }
-            if (latency > metrics_.max_latency) {
-                metrics_.max_latency = latency;
+
+            if (result.timestamped) {
+                network_histogram_.record(static_cast<std::uint64_t>(result.network_time.count()));
+                read_delay_histogram_.record(static_cast<std::uint64_t>(result.read_delay.count()));
             }
 
-            metrics_.latencies_us.push_back(latency.count());
+            std::uint16_t code = std::min(result.status_code, MAX_STATUS_CODE);
+            status_codes_[code].fetch_add(1, std::memory_order_relaxed);
+            auto outcome = static_cast<std::size_t>(outcome_of(code));
+            outcome_histograms_[outcome].record(latency);
+            outcome_latency_us_[outcome].fetch_add(latency, std::memory_order_relaxed);
 
-            metrics_.status_codes[response.status_code]++;
+            if (code_histograms_) {
+                // First response with this code installs its histogram, a losing racer frees its copy
+                AtomicHistogram* histogram = code_histograms_[code].load(std::memory_order_acquire);
+                if (histogram == nullptr) {
+                    auto created = std::make_unique<AtomicHistogram>();
+                    if (code_histograms_[code].compare_exchange_strong(histogram, created.get(), std::memory_order_acq_rel)) {
+                        histogram = created.release();
+                    }
+                }
+                histogram->record(latency);
+            }
         } else {
-            metrics_.failed_requests++;
+            failed_requests_.fetch_add(1, std::memory_order_relaxed);
+
+            // Only requests that got as far as connecting have a meaningful time to failure
+            if (result.connect_attempted) {
+                auto failed = static_cast<std::size_t>(Outcome::Failed);
+                auto latency = static_cast<std::uint64_t>(result.latency.count());
+                outcome_histograms_[failed].record(latency);
+                outcome_latency_us_[failed].fetch_add(latency, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Collector::record_connection(const http::Result& result) {
+        if (result.connected) {
+            connections_opened_.fetch_add(1, std::memory_order_relaxed);
+            total_connect_us_.fetch_add(static_cast<std::uint64_t>(result.connect_time.count()), std::memory_order_relaxed);
+        } else if (result.connect_attempted) {
+            connect_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Names are matched against the published slots first, so known names never take the lock
+    void Collector::record_server_timings(const http::Result& result, std::uint64_t latency) {
+        for (std::size_t i = 0; i < result.server_timing_count; ++i) {
+            const http::ServerTiming& timing = result.server_timings[i];
+            auto micros = static_cast<std::uint64_t>(std::max(timing.milliseconds, 0.0) * 1000.0);
+
+            ServerMetric* metric = nullptr;
+            std::size_t count = server_metric_count_.load(std::memory_order_acquire);
+            for (std::size_t slot = 0; slot < count && metric == nullptr; ++slot) {
+                if (server_metrics_[slot]->name == timing.name) {
+                    metric = server_metrics_[slot].get();
+                }
+            }
+
+            if (metric == nullptr) {
+                std::lock_guard lock(server_metric_mutex_);
+                count = server_metric_count_.load(std::memory_order_relaxed);
+                for (std::size_t slot = 0; slot < count && metric == nullptr; ++slot) {
+                    if (server_metrics_[slot]->name == timing.name) {
+                        metric = server_metrics_[slot].get();
+                    }
+                }
+                if (metric == nullptr && count < MAX_SERVER_METRICS) {
+                    server_metrics_[count] = std::make_unique<ServerMetric>();
+                    server_metrics_[count]->name = timing.name;
+                    metric = server_metrics_[count].get();
+                    server_metric_count_.store(count + 1, std::memory_order_release);
+                }
+            }
+
+            if (metric != nullptr) {
+                metric->histogram.record(micros);
+            }
+        }
+
+        if (result.server_time_ms >= 0.0) {
+            auto server = static_cast<std::uint64_t>(result.server_time_ms * 1000.0);
+            outside_server_histogram_.record(latency > server ? latency - server : 0);
         }
     }
 
     Metrics Collector::get_metrics() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return metrics_;
+        Metrics metrics;
+
+        metrics.total_requests = total_requests_.load(std::memory_order_relaxed);
+        metrics.successful_requests = successful_requests_.load(std::memory_order_relaxed);
+        metrics.failed_requests = failed_requests_.load(std::memory_order_relaxed);
+        metrics.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+        metrics.bytes_received = bytes_received_.load(std::memory_order_relaxed);
+        metrics.connections_opened = connections_opened_.load(std::memory_order_relaxed);
+        metrics.connect_failures = connect_failures_.load(std::memory_order_relaxed);
+        metrics.total_connect_time = std::chrono::microseconds(total_connect_us_.load(std::memory_order_relaxed));
+
+        metrics.latency_histogram = latency_histogram_.snapshot();
+        metrics.total_latency = std::chrono::microseconds(total_latency_us_.load(std::memory_order_relaxed));
+        if (metrics.latency_histogram.count() > 0) {
+            metrics.min_latency = std::chrono::microseconds(metrics.latency_histogram.min());
+            metrics.max_latency = std::chrono::microseconds(metrics.latency_histogram.max());
+        }
+
+        for (std::uint16_t code = 0; code <= MAX_STATUS_CODE; ++code) {
+            std::uint64_t count = status_codes_[code].load(std::memory_order_relaxed);
+            if (count > 0) {
+                metrics.status_codes[code] = count;
+            }
+        }
+
+        for (std::size_t i = 0; i < OUTCOME_COUNT; ++i) {
+            metrics.outcome_histograms[i] = outcome_histograms_[i].snapshot();
+            metrics.outcome_latency_us[i] = outcome_latency_us_[i].load(std::memory_order_relaxed);
+        }
+        metrics.first_byte_histogram = first_byte_histogram_.snapshot();
+        metrics.transfer_rate_histogram = transfer_rate_histogram_.snapshot();
+        metrics.network_histogram = network_histogram_.snapshot();
+        metrics.read_delay_histogram = read_delay_histogram_.snapshot();
+
+        std::size_t server_metrics = server_metric_count_.load(std::memory_order_acquire);
+        for (std::size_t slot = 0; slot < server_metrics; ++slot) {
+            metrics.server_timing_histograms.emplace(server_metrics_[slot]->name, server_metrics_[slot]->histogram.snapshot());
+        }
+        metrics.outside_server_histogram = outside_server_histogram_.snapshot();
+
+        metrics.compressed_responses = compressed_responses_.load(std::memory_order_relaxed);
+        metrics.body_wire_bytes = body_wire_bytes_.load(std::memory_order_relaxed);
+        metrics.body_decoded_bytes = body_decoded_bytes_.load(std::memory_order_relaxed);
+        metrics.decode_histogram = decode_histogram_.snapshot();
+
+        if (code_histograms_) {
+            for (std::uint16_t code = 0; code <= MAX_STATUS_CODE; ++code) {
+                if (const AtomicHistogram* histogram = code_histograms_[code].load(std::memory_order_acquire)) {
+                    metrics.code_histograms.emplace(code, histogram->snapshot());
+                }
+            }
+        }
+
+        metrics.test_duration = std::chrono::microseconds(test_duration_us_.load(std::memory_order_relaxed));
+
+        return metrics;
+    }
+
+    std::uint64_t Collector::in_flight() const {
+        return in_flight_.load(std::memory_order_relaxed);
+    }
+
+    void Collector::connection_held() {
+        long_lived_.store(true, std::memory_order_relaxed);
+        held_connections_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Collector::connection_released() {
+        held_connections_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t Collector::open_connections() const {
+        return long_lived_.load(std::memory_order_relaxed)
+            ? held_connections_.load(std::memory_order_relaxed)
+            : in_flight_.load(std::memory_order_relaxed);
     }
 
     void Collector::set_duration(std::chrono::microseconds duration) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        metrics_.test_duration = duration;
+        test_duration_us_.store(duration.count(), std::memory_order_relaxed);
     }
 
     Percentiles Collector::calculate_percentiles() const {
-        std::vector<std::uint64_t> latencies_copy;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            latencies_copy = metrics_.latencies_us;
-        }
-
-        return Histogram::calculate(latencies_copy);
+        return latency_histogram_.snapshot().percentiles();
     }
-}
\ No newline at end of file
+}
@@ -1,35 +1,123 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include "stats/histogram.hpp"
 #include "stats/metrics.hpp"
-#include "http/response.hpp"
+#include "http/result.hpp"
 
 namespace surge::stats {
-    // Thread safe stats collector
+    // Thread safe, lock free stats collector
     // Workers call record() to add results
-    // Main thread calls get_metrics() to retrieve aggregated stats
+    // Main thread (or the metrics endpoint) calls get_metrics() for a snapshot
     class Collector {
         public:
-            // Constructor
-            Collector();
+            // Status codes above this are counted as MAX_STATUS_CODE
+            static constexpr std::uint16_t MAX_STATUS_CODE = 999;
 
-            // Record a single request result
-            void record(const http::Response& response);
+            // per_code_latency: also keep a latency histogram per exact status code
+            explicit Collector(bool per_code_latency = false);
+            ~Collector();
 
-            // Get aggregated metrics 
+            // Disable copy
+            Collector(const Collector&) = delete;
+            Collector& operator=(const Collector&) = delete;
+
+            // Mark a request as started (in flight until recorded)
+            void request_started();
+
+            // Record a single request result, every result must follow a request_started()
+            void record(const http::Result& result);
+
+            // Drop a started request without recording it (finished after the run ended)
+            void request_abandoned();
+
+            // Count only the connection a result opened (or failed to), for long lived connections
+            void record_connection(const http::Result& result);
+
+            // A long lived connection (WebSocket) was opened / closed, for open_connections()
+            void connection_held();
+            void connection_released();
+
+            // Get aggregated metrics, never blocks recording threads
             Metrics get_metrics() const;
 
+            // Requests currently in flight
+            std::uint64_t in_flight() const;
+
+            // Connections open now: the held long lived connections once there are any,
+            // else one per request in flight (each request opens and closes its own)
+            std::uint64_t open_connections() const;
+
             // Set test duration (set after test completes)
             void set_duration(std::chrono::microseconds duration);
 
-            // Calculate percentiles from collected latencies
-            // Call at the end, expensive operation
+            // Calculate percentiles from the latency histogram
             Percentiles calculate_percentiles() const;
+
+            // Distinct Server-Timing names tracked, later names are dropped
+            static constexpr std::size_t MAX_SERVER_METRICS = 16;
         
         private:
-            // Protect all shared state
-            mutable std::mutex mutex_;
-            Metrics metrics_;
+            // One Server-Timing name, registered on first sight and never removed
+            struct ServerMetric {
+                std::string name;
+                AtomicHistogram histogram;
+            };
+
+            void record_server_timings(const http::Result& result, std::uint64_t latency);
+
+            // Request counts
+            std::atomic<std::uint64_t> total_requests_{0};
+            std::atomic<std::uint64_t> successful_requests_{0};
+            std::atomic<std::uint64_t> failed_requests_{0};
+            std::atomic<std::uint64_t> in_flight_{0};
+
+            // Bytes
+            std::atomic<std::uint64_t> bytes_sent_{0};
+            std::atomic<std::uint64_t> bytes_received_{0};
+
+            // Connections
+            std::atomic<std::uint64_t> connections_opened_{0};
+            std::atomic<std::uint64_t> connect_failures_{0};
+            std::atomic<std::uint64_t> total_connect_us_{0};
+            std::atomic<std::uint64_t> held_connections_{0};
+            std::atomic<bool> long_lived_{false};
+
+            // Timings (μs)
+            std::atomic<std::uint64_t> total_latency_us_{0};
+            AtomicHistogram latency_histogram_;
+            std::array<AtomicHistogram, OUTCOME_COUNT> outcome_histograms_;
+            std::array<std::atomic<std::uint64_t>, OUTCOME_COUNT> outcome_latency_us_{};
+            AtomicHistogram first_byte_histogram_;
+            AtomicHistogram transfer_rate_histogram_;
+            AtomicHistogram network_histogram_;
+            AtomicHistogram read_delay_histogram_;
+            AtomicHistogram outside_server_histogram_;
+
+            // Body decoding (--compressed)
+            std::atomic<std::uint64_t> compressed_responses_{0};
+            std::atomic<std::uint64_t> body_wire_bytes_{0};
+            std::atomic<std::uint64_t> body_decoded_bytes_{0};
+            AtomicHistogram decode_histogram_;
+
+            // Slots below server_metric_count_ are published and read without locking,
+            // the mutex only serialises registering a new name
+            std::array<std::unique_ptr<ServerMetric>, MAX_SERVER_METRICS> server_metrics_;
+            std::atomic<std::size_t> server_metric_count_{0};
+            std::mutex server_metric_mutex_;
+
+            // Created on a code's first response and never removed, null when per code latency is off
+            std::unique_ptr<std::atomic<AtomicHistogram*>[]> code_histograms_;
+            std::atomic<std::int64_t> test_duration_us_{0};
+
+            // Count per status code, indexed by code
+            std::array<std::atomic<std::uint64_t>, MAX_STATUS_CODE + 1> status_codes_{};
     };
-}
\ No newline at end of file
+}
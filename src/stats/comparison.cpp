@@ -0,0 +1,142 @@
+#include "stats/comparison.hpp"
+#include "stats/histogram.hpp"
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <iomanip>
+#include <string>
+
+namespace surge::stats {
+    namespace {
+        double percent_change(double baseline, double current) {
+            if (baseline == 0.0) {
+                return current == 0.0 ? 0.0 : 100.0;
+            }
+            return (current - baseline) * 100.0 / baseline;
+        }
+
+        double error_rate(const RunSummary& run) {
+            if (run.total_requests == 0) {
+                return 0.0;
+            }
+            return run.failed_requests * 100.0 / run.total_requests;
+        }
+
+        std::string describe(const char* what, double value, const char* unit, double limit) {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2) << what << " " << value << unit << " (limit " << limit << unit << ")";
+            return oss.str();
+        }
+    }
+
+    MannWhitneyResult mann_whitney(const Histogram& baseline, const Histogram& current) {
+        MannWhitneyResult result;
+
+        const double n_base = static_cast<double>(baseline.count());
+        const double n_curr = static_cast<double>(current.count());
+        if (n_base == 0.0 || n_curr == 0.0) {
+            return result;
+        }
+        const double n = n_base + n_curr;
+
+        // Rank sum of the current run, every bucket is one tie group
+        double rank_sum = 0.0;
+        double tie_correction = 0.0;
+        double ranks_before = 0.0;
+        for (std::size_t i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+            double from_base = static_cast<double>(baseline.count_at(i));
+            double from_curr = static_cast<double>(current.count_at(i));
+            double tied = from_base + from_curr;
+            if (tied == 0.0) {
+                continue;
+            }
+
+            double average_rank = ranks_before + (tied + 1.0) / 2.0;
+            rank_sum += from_curr * average_rank;
+            tie_correction += tied * tied * tied - tied;
+            ranks_before += tied;
+        }
+
+        result.u = rank_sum - n_curr * (n_curr + 1.0) / 2.0;
+        result.prob_slower = result.u / (n_base * n_curr);
+
+        double mean = n_base * n_curr / 2.0;
+        double variance = n_base * n_curr / 12.0 * ((n + 1.0) - tie_correction / (n * (n - 1.0)));
+        if (variance <= 0.0) {
+            // Every sample in one bucket, distributions are indistinguishable
+            return result;
+        }
+
+        // Continuity correction towards the mean
+        double diff = result.u - mean;
+        double corrected = diff > 0.0 ? diff - 0.5 : (diff < 0.0 ? diff + 0.5 : 0.0);
+
+        result.z = corrected / std::sqrt(variance);
+        result.p_value = std::erfc(std::fabs(result.z) / std::sqrt(2.0));
+        return result;
+    }
+
+    Comparison compare(const RunSummary& baseline, const RunSummary& current, const RegressionThresholds& thresholds) {
+        Comparison comparison;
+
+        struct Point {
+            const char* label;
+            double percentile;
+            bool gated;
+        };
+        constexpr Point points[] = {
+            {"p50", 0.50, true},
+            {"p75", 0.75, false},
+            {"p90", 0.90, true},
+            {"p95", 0.95, false},
+            {"p99", 0.99, true},
+            {"p99.9", 0.999, false},
+        };
+
+        for (const Point& point : points) {
+            std::uint64_t before = baseline.latency_histogram.value_at(point.percentile);
+            std::uint64_t after = current.latency_histogram.value_at(point.percentile);
+            comparison.percentiles.push_back(PercentileDelta{
+                .label = point.label,
+                .baseline_us = before,
+                .current_us = after,
+                .change_percent = percent_change(static_cast<double>(before), static_cast<double>(after)),
+                .gated = point.gated,
+            });
+        }
+
+        comparison.baseline_rps = baseline.requests_per_second;
+        comparison.current_rps = current.requests_per_second;
+        comparison.throughput_change_percent = percent_change(baseline.requests_per_second, current.requests_per_second);
+
+        comparison.baseline_error_rate = error_rate(baseline);
+        comparison.current_error_rate = error_rate(current);
+
+        comparison.test = mann_whitney(baseline.latency_histogram, current.latency_histogram);
+        comparison.significant = comparison.test.p_value < thresholds.alpha;
+
+        // Latency only counts as regressed when the shift is statistically significant
+        if (comparison.significant && comparison.test.z > 0.0) {
+            for (const PercentileDelta& delta : comparison.percentiles) {
+                if (delta.gated && delta.change_percent > thresholds.max_latency_increase_percent) {
+                    comparison.violations.push_back(
+                        describe((std::string(delta.label) + " latency increased").c_str(), delta.change_percent, "%",
+                                 thresholds.max_latency_increase_percent));
+                }
+            }
+        }
+
+        if (-comparison.throughput_change_percent > thresholds.max_throughput_drop_percent) {
+            comparison.violations.push_back(describe("Throughput dropped", -comparison.throughput_change_percent, "%",
+                                                     thresholds.max_throughput_drop_percent));
+        }
+
+        double error_increase = comparison.current_error_rate - comparison.baseline_error_rate;
+        if (error_increase > thresholds.max_error_rate_increase) {
+            comparison.violations.push_back(describe("Error rate increased by", error_increase, " pts",
+                                                     thresholds.max_error_rate_increase));
+        }
+
+        return comparison;
+    }
+}
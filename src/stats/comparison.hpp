@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "stats/histogram.hpp"
+
+namespace surge::stats {
+    // Summary of one run, as saved to / loaded from a baseline file
+    struct RunSummary {
+        std::uint64_t total_requests = 0;
+        std::uint64_t successful_requests = 0;
+        std::uint64_t failed_requests = 0;
+        double requests_per_second = 0.0;
+        Histogram latency_histogram;
+    };
+
+    // Limits that make a comparison count as a regression
+    struct RegressionThresholds {
+        // Max allowed latency increase at p50/p90/p99 (percent)
+        double max_latency_increase_percent = 10.0;
+
+        // Max allowed throughput drop (percent)
+        double max_throughput_drop_percent = 10.0;
+
+        // Max allowed error rate increase (percentage points)
+        double max_error_rate_increase = 1.0;
+
+        // Significance level for the latency distribution test
+        double alpha = 0.05;
+    };
+
+    struct PercentileDelta {
+        const char* label;
+        std::uint64_t baseline_us;
+        std::uint64_t current_us;
+        double change_percent;
+        bool gated;     // Counts towards the regression decision
+    };
+
+    // Mann-Whitney U test on two latency histograms (bucket values as ties)
+    struct MannWhitneyResult {
+        double u = 0.0;                 // U statistic of the current run
+        double z = 0.0;                 // Normal approximation, > 0 means current is slower
+        double p_value = 1.0;           // Two sided
+        double prob_slower = 0.5;       // P(current latency > baseline latency), ties count half
+    };
+
+    struct Comparison {
+        std::vector<PercentileDelta> percentiles;
+
+        double baseline_rps = 0.0;
+        double current_rps = 0.0;
+        double throughput_change_percent = 0.0;
+
+        double baseline_error_rate = 0.0;   // Percent
+        double current_error_rate = 0.0;    // Percent
+
+        MannWhitneyResult test;
+        bool significant = false;
+
+        // Threshold breaches, empty when no regression
+        std::vector<std::string> violations;
+
+        bool regression() const { return !violations.empty(); }
+    };
+
+    // Mann-Whitney U on histogram data, O(buckets)
+    MannWhitneyResult mann_whitney(const Histogram& baseline, const Histogram& current);
+
+    // Compare a run against a baseline
+    Comparison compare(const RunSummary& baseline, const RunSummary& current, const RegressionThresholds& thresholds);
+}
@@ -0,0 +1,119 @@
+#include "stats/exemplars.hpp"
+
+#include <algorithm>
+
+namespace surge::stats {
+    namespace {
+        bool slower(const Exemplar& a, const Exemplar& b) {
+            return a.latency > b.latency;
+        }
+
+        // Reservoir choice for the nth above-threshold request, a hash so admit() needs no shared RNG
+        std::uint64_t mix(std::uint64_t value) {
+            value += 0x9e3779b97f4a7c15ULL;
+            value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+            return value ^ (value >> 31);
+        }
+    }
+
+    ExemplarStore::ExemplarStore(std::size_t slowest, std::uint64_t threshold_us, std::size_t samples)
+        : slowest_capacity_(slowest),
+          threshold_us_(samples > 0 ? threshold_us : NO_THRESHOLD),
+          sample_capacity_(threshold_us_ == NO_THRESHOLD ? 0 : samples),
+          samples_(sample_capacity_),
+          sample_index_(sample_capacity_, 0)
+    {
+        slowest_.reserve(slowest_capacity_);
+        update_floor();
+    }
+
+    Admission ExemplarStore::admit(std::uint64_t latency_us) {
+        Admission admission;
+
+        admission.slowest = latency_us >= slowest_floor_.load(std::memory_order_relaxed);
+
+        // Algorithm R: the nth request replaces a random slot with probability capacity / n
+        if (latency_us >= threshold_us_) {
+            std::uint64_t index = above_threshold_.fetch_add(1, std::memory_order_relaxed);
+            admission.index = index;
+            if (index < sample_capacity_) {
+                admission.slot = static_cast<std::int64_t>(index);
+            } else {
+                std::uint64_t pick = mix(index) % (index + 1);
+                if (pick < sample_capacity_) {
+                    admission.slot = static_cast<std::int64_t>(pick);
+                }
+            }
+        }
+        if (admission) {
+            admission.id = next_id_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return admission;
+    }
+
+    void ExemplarStore::keep(const Admission& admission, Exemplar exemplar) {
+        std::lock_guard lock(mutex_);
+
+        if (admission.slot >= 0) {
+            auto slot = static_cast<std::size_t>(admission.slot);
+            // A later request may have taken the slot first, the later one stays
+            if (!samples_[slot] || sample_index_[slot] < admission.index) {
+                Exemplar sample = exemplar;
+                sample.sampled = true;
+                samples_[slot] = std::move(sample);
+                sample_index_[slot] = admission.index;
+            }
+        }
+
+        if (admission.slowest) {
+            exemplar.slowest = true;
+            if (slowest_.size() < slowest_capacity_) {
+                slowest_.push_back(std::move(exemplar));
+                std::push_heap(slowest_.begin(), slowest_.end(), slower);
+            } else if (exemplar.latency > slowest_.front().latency) {
+                std::pop_heap(slowest_.begin(), slowest_.end(), slower);
+                slowest_.back() = std::move(exemplar);
+                std::push_heap(slowest_.begin(), slowest_.end(), slower);
+            }
+            update_floor();
+        }
+    }
+
+    // Called with the lock held (or from the constructor)
+    void ExemplarStore::update_floor() {
+        std::uint64_t slowest_floor = NO_THRESHOLD;
+        if (slowest_capacity_ > 0) {
+            slowest_floor = slowest_.size() < slowest_capacity_
+                ? 0
+                : static_cast<std::uint64_t>(slowest_.front().latency.count()) + 1;
+        }
+        slowest_floor_.store(slowest_floor, std::memory_order_relaxed);
+        floor_.store(std::min(slowest_floor, threshold_us_), std::memory_order_relaxed);
+    }
+
+    std::vector<Exemplar> ExemplarStore::take() {
+        std::lock_guard lock(mutex_);
+
+        std::vector<Exemplar> result = std::move(slowest_);
+        slowest_.clear();
+        for (auto& sample : samples_) {
+            if (!sample) {
+                continue;
+            }
+            auto same = std::find_if(result.begin(), result.end(), [&](const Exemplar& kept) {
+                return kept.id == sample->id;
+            });
+            if (same != result.end()) {
+                same->sampled = true;
+            } else {
+                result.push_back(std::move(*sample));
+            }
+            sample.reset();
+        }
+
+        std::sort(result.begin(), result.end(), slower);
+        update_floor();
+        return result;
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace surge::stats {
+    // One slow request kept in full, for the trace export and the report
+    struct Exemplar {
+        std::uint64_t id = 0;               // Admission::id, unique per kept request
+        std::chrono::system_clock::time_point started;  // Wall clock, to line up with server traces
+        std::uint32_t worker = 0;
+        std::uint64_t connection = 0;       // The worker's nth connection (every request opens its own)
+        std::uint16_t local_port = 0;
+        std::uint64_t sequence = 0;         // {{seq}} of a templated request, 0 when unused
+
+        std::string method;
+        std::string url;
+        std::string request_headers;        // Extra headers as sent ("Name: value\r\n"...)
+        std::string response_head;          // Status line and headers, empty without a response
+
+        std::uint16_t status_code = 0;
+        bool success = false;
+        const char* error = nullptr;
+
+        // Phases: connect [0, connect_time), wait [connect_time, first_byte), receive [first_byte, latency)
+        bool connected = false;
+        std::chrono::microseconds connect_time{0};
+        std::chrono::microseconds first_byte{0};
+        std::chrono::microseconds latency{0};
+        std::chrono::microseconds decode_time{0};   // After receive, not part of latency
+
+        // Kernel timestamps, split of the wait
+        bool timestamped = false;
+        std::chrono::microseconds network_time{0};
+        std::chrono::microseconds read_delay{0};
+
+        std::uint64_t bytes_sent = 0;
+        std::uint64_t bytes_received = 0;
+        double server_time_ms = -1.0;
+
+        // Why it was kept, both can be set
+        bool slowest = false;
+        bool sampled = false;
+    };
+
+    // What ExemplarStore::admit() decided for one request
+    struct Admission {
+        bool slowest = false;               // May be among the slowest, checked again by keep()
+        std::int64_t slot = -1;             // Reservoir slot of the above-threshold sample, -1 = none
+        std::uint64_t index = 0;            // Order among above-threshold requests
+        std::uint64_t id = 0;               // Identifies the request in both lists
+
+        explicit operator bool() const { return slowest || slot >= 0; }
+    };
+
+    // Bounded exemplar reservoir shared by the workers
+    // Keeps the `slowest` slowest requests, plus a uniform sample of `samples` requests
+    // among those at or above threshold_us (reservoir sampling)
+    // Workers compare each latency with floor() (one relaxed load), only requests at or
+    // above it call admit(), and only admitted requests are copied and take the lock
+    class ExemplarStore {
+        public:
+            static constexpr std::uint64_t NO_THRESHOLD = std::numeric_limits<std::uint64_t>::max();
+
+            ExemplarStore(std::size_t slowest, std::uint64_t threshold_us, std::size_t samples);
+
+            // Disable copy
+            ExemplarStore(const ExemplarStore&) = delete;
+            ExemplarStore& operator=(const ExemplarStore&) = delete;
+
+            // Smallest latency that could be kept
+            std::uint64_t floor() const { return floor_.load(std::memory_order_relaxed); }
+
+            // Decide whether a request at or above floor() is kept, counts above-threshold requests
+            Admission admit(std::uint64_t latency_us);
+
+            // Store an admitted request
+            void keep(const Admission& admission, Exemplar exemplar);
+
+            // Kept exemplars, slowest first, a request kept for both reasons appears once
+            std::vector<Exemplar> take();
+
+            // Requests seen at or above the threshold
+            std::uint64_t above_threshold() const { return above_threshold_.load(std::memory_order_relaxed); }
+
+            std::uint64_t threshold_us() const { return threshold_us_; }
+
+        private:
+            void update_floor();
+
+            std::size_t slowest_capacity_;
+            std::uint64_t threshold_us_;
+            std::size_t sample_capacity_;
+
+            std::atomic<std::uint64_t> floor_{0};
+            std::atomic<std::uint64_t> slowest_floor_{0};
+            std::atomic<std::uint64_t> above_threshold_{0};
+            std::atomic<std::uint64_t> next_id_{1};
+
+            std::mutex mutex_;
+            std::vector<Exemplar> slowest_;                 // Min-heap on latency
+            std::vector<std::optional<Exemplar>> samples_;  // Reservoir slots
+            std::vector<std::uint64_t> sample_index_;       // Admission index of each slot's occupant
+    };
+}
@@ -1,65 +1,274 @@
 #pragma once
 
+#include <bit>
 #include <cstddef>
 #include <vector>
 #include <cstdint>
 #include <algorithm>
-#include "stats/metrics.hpp"
+#include <atomic>
 
 namespace surge::stats {
+    struct Percentiles {
+        std::uint64_t p50;
+        std::uint64_t p75;
+        std::uint64_t p90;
+        std::uint64_t p95;
+        std::uint64_t p99;
+        std::uint64_t p999;
+    };
+
+    // Log-linear latency histogram (HdrHistogram style)
+    // Values below 128 are exact, above that each power of two is split
+    // into 64 sub buckets, so any recorded value is within ~0.8% of its bucket midpoint
+    // Fixed size - recording never allocates
     class Histogram {
         public:
-            // Calculate percentiles from unsorted latencies
-            static Percentiles calculate(std::vector<std::uint64_t> latencies) {
+            static constexpr std::size_t SUB_BUCKET_BITS = 7;
+            static constexpr std::size_t SUB_BUCKET_COUNT = std::size_t{1} << SUB_BUCKET_BITS;     // 128
+            static constexpr std::size_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;                   // 64
+            static constexpr std::size_t MAX_MAGNITUDE = 35;    // Values clamp at 2^36 - 1 (~19 hours in μs)
+            static constexpr std::size_t BUCKET_COUNT =
+                SUB_BUCKET_COUNT + (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKET_HALF;
+            static constexpr std::uint64_t MAX_VALUE = (std::uint64_t{1} << (MAX_MAGNITUDE + 1)) - 1;
+
+            Histogram() : counts_(BUCKET_COUNT, 0) {}
+
+            // Record a value (count times)
+            void record(std::uint64_t value, std::uint64_t count = 1) {
+                counts_[bucket_index(value)] += count;
+                total_ += count;
+                min_ = std::min(min_, value);
+                max_ = std::max(max_, value);
+            }
+
+            // Add all counts from another histogram
+            void merge(const Histogram& other) {
+                for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+                    counts_[i] += other.counts_[i];
+                }
+                total_ += other.total_;
+                min_ = std::min(min_, other.min_);
+                max_ = std::max(max_, other.max_);
+            }
+
+            // Remove counts of an earlier snapshot of this histogram (interval deltas)
+            // Min/max keep the cumulative extremes
+            void subtract(const Histogram& earlier) {
+                for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+                    counts_[i] -= std::min(counts_[i], earlier.counts_[i]);
+                }
+                total_ -= std::min(total_, earlier.total_);
+            }
+
+            void reset() {
+                std::fill(counts_.begin(), counts_.end(), 0);
+                total_ = 0;
+                min_ = UINT64_MAX;
+                max_ = 0;
+            }
+
+            std::uint64_t count() const { return total_; }
+
+            // Exact extremes of recorded values (0 when empty)
+            std::uint64_t min() const { return total_ == 0 ? 0 : min_; }
+            std::uint64_t max() const { return max_; }
+
+            std::uint64_t count_at(std::size_t index) const { return counts_[index]; }
+
+            // Set a raw bucket count (used when loading saved histograms)
+            void set_count_at(std::size_t index, std::uint64_t count) {
+                total_ -= counts_[index];
+                counts_[index] = count;
+                total_ += count;
+                if (count != 0) {
+                    min_ = std::min(min_, bucket_lowest(index));
+                    max_ = std::max(max_, bucket_highest(index));
+                }
+            }
+
+            // Number of values recorded at or below value (bucket resolution)
+            std::uint64_t count_at_or_below(std::uint64_t value) const {
+                std::size_t last = bucket_index(value);
+                std::uint64_t seen = 0;
+                for (std::size_t i = 0; i <= last; ++i) {
+                    seen += counts_[i];
+                }
+                return seen;
+            }
+
+            // Value at percentile (0.0 - 1.0), 0 when empty
+            std::uint64_t value_at(double percentile) const {
+                if (total_ == 0) {
+                    return 0;
+                }
+
+                // Rank of the wanted sample (1 based)
+                auto rank = static_cast<std::uint64_t>(percentile * static_cast<double>(total_) + 0.5);
+                rank = std::clamp<std::uint64_t>(rank, 1, total_);
+
+                std::uint64_t seen = 0;
+                for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+                    seen += counts_[i];
+                    if (seen >= rank) {
+                        // min_ > max_ only if the extremes were never set, then there is nothing to clamp to
+                        return min_ <= max_ ? std::clamp(bucket_value(i), min_, max_) : bucket_value(i);
+                    }
+                }
+                return max_;
+            }
+
+            Percentiles percentiles() const {
                 Percentiles result{};
 
-                if (latencies.empty()) {
+                if (total_ == 0) {
                     return result;
                 }
 
-                std::sort(latencies.begin(), latencies.end());
-
-                // Calculate each percentile
-                result.p50 = percentile_at(latencies, 0.50);
-                result.p75 = percentile_at(latencies, 0.75);
-                result.p90 = percentile_at(latencies, 0.90);
-                result.p95 = percentile_at(latencies, 0.95);
-                result.p99 = percentile_at(latencies, 0.99);
-                result.p999 = percentile_at(latencies, 0.999);
+                result.p50 = value_at(0.50);
+                result.p75 = value_at(0.75);
+                result.p90 = value_at(0.90);
+                result.p95 = value_at(0.95);
+                result.p99 = value_at(0.99);
+                result.p999 = value_at(0.999);
 
                 return result;
             }
 
-        private:
-            // Get value at each percentile from sorted array
+            // Mean of the recorded values (bucket midpoints)
+            double mean() const {
+                if (total_ == 0) {
+                    return 0.0;
+                }
+                double sum = 0.0;
+                for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+                    if (counts_[i] != 0) {
+                        sum += static_cast<double>(counts_[i]) * static_cast<double>(bucket_value(i));
+                    }
+                }
+                return sum / static_cast<double>(total_);
+            }
 
-            static std::uint64_t percentile_at(const std::vector<std::uint64_t>& sorted_values, double percentile) {
-                if (sorted_values.empty()) {
-                    return 0;
+            // Map a value to its bucket
+            static std::size_t bucket_index(std::uint64_t value) {
+                value = std::min(value, MAX_VALUE);
+                if (value < SUB_BUCKET_COUNT) {
+                    return static_cast<std::size_t>(value);
                 }
 
-                // Calculate the index
-                double index = percentile * (sorted_values.size() - 1);
+                // Magnitude = floor(log2(value)), always >= SUB_BUCKET_BITS here
+                std::size_t magnitude = static_cast<std::size_t>(std::bit_width(value)) - 1;
+                std::size_t shift = magnitude - (SUB_BUCKET_BITS - 1);
+                std::size_t sub = static_cast<std::size_t>(value >> shift) - SUB_BUCKET_HALF;
+
+                return SUB_BUCKET_COUNT + (magnitude - SUB_BUCKET_BITS) * SUB_BUCKET_HALF + sub;
+            }
 
-                // Get lower and upper indices
-                size_t lower = static_cast<size_t>(index);
-                size_t upper = lower + 1;
+            // Lowest value that maps to a bucket
+            static std::uint64_t bucket_lowest(std::size_t index) {
+                if (index < SUB_BUCKET_COUNT) {
+                    return index;
+                }
+                std::size_t offset = index - SUB_BUCKET_COUNT;
+                std::size_t magnitude = offset / SUB_BUCKET_HALF + SUB_BUCKET_BITS;
+                std::size_t shift = magnitude - (SUB_BUCKET_BITS - 1);
+                std::uint64_t sub = offset % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+                return sub << shift;
+            }
 
-                // If index is exact just return results
-                if (upper >= sorted_values.size()) {
-                    return sorted_values[lower];
+            // Highest value that maps to a bucket
+            static std::uint64_t bucket_highest(std::size_t index) {
+                if (index < SUB_BUCKET_COUNT) {
+                    return index;
                 }
+                std::size_t magnitude = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + SUB_BUCKET_BITS;
+                std::size_t shift = magnitude - (SUB_BUCKET_BITS - 1);
+                return bucket_lowest(index) + (std::uint64_t{1} << shift) - 1;
+            }
+
+            // Representative value reported for a bucket (midpoint)
+            static std::uint64_t bucket_value(std::size_t index) {
+                std::uint64_t low = bucket_lowest(index);
+                return low + (bucket_highest(index) - low) / 2;
+            }
 
-                // Linear interpolation between values
-                double fraction = index - lower;
+        private:
+            friend class AtomicHistogram;
+
+            std::vector<std::uint64_t> counts_;
+            std::uint64_t total_ = 0;
+            std::uint64_t min_ = UINT64_MAX;
+            std::uint64_t max_ = 0;
+    };
 
-                std::uint64_t lower_value = sorted_values[lower];
-                std::uint64_t upper_value = sorted_values[upper];
+    // Histogram that many threads record into without locking
+    // Readers take a Histogram snapshot, counts may be mid-update but never torn
+    class AtomicHistogram {
+        public:
+            AtomicHistogram() : counts_(Histogram::BUCKET_COUNT) {}
 
-                // Interpolate: lower + fraction * (upper - lower)
-                return static_cast<std::uint64_t>(
-                    lower_value + fraction * (upper_value - lower_value)
-                );
+            // Disable copy
+            AtomicHistogram(const AtomicHistogram&) = delete;
+            AtomicHistogram& operator=(const AtomicHistogram&) = delete;
+
+            void record(std::uint64_t value) {
+                counts_[Histogram::bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+                total_.fetch_add(1, std::memory_order_relaxed);
+
+                std::uint64_t current = min_.load(std::memory_order_relaxed);
+                while (value < current && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+
+                current = max_.load(std::memory_order_relaxed);
+                while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
             }
+
+            std::uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+
+            // Copy current counts into a plain histogram
+            Histogram snapshot() const {
+                Histogram result;
+                std::uint64_t total = 0;
+                for (std::size_t i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+                    result.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+                    total += result.counts_[i];
+                }
+                result.total_ = total;
+                result.min_ = min_.load(std::memory_order_relaxed);
+                result.max_ = max_.load(std::memory_order_relaxed);
+
+                // A record() in flight may have counted its value but not yet moved min/max,
+                // widen them to the non-empty buckets so they always cover the counts
+                if (total > 0) {
+                    std::size_t first = 0;
+                    while (result.counts_[first] == 0) {
+                        ++first;
+                    }
+                    std::size_t last = Histogram::BUCKET_COUNT - 1;
+                    while (result.counts_[last] == 0) {
+                        --last;
+                    }
+                    if (result.min_ > Histogram::bucket_highest(first)) {
+                        result.min_ = Histogram::bucket_lowest(first);
+                    }
+                    if (result.max_ < Histogram::bucket_lowest(last)) {
+                        result.max_ = Histogram::bucket_highest(last);
+                    }
+                }
+                return result;
+            }
+
+            void reset() {
+                for (auto& count : counts_) {
+                    count.store(0, std::memory_order_relaxed);
+                }
+                total_.store(0, std::memory_order_relaxed);
+                min_.store(UINT64_MAX, std::memory_order_relaxed);
+                max_.store(0, std::memory_order_relaxed);
+            }
+
+        private:
+            std::vector<std::atomic<std::uint64_t>> counts_;
+            std::atomic<std::uint64_t> total_{0};
+            std::atomic<std::uint64_t> min_{UINT64_MAX};
+            std::atomic<std::uint64_t> max_{0};
     };
-}
\ No newline at end of file
+}
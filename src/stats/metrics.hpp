@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <chrono>
 #include <string>
 #include <map>
-#include <vector>
+#include "stats/histogram.hpp"
 
 namespace surge::stats {
     struct RequestResult {
@@ -21,12 +24,37 @@ namespace surge::stats {
         {}
     };
 
+    // What a request ended with, latency is kept separately for each
+    // Failed = no valid response, its latency is the time until the error
+    enum class Outcome : std::size_t { Status1xx, Status2xx, Status3xx, Status4xx, Status5xx, Failed };
+    inline constexpr std::size_t OUTCOME_COUNT = 6;
+
+    inline const char* to_string(Outcome outcome) {
+        constexpr const char* NAMES[OUTCOME_COUNT] = {"1xx", "2xx", "3xx", "4xx", "5xx", "failed"};
+        return NAMES[static_cast<std::size_t>(outcome)];
+    }
+
+    // Status class of a response, codes outside 100-599 fall into the nearest class
+    inline Outcome outcome_of(std::uint16_t status_code) {
+        std::size_t status_class = std::clamp<std::size_t>(status_code / 100, 1, 5);
+        return static_cast<Outcome>(status_class - 1);
+    }
+
     struct Metrics {
         // Request counts
         std::uint64_t total_requests = 0;
         std::uint64_t successful_requests = 0;
         std::uint64_t failed_requests = 0;
 
+        // Bytes on the wire, all requests
+        std::uint64_t bytes_sent = 0;
+        std::uint64_t bytes_received = 0;
+
+        // Connections
+        std::uint64_t connections_opened = 0;
+        std::uint64_t connect_failures = 0;
+        std::chrono::microseconds total_connect_time{0};
+
         // Timings
         std::chrono::microseconds total_latency{0};
         std::chrono::microseconds min_latency{std::chrono::microseconds::max()};
@@ -35,19 +63,36 @@ namespace surge::stats {
         // Status Codes
         std::map<std::uint16_t, std::uint64_t> status_codes;
 
-        // Individual latencies for percentile calculations
-        std::vector<std::uint64_t> latencies_us;
+        // Latency distribution (μs) for percentile calculations
+        Histogram latency_histogram;
+
+        // Latency by outcome (indexed by Outcome), so fast errors do not hide in the overall percentiles
+        std::array<Histogram, OUTCOME_COUNT> outcome_histograms;
+        std::array<std::uint64_t, OUTCOME_COUNT> outcome_latency_us{};    // Sum per outcome
+
+        // Latency per exact status code, only when enabled on the collector
+        std::map<std::uint16_t, Histogram> code_histograms;
+
+        // Time to first byte (μs) and per request transfer rate (KB/s over the whole request)
+        Histogram first_byte_histogram;
+        Histogram transfer_rate_histogram;
+
+        // From kernel timestamps (--kernel-timestamps): network + server time, and how long
+        // the response waited in the socket before the generator read it (μs)
+        Histogram network_histogram;
+        Histogram read_delay_histogram;
+
+        // Server-Timing metrics by name (μs), and client latency minus the server's own total
+        std::map<std::string, Histogram> server_timing_histograms;
+        Histogram outside_server_histogram;
+
+        // Decoded bodies (--compressed): bytes as received and after decoding, decode time (μs)
+        std::uint64_t compressed_responses = 0;
+        std::uint64_t body_wire_bytes = 0;
+        std::uint64_t body_decoded_bytes = 0;
+        Histogram decode_histogram;
 
         // Test duration
         std::chrono::microseconds test_duration{0};
     };
-
-    struct Percentiles {
-        std::uint64_t p50;
-        std::uint64_t p75;
-        std::uint64_t p90;
-        std::uint64_t p95;
-        std::uint64_t p99;
-        std::uint64_t p999;  
-    };
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "stats/path_stats.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <functional>       // std::hash
+#include <unordered_map>
+
+namespace surge::stats {
+    namespace {
+        const double GAMMA = (1.0 + LatencySketch::RELATIVE_ACCURACY) / (1.0 - LatencySketch::RELATIVE_ACCURACY);
+        const double LOG_GAMMA = std::log(GAMMA);
+
+        constexpr std::string_view ID_PLACEHOLDER = "{id}";
+
+        // 8-4-4-4-12 hex digits
+        bool is_uuid(std::string_view segment) {
+            if (segment.size() != 36) {
+                return false;
+            }
+            for (std::size_t i = 0; i < segment.size(); ++i) {
+                bool dash = i == 8 || i == 13 || i == 18 || i == 23;
+                if (dash ? segment[i] != '-' : !std::isxdigit(static_cast<unsigned char>(segment[i]))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // All digits, or a long hex string with at least one digit (hashes, object ids)
+        bool is_identifier(std::string_view segment) {
+            if (segment.empty()) {
+                return false;
+            }
+            bool digits = std::all_of(segment.begin(), segment.end(), [](char c) {
+                return std::isdigit(static_cast<unsigned char>(c));
+            });
+            if (digits) {
+                return true;
+            }
+            bool hex = segment.size() >= 8 && std::all_of(segment.begin(), segment.end(), [](char c) {
+                return std::isxdigit(static_cast<unsigned char>(c));
+            });
+            bool has_digit = std::any_of(segment.begin(), segment.end(), [](char c) {
+                return std::isdigit(static_cast<unsigned char>(c));
+            });
+            return (hex && has_digit) || is_uuid(segment);
+        }
+    }
+
+    void LatencySketch::record(std::uint64_t microseconds) {
+        std::size_t index = 0;
+        if (microseconds > 1) {
+            index = static_cast<std::size_t>(std::ceil(std::log(static_cast<double>(microseconds)) / LOG_GAMMA));
+            index = std::min(index, BUCKET_COUNT - 1);
+        }
+        counts_[index]++;
+        total_++;
+        max_ = std::max(max_, microseconds);
+    }
+
+    void LatencySketch::merge(const LatencySketch& other) {
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    void LatencySketch::clear() {
+        counts_.fill(0);
+        total_ = 0;
+        max_ = 0;
+    }
+
+    // Bucket estimate 2 * gamma^i / (gamma + 1), the point with equal relative error to both bounds
+    std::uint64_t LatencySketch::value_at(double quantile) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(total_) + 0.5);
+        rank = std::clamp<std::uint64_t>(rank, 1, total_);
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                if (i == 0) {
+                    return std::min<std::uint64_t>(1, max_);
+                }
+                auto value = static_cast<std::uint64_t>(2.0 * std::pow(GAMMA, static_cast<double>(i)) / (GAMMA + 1.0));
+                return std::min(value, max_);
+            }
+        }
+        return max_;
+    }
+
+    void normalize_path(std::string_view path, std::string& out) {
+        out.clear();
+        path = path.substr(0, path.find_first_of("?#"));
+        while (!path.empty()) {
+            std::size_t slash = path.find('/', 1);
+            std::string_view segment = path.substr(0, slash);
+            path = slash == std::string_view::npos ? std::string_view{} : path.substr(slash);
+
+            if (segment.front() == '/') {
+                out.push_back('/');
+                segment.remove_prefix(1);
+            }
+            out.append(is_identifier(segment) ? ID_PLACEHOLDER : segment);
+        }
+        if (out.empty()) {
+            out.push_back('/');
+        }
+    }
+
+    PathStats::PathStats(std::size_t capacity)
+        : capacity_(std::max<std::size_t>(capacity, 1))
+    {
+        by_count_.reserve(capacity_);
+        by_time_.reserve(capacity_);
+    }
+
+    void PathStats::record(std::string_view path, std::uint64_t latency_us) {
+        normalize_path(path, scratch_);
+        std::uint64_t hash = std::hash<std::string_view>{}(scratch_);
+        update(by_count_, hash, 1, latency_us);
+        update(by_time_, hash, std::max<std::uint64_t>(latency_us, 1), latency_us);
+    }
+
+    void PathStats::update(std::vector<Entry>& table, std::uint64_t hash, std::uint64_t weight, std::uint64_t latency_us) {
+        Entry* entry = nullptr;
+        for (Entry& candidate : table) {
+            if (candidate.hash == hash && candidate.path == scratch_) {
+                entry = &candidate;
+                break;
+            }
+        }
+
+        if (entry == nullptr) {
+            if (table.size() < capacity_) {
+                entry = &table.emplace_back();
+            } else {
+                // Space-Saving: the lightest entry makes way, its weight becomes the newcomer's error bound
+                entry = &*std::min_element(table.begin(), table.end(), [](const Entry& a, const Entry& b) {
+                    return a.weight < b.weight;
+                });
+                entry->error = entry->weight;
+                entry->count = 0;
+                entry->total_time_us = 0;
+                entry->sketch.clear();
+            }
+            entry->path.assign(scratch_);
+            entry->hash = hash;
+        }
+
+        entry->weight += weight;
+        entry->count++;
+        entry->total_time_us += latency_us;
+        entry->sketch.record(latency_us);
+    }
+
+    void PathStats::merge(const PathStats& other) {
+        merge_table(by_count_, other.by_count_, capacity_);
+        merge_table(by_time_, other.by_time_, capacity_);
+    }
+
+    void PathStats::merge_table(std::vector<Entry>& into, const std::vector<Entry>& from, std::size_t capacity) {
+        for (const Entry& incoming : from) {
+            auto existing = std::find_if(into.begin(), into.end(), [&](const Entry& entry) {
+                return entry.hash == incoming.hash && entry.path == incoming.path;
+            });
+            if (existing == into.end()) {
+                into.push_back(incoming);
+                continue;
+            }
+            existing->weight += incoming.weight;
+            existing->error += incoming.error;
+            existing->count += incoming.count;
+            existing->total_time_us += incoming.total_time_us;
+            existing->sketch.merge(incoming.sketch);
+        }
+
+        if (into.size() > capacity) {
+            std::sort(into.begin(), into.end(), [](const Entry& a, const Entry& b) {
+                return a.weight > b.weight;
+            });
+            into.resize(capacity);
+        }
+    }
+
+    std::vector<PathSummary> PathStats::summaries() const {
+        // A path in both tables is reported from the entry that has seen more of it
+        std::unordered_map<std::string_view, const Entry*> best;
+        for (const auto* table : {&by_count_, &by_time_}) {
+            for (const Entry& entry : *table) {
+                auto [it, inserted] = best.try_emplace(entry.path, &entry);
+                if (!inserted && entry.count > it->second->count) {
+                    it->second = &entry;
+                }
+            }
+        }
+
+        std::vector<PathSummary> result;
+        result.reserve(best.size());
+        for (const auto& [path, entry] : best) {
+            result.push_back(PathSummary{
+                .path = entry->path,
+                .count = entry->count,
+                .total_time_us = entry->total_time_us,
+                .p50 = entry->sketch.value_at(0.50),
+                .p99 = entry->sketch.value_at(0.99),
+                .max = entry->sketch.max(),
+                .error = entry->error,
+            });
+        }
+        return result;
+    }
+}
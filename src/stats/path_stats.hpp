@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace surge::stats {
+    // Small mergeable quantile sketch (DDSketch style) for per path latency
+    // Bucket i holds values in (gamma^(i-1), gamma^i], so a quantile is within 2%
+    // of the true value; 1μs to ~19 hours in 5 KB
+    class LatencySketch {
+        public:
+            static constexpr double RELATIVE_ACCURACY = 0.02;
+            static constexpr std::size_t BUCKET_COUNT = 640;
+
+            void record(std::uint64_t microseconds);
+            void merge(const LatencySketch& other);
+            void clear();
+
+            std::uint64_t value_at(double quantile) const;
+
+            std::uint64_t count() const { return total_; }
+            std::uint64_t max() const { return max_; }
+
+        private:
+            std::array<std::uint64_t, BUCKET_COUNT> counts_{};
+            std::uint64_t total_ = 0;
+            std::uint64_t max_ = 0;
+    };
+
+    // Per path numbers for the report, counts are lower bounds when error > 0
+    struct PathSummary {
+        std::string path;
+        std::uint64_t count = 0;
+        std::uint64_t total_time_us = 0;
+        std::uint64_t p50 = 0;
+        std::uint64_t p99 = 0;
+        std::uint64_t max = 0;
+
+        // Requests seen for other paths before this one was tracked (Space-Saving overestimate bound)
+        std::uint64_t error = 0;
+    };
+
+    // "/users/48213/orders?x=1" -> "/users/{id}/orders": numeric, hex and UUID segments become {id}
+    void normalize_path(std::string_view path, std::string& out);
+
+    // Bounded memory heavy hitters over normalised request paths (one per worker, merged at the end)
+    // Two Space-Saving tables of `capacity` entries each keep the most frequent paths and the paths
+    // with the most total time, each with its own LatencySketch. Memory is fixed whatever the number
+    // of distinct paths: an untracked path replaces the entry with the smallest weight
+    class PathStats {
+        public:
+            explicit PathStats(std::size_t capacity);
+
+            void record(std::string_view path, std::uint64_t latency_us);
+
+            // Fold another worker's tables into this one, keeping the heaviest entries
+            void merge(const PathStats& other);
+
+            // Every tracked path, from either table
+            std::vector<PathSummary> summaries() const;
+
+        private:
+            struct Entry {
+                std::string path;
+                std::uint64_t hash = 0;
+                std::uint64_t weight = 0;       // Count, or total μs
+                std::uint64_t error = 0;        // Weight inherited from the evicted entry
+                std::uint64_t count = 0;
+                std::uint64_t total_time_us = 0;
+                LatencySketch sketch;
+            };
+
+            // Space-Saving update of one table, weight = 1 (by count) or the latency (by time)
+            void update(std::vector<Entry>& table, std::uint64_t hash, std::uint64_t weight, std::uint64_t latency_us);
+
+            static void merge_table(std::vector<Entry>& into, const std::vector<Entry>& from, std::size_t capacity);
+
+            std::size_t capacity_;
+            std::vector<Entry> by_count_;
+            std::vector<Entry> by_time_;
+            std::string scratch_;       // Normalised path, capacity reused
+    };
+}
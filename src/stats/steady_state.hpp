@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <deque>
+
+namespace surge::stats {
+    // Detects steady state from per-window throughput and p50 samples
+    // Steady once the coefficient of variation of both, over the last N windows,
+    // falls below the threshold
+    class SteadyStateDetector {
+        public:
+            SteadyStateDetector(std::size_t windows, double threshold)
+                : windows_(windows)
+                , threshold_(threshold)
+            {}
+
+            // Add one window's throughput (req/s) and median latency
+            void add_window(double throughput, double p50) {
+                throughput_.push_back(throughput);
+                p50_.push_back(p50);
+                if (throughput_.size() > windows_) {
+                    throughput_.pop_front();
+                    p50_.pop_front();
+                }
+            }
+
+            bool steady() const {
+                if (throughput_.size() < windows_) {
+                    return false;
+                }
+                return variation(throughput_) < threshold_ && variation(p50_) < threshold_;
+            }
+
+            // Latest coefficients of variation (for reporting)
+            double throughput_variation() const { return variation(throughput_); }
+            double p50_variation() const { return variation(p50_); }
+
+        private:
+            // Coefficient of variation: stddev / mean
+            static double variation(const std::deque<double>& samples) {
+                if (samples.empty()) {
+                    return 0.0;
+                }
+                double mean = 0.0;
+                for (double sample : samples) {
+                    mean += sample;
+                }
+                mean /= static_cast<double>(samples.size());
+                if (mean == 0.0) {
+                    return 1.0;     // No traffic is not steady
+                }
+
+                double variance = 0.0;
+                for (double sample : samples) {
+                    variance += (sample - mean) * (sample - mean);
+                }
+                variance /= static_cast<double>(samples.size());
+                return std::sqrt(variance) / mean;
+            }
+
+            std::size_t windows_;
+            double threshold_;
+            std::deque<double> throughput_;
+            std::deque<double> p50_;
+    };
+}
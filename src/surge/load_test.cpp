@@ -0,0 +1,111 @@
+#include "surge/load_test.hpp"
+#include "cli/parser.hpp"
+
+#include <condition_variable>
+#include <thread>
+#include <utility>
+
+namespace surge {
+    bool parse_config(const std::vector<std::string>& args, Config& config) {
+        return cli::parse_arguments(args, config);
+    }
+
+    LoadTest::LoadTest(Config config)
+        : config_(std::move(config))
+    {}
+
+    void LoadTest::on_snapshot(std::chrono::milliseconds interval, std::function<void(const Snapshot&)> callback) {
+        snapshot_interval_ = std::max(interval, std::chrono::milliseconds(1));
+        on_snapshot_ = std::move(callback);
+    }
+
+    void LoadTest::on_complete(std::function<void(const Results&)> callback) {
+        on_complete_ = std::move(callback);
+    }
+
+    std::optional<Results> LoadTest::run() {
+        core::Engine engine(config_);
+        if (!engine.prepare()) {
+            return std::nullopt;
+        }
+
+        {
+            // A stop() that came before the engine existed ends this run before it starts
+            std::lock_guard lock(engine_mutex_);
+            engine_ = &engine;
+            if (stop_requested_) {
+                engine.stop();
+            }
+        }
+
+        std::jthread sampler;
+        if (on_snapshot_) {
+            sampler = std::jthread([this, &engine](std::stop_token stop_token) {
+                sample(engine, stop_token);
+            });
+        }
+
+        Results results = engine.run();
+
+        // Last snapshot is never delivered after completion
+        if (sampler.joinable()) {
+            sampler.request_stop();
+            sampler.join();
+        }
+
+        {
+            std::lock_guard lock(engine_mutex_);
+            engine_ = nullptr;
+            stop_requested_ = false;
+        }
+
+        if (on_complete_) {
+            on_complete_(results);
+        }
+        return results;
+    }
+
+    void LoadTest::stop() {
+        std::lock_guard lock(engine_mutex_);
+        stop_requested_ = true;
+        if (engine_ != nullptr) {
+            engine_->stop();
+        }
+    }
+
+    // Reads the collector's lock free snapshot, workers are never blocked
+    void LoadTest::sample(const core::Engine& engine, std::stop_token stop_token) {
+        std::mutex mutex;
+        std::condition_variable_any wake;
+        auto start = std::chrono::steady_clock::now();
+        auto next = start;
+        stats::Histogram previous;
+        std::uint64_t previous_requests = 0;
+
+        while (true) {
+            next += snapshot_interval_;
+            {
+                std::unique_lock lock(mutex);
+                if (wake.wait_until(lock, stop_token, next, [] { return false; }) || stop_token.stop_requested()) {
+                    return;
+                }
+            }
+
+            Snapshot snapshot;
+            snapshot.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            snapshot.metrics = engine.collector().get_metrics();
+            snapshot.in_flight = engine.collector().in_flight();
+
+            snapshot.interval_latency = snapshot.metrics.latency_histogram;
+            snapshot.interval_latency.subtract(previous);
+            snapshot.interval_requests = snapshot.metrics.total_requests - previous_requests;
+            snapshot.requests_per_second = static_cast<double>(snapshot.interval_requests) /
+                std::chrono::duration<double>(snapshot_interval_).count();
+
+            previous = snapshot.metrics.latency_histogram;
+            previous_requests = snapshot.metrics.total_requests;
+
+            on_snapshot_(snapshot);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "cli/config.hpp"
+#include "core/engine.hpp"
+#include "stats/histogram.hpp"
+#include "stats/metrics.hpp"
+
+namespace surge {
+    using Config = cli::Config;
+    using Results = core::Results;
+
+    // Live view of the measured window, taken every snapshot interval
+    struct Snapshot {
+        std::chrono::microseconds elapsed{0};   // Since the run started (includes warmup)
+        stats::Metrics metrics;                 // Cumulative so far
+        std::uint64_t in_flight = 0;
+
+        // Just the last interval
+        std::uint64_t interval_requests = 0;
+        stats::Histogram interval_latency;
+        double requests_per_second = 0.0;
+    };
+
+    // Parse surge command line arguments (args[0] is the program name) into config,
+    // false (error printed) if they are invalid
+    bool parse_config(const std::vector<std::string>& args, Config& config);
+
+    // Embeddable load test: build a Config in code, subscribe, run
+    // Callbacks run on a library thread and must not call run() or block for long
+    class LoadTest {
+        public:
+            explicit LoadTest(Config config);
+
+            // Disable copy
+            LoadTest(const LoadTest&) = delete;
+            LoadTest& operator=(const LoadTest&) = delete;
+
+            // Called every interval while the test runs, set before run()
+            void on_snapshot(std::chrono::milliseconds interval, std::function<void(const Snapshot&)> callback);
+
+            // Called once with the final results, before run() returns them
+            void on_complete(std::function<void(const Results&)> callback);
+
+            // Run to completion on the calling thread, nullopt (error printed) if the
+            // config is rejected (feeders, templates, body file)
+            std::optional<Results> run();
+
+            // End a running test early, safe from any thread (including callbacks)
+            // Called before run() has started its engine, the run ends as soon as it starts
+            void stop();
+
+        private:
+            void sample(const core::Engine& engine, std::stop_token stop_token);
+
+            Config config_;
+
+            std::chrono::milliseconds snapshot_interval_{1000};
+            std::function<void(const Snapshot&)> on_snapshot_;
+            std::function<void(const Results&)> on_complete_;
+
+            // Engine of the current run, guarded so stop() can race with run() starting or ending
+            std::mutex engine_mutex_;
+            core::Engine* engine_ = nullptr;
+            bool stop_requested_ = false;   // Until the run it applies to ends
+    };
+}
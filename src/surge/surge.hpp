@@ -0,0 +1,18 @@
+#pragma once
+
+// Public entry point of libsurge
+//
+//   surge::Config config;
+//   config.url = "http://127.0.0.1:8080/";
+//   config.duration_seconds = 10;
+//
+//   surge::LoadTest test(config);
+//   test.on_snapshot(std::chrono::seconds(1), [](const surge::Snapshot& s) { ... });
+//   std::optional<surge::Results> results = test.run();
+
+#include "cli/config.hpp"
+#include "core/engine.hpp"
+#include "output/reporter.hpp"
+#include "stats/comparison.hpp"
+#include "stats/metrics.hpp"
+#include "surge/load_test.hpp"
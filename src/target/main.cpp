@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cli/signals.hpp"
+#include "target/options.hpp"
+#include "target/server.hpp"
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv, argv + argc);
+
+    std::signal(SIGPIPE, SIG_IGN);
+
+    surge::target::Options options;
+    if (!surge::target::parse_arguments(args, options)) {
+        return 1;
+    }
+
+    surge::target::Server server(options);
+
+    // Block SIGINT/SIGTERM before the event loops start, so only the waiter takes them
+    surge::cli::StopSignals stop_signals([&server]() {
+        server.stop();
+    });
+
+    if (!server.start()) {
+        return 1;
+    }
+
+    unsigned threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    // Flushed, whoever started the target may be waiting on this line for the port
+    std::cout << "surge-target listening on " << options.host << ":" << server.port()
+              << " (" << threads << " threads)\n" << std::flush;
+
+    server.wait();
+
+    surge::target::ServerCounters counters = server.counters();
+    std::cout << "Connections: " << counters.connections << "\n";
+    std::cout << "Requests:    " << counters.requests << "\n";
+    std::cout << "Errors:      " << counters.errors << "\n";
+    std::cout << "Resets:      " << counters.resets << "\n";
+    std::cout << "Bytes sent:  " << counters.bytes_sent << "\n";
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include "target/options.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace surge::target {
+    namespace {
+        bool next_value(const std::vector<std::string>& args, size_t& i, std::string_view flag, std::string& out) {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Error: " << flag << " requires a value\n";
+                return false;
+            }
+            out = args[++i];
+            return true;
+        }
+
+        bool parse_number(const std::string& text, double& out) {
+            try {
+                size_t used = 0;
+                out = std::stod(text, &used);
+                return used == text.size() && out >= 0;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+
+        bool parse_fraction(const std::string& text, std::string_view flag, double& out) {
+            if (!parse_number(text, out) || out > 1.0) {
+                std::cerr << "Error: " << flag << " must be between 0 and 1\n";
+                return false;
+            }
+            return true;
+        }
+
+        bool parse_whole(const std::string& text, std::string_view flag, std::uint64_t max, std::uint64_t& out) {
+            double value = 0.0;
+            if (!parse_number(text, value) || value != static_cast<double>(static_cast<std::uint64_t>(value)) ||
+                value > static_cast<double>(max)) {
+                std::cerr << "Error: invalid value for " << flag << "\n";
+                return false;
+            }
+            out = static_cast<std::uint64_t>(value);
+            return true;
+        }
+
+        // Split "a<separator>b", false when the separator is missing
+        bool split(std::string_view text, char separator, std::string& first, std::string& second) {
+            size_t at = text.find(separator);
+            if (at == std::string_view::npos) {
+                return false;
+            }
+            first = std::string(text.substr(0, at));
+            second = std::string(text.substr(at + 1));
+            return true;
+        }
+
+        // none | fixed:<ms> | uniform:<lo>-<hi> | lognormal:<median>:<sigma>
+        bool parse_latency(const std::string& text, LatencyDistribution& out) {
+            std::string kind;
+            std::string rest;
+            if (text == "none") {
+                out = {};
+                return true;
+            }
+            if (split(text, ':', kind, rest)) {
+                std::string first;
+                std::string second;
+                if (kind == "fixed" && parse_number(rest, out.first)) {
+                    out.kind = LatencyDistribution::Kind::Fixed;
+                    return true;
+                }
+                if (kind == "uniform" && split(rest, '-', first, second) && parse_number(first, out.first) &&
+                    parse_number(second, out.second) && out.first <= out.second) {
+                    out.kind = LatencyDistribution::Kind::Uniform;
+                    return true;
+                }
+                if (kind == "lognormal" && split(rest, ':', first, second) && parse_number(first, out.first) &&
+                    parse_number(second, out.second) && out.first > 0) {
+                    out.kind = LatencyDistribution::Kind::LogNormal;
+                    return true;
+                }
+            }
+            std::cerr << "Error: invalid --latency '" << text << "' (none, fixed:<ms>, uniform:<lo>-<hi>, lognormal:<median>:<sigma>)\n";
+            return false;
+        }
+    }
+
+    bool parse_arguments(const std::vector<std::string>& args, Options& options) {
+        for (size_t i = 1; i < args.size(); ++i) {
+            std::string_view arg = args[i];
+            std::string value;
+            std::uint64_t whole = 0;
+
+            if (arg == "--help" || arg == "-h") {
+                print_usage();
+                return false;
+            }
+
+            if (arg == "--host") {
+                if (!next_value(args, i, arg, options.host)) {
+                    return false;
+                }
+            } else if (arg == "--port" || arg == "-p") {
+                if (!next_value(args, i, arg, value) || !parse_whole(value, arg, UINT16_MAX, whole)) {
+                    return false;
+                }
+                options.port = static_cast<std::uint16_t>(whole);
+            } else if (arg == "--threads" || arg == "-t") {
+                if (!next_value(args, i, arg, value) || !parse_whole(value, arg, 1024, whole)) {
+                    return false;
+                }
+                options.threads = static_cast<std::uint32_t>(whole);
+            } else if (arg == "--size") {
+                if (!next_value(args, i, arg, value)) {
+                    return false;
+                }
+                std::string low = value;
+                std::string high = value;
+                split(value, '-', low, high);
+                std::uint64_t size_min = 0;
+                std::uint64_t size_max = 0;
+                if (!parse_whole(low, arg, UINT32_MAX, size_min) || !parse_whole(high, arg, UINT32_MAX, size_max)) {
+                    return false;
+                }
+                if (size_min > size_max) {
+                    std::cerr << "Error: --size range is reversed\n";
+                    return false;
+                }
+                options.size_min = size_min;
+                options.size_max = size_max;
+            } else if (arg == "--latency") {
+                if (!next_value(args, i, arg, value) || !parse_latency(value, options.latency)) {
+                    return false;
+                }
+            } else if (arg == "--stall") {
+                std::string probability;
+                std::string milliseconds;
+                if (!next_value(args, i, arg, value)) {
+                    return false;
+                }
+                if (!split(value, ':', probability, milliseconds) || !parse_number(milliseconds, options.stall_ms)) {
+                    std::cerr << "Error: --stall expects <probability>:<ms>\n";
+                    return false;
+                }
+                if (!parse_fraction(probability, arg, options.stall_probability)) {
+                    return false;
+                }
+            } else if (arg == "--error-rate") {
+                if (!next_value(args, i, arg, value) || !parse_fraction(value, arg, options.error_rate)) {
+                    return false;
+                }
+            } else if (arg == "--error-status") {
+                if (!next_value(args, i, arg, value) || !parse_whole(value, arg, 999, whole)) {
+                    return false;
+                }
+                if (whole < 100) {
+                    std::cerr << "Error: --error-status must be a 3 digit status code\n";
+                    return false;
+                }
+                options.error_status = static_cast<std::uint16_t>(whole);
+            } else if (arg == "--reset-rate") {
+                if (!next_value(args, i, arg, value) || !parse_fraction(value, arg, options.reset_rate)) {
+                    return false;
+                }
+            } else if (arg == "--seed") {
+                if (!next_value(args, i, arg, value) || !parse_whole(value, arg, UINT32_MAX, whole)) {
+                    return false;
+                }
+                options.seed = static_cast<std::uint32_t>(whole);
+            } else {
+                std::cerr << "Error: unknown argument: " << arg << "\n";
+                print_usage();
+                return false;
+            }
+        }
+
+        if (options.error_rate + options.reset_rate > 1.0) {
+            std::cerr << "Error: --error-rate and --reset-rate add up to more than 1\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    void print_usage() {
+        std::cout << R"(Usage: surge-target [OPTIONS]
+
+Local HTTP/1.1 target for calibrating surge: epoll, one event loop per
+thread, keep-alive and pipelining
+
+OPTIONS:
+    --host <address>         Address to listen on (default: 0.0.0.0)
+    -p, --port <port>        Port to listen on (default: 8080), 0 picks a
+                             free one (printed on startup)
+    -t, --threads <n>        Event loop threads (default: one per CPU)
+    --size <bytes>           Response body size, or <lo>-<hi> for a uniform
+                             range (default: 2), ?size=<bytes> overrides
+    --latency <dist>         Injected service time in ms:
+                               none (default), fixed:<ms>,
+                               uniform:<lo>-<hi>, lognormal:<median>:<sigma>
+    --stall <p>:<ms>         With probability p, add a stall of <ms>
+    --error-rate <p>         Fraction of requests answered with an error
+    --error-status <code>    Status used for errors (default: 500)
+    --reset-rate <p>         Fraction of requests answered with a TCP RST
+    --seed <n>               Seed for sizes, latencies and faults (default: 1)
+    -h, --help               Show this help message
+
+Injected delay is reported as Server-Timing: delay;dur=<ms>.
+
+EXAMPLES:
+    surge-target --port 8080 --threads 4
+    surge-target --size 512-16384 --latency lognormal:5:0.5 --stall 0.001:500
+    surge-target --error-rate 0.01 --reset-rate 0.001
+)";
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace surge::target {
+    // Injected service time per request (ms)
+    struct LatencyDistribution {
+        enum class Kind { None, Fixed, Uniform, LogNormal };
+
+        Kind kind = Kind::None;
+        double first = 0.0;     // fixed: delay, uniform: low, lognormal: median
+        double second = 0.0;    // uniform: high, lognormal: sigma
+    };
+
+    struct Options {
+        std::string host = "0.0.0.0";
+        std::uint16_t port = 8080;          // 0 = any free port
+        std::uint32_t threads = 0;          // 0 = one per hardware thread
+
+        // Response body size, drawn uniformly when min != max (?size=<bytes> overrides per request)
+        std::size_t size_min = 2;
+        std::size_t size_max = 2;
+
+        LatencyDistribution latency;
+
+        // Occasional stall: probability per request, added delay (ms)
+        double stall_probability = 0.0;
+        double stall_ms = 0.0;
+
+        // Fraction of requests answered with error_status, and reset with a TCP RST
+        double error_rate = 0.0;
+        std::uint16_t error_status = 500;
+        double reset_rate = 0.0;
+
+        std::uint32_t seed = 1;
+    };
+
+    bool parse_arguments(const std::vector<std::string>& args, Options& options);
+
+    void print_usage();
+}
@@ -0,0 +1,677 @@
+#include "target/server.hpp"
+#include "target/options.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace surge::target {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr int MAX_EVENTS = 256;
+        constexpr int LISTEN_BACKLOG = 4096;
+        constexpr std::size_t READ_CHUNK = 64 * 1024;
+        constexpr std::size_t MAX_HEAD = 64 * 1024;
+
+        enum class Action { Respond, Reset };
+
+        // A response decided when its request was parsed, sent once due
+        struct Pending {
+            Clock::time_point due;
+            Action action = Action::Respond;
+            std::uint16_t status = 200;
+            std::size_t size = 0;
+            double delay_ms = 0.0;
+            bool close = false;
+        };
+
+        struct Connection {
+            int fd = -1;
+            std::uint64_t id = 0;
+            std::string input;
+            std::string output;
+            std::size_t output_sent = 0;
+            std::deque<Pending> pending;        // In request order, HTTP/1.1 answers pipelined requests in order
+
+            // Request body still to skip, and the response that waits for it
+            std::uint64_t body_remaining = 0;
+            Pending deferred;
+
+            bool close_queued = false;          // A response with Connection: close is pending, ignore further input
+            bool peer_closed = false;
+            std::uint32_t events = 0;
+        };
+
+        // Wakes the loop when the earliest delayed response is due
+        struct Timer {
+            Clock::time_point due;
+            int fd;
+            std::uint64_t id;
+
+            bool operator>(const Timer& other) const { return due > other.due; }
+        };
+
+        // What the request asked for, views into the connection's input
+        struct ParsedHead {
+            bool valid = false;
+            bool close = false;
+            bool chunked = false;
+            std::uint64_t content_length = 0;
+            std::string_view target;
+        };
+
+        bool equals_ignore_case(std::string_view a, std::string_view b) {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+            });
+        }
+
+        std::string_view trim(std::string_view text) {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        ParsedHead parse_head(std::string_view head) {
+            ParsedHead result;
+
+            size_t line_end = head.find("\r\n");
+            std::string_view request_line = head.substr(0, line_end);
+            size_t first_space = request_line.find(' ');
+            size_t last_space = request_line.rfind(' ');
+            if (first_space == std::string_view::npos || last_space == first_space) {
+                return result;
+            }
+            result.target = request_line.substr(first_space + 1, last_space - first_space - 1);
+            std::string_view version = request_line.substr(last_space + 1);
+            if (!version.starts_with("HTTP/1.")) {
+                return result;
+            }
+            result.close = version == "HTTP/1.0";
+
+            std::string_view headers = line_end == std::string_view::npos ? std::string_view{} : head.substr(line_end + 2);
+            while (!headers.empty()) {
+                size_t end = headers.find("\r\n");
+                std::string_view header = headers.substr(0, end);
+                headers.remove_prefix(end == std::string_view::npos ? headers.size() : end + 2);
+
+                size_t colon = header.find(':');
+                if (colon == std::string_view::npos) {
+                    continue;
+                }
+                std::string_view name = trim(header.substr(0, colon));
+                std::string_view value = trim(header.substr(colon + 1));
+
+                if (equals_ignore_case(name, "Content-Length")) {
+                    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result.content_length);
+                    if (ec != std::errc{} || ptr != value.data() + value.size()) {
+                        return result;
+                    }
+                } else if (equals_ignore_case(name, "Connection")) {
+                    if (equals_ignore_case(value, "close")) {
+                        result.close = true;
+                    } else if (equals_ignore_case(value, "keep-alive")) {
+                        result.close = false;
+                    }
+                } else if (equals_ignore_case(name, "Transfer-Encoding")) {
+                    result.chunked = true;
+                }
+            }
+
+            result.valid = true;
+            return result;
+        }
+
+        // ?size=<bytes> in the request target, false when absent
+        bool size_override(std::string_view target, std::size_t& size) {
+            size_t query = target.find('?');
+            while (query != std::string_view::npos) {
+                target.remove_prefix(query + 1);
+                if (target.starts_with("size=")) {
+                    auto [ptr, ec] = std::from_chars(target.data() + 5, target.data() + target.size(), size);
+                    return ec == std::errc{};
+                }
+                query = target.find('&');
+            }
+            return false;
+        }
+
+        const char* reason_phrase(std::uint16_t status) {
+            switch (status) {
+                case 200: return "OK";
+                case 400: return "Bad Request";
+                case 429: return "Too Many Requests";
+                case 431: return "Request Header Fields Too Large";
+                case 500: return "Internal Server Error";
+                case 501: return "Not Implemented";
+                case 502: return "Bad Gateway";
+                case 503: return "Service Unavailable";
+                case 504: return "Gateway Timeout";
+                default: return "Status";
+            }
+        }
+
+        template <typename T>
+        void append_number(std::string& out, T value) {
+            char digits[32];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, end);
+        }
+
+        // One thread's event loop, nothing here is shared with other loops
+        class EventLoop {
+            public:
+                EventLoop(const Options& options, int listen_fd, int wake_fd, std::uint64_t seed)
+                    : options_(options)
+                    , listen_fd_(listen_fd)
+                    , wake_fd_(wake_fd)
+                    , random_(seed)
+                {}
+
+                ~EventLoop() {
+                    for (auto& [fd, connection] : connections_) {
+                        close(fd);
+                    }
+                    if (epoll_fd_ >= 0) {
+                        close(epoll_fd_);
+                    }
+                }
+
+                EventLoop(const EventLoop&) = delete;
+                EventLoop& operator=(const EventLoop&) = delete;
+
+                // Runs until the wake fd fires, publish gets counter deltas after each batch
+                void run(const std::function<void(const ServerCounters&)>& publish) {
+                    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+                    if (epoll_fd_ < 0) {
+                        std::cerr << "Error: could not create epoll instance\n";
+                        return;
+                    }
+                    epoll_event listen_event{EPOLLIN, {.fd = listen_fd_}};
+                    epoll_event wake_event{EPOLLIN, {.fd = wake_fd_}};
+                    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &listen_event);
+                    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event);
+
+                    std::vector<epoll_event> events(MAX_EVENTS);
+                    while (true) {
+                        int ready = wait(events);
+                        if (ready < 0 && errno != EINTR) {
+                            std::cerr << "Error: epoll_wait failed\n";
+                            return;
+                        }
+
+                        for (int i = 0; i < ready; ++i) {
+                            int fd = events[i].data.fd;
+                            if (fd == wake_fd_) {
+                                return;
+                            }
+                            if (fd == listen_fd_) {
+                                accept_all();
+                                continue;
+                            }
+                            auto it = connections_.find(fd);
+                            if (it == connections_.end()) {
+                                continue;
+                            }
+                            Connection& connection = it->second;
+                            std::uint32_t flags = events[i].events;
+                            if (flags & EPOLLERR) {
+                                drop(connection);
+                                continue;
+                            }
+                            if ((flags & (EPOLLIN | EPOLLHUP)) && !readable(connection)) {
+                                continue;
+                            }
+                            if (flags & EPOLLOUT) {
+                                flush(connection);
+                            }
+                        }
+
+                        fire_timers();
+
+                        publish(counters_);
+                        counters_ = {};
+                    }
+                }
+
+            private:
+                // epoll_pwait2 keeps sub millisecond injected delays accurate, epoll_wait is the fallback
+                int wait(std::vector<epoll_event>& events) {
+                    if (timers_.empty()) {
+                        return epoll_wait(epoll_fd_, events.data(), MAX_EVENTS, -1);
+                    }
+                    auto remaining = std::max(timers_.top().due - Clock::now(), Clock::duration::zero());
+                    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+                    timespec timeout{static_cast<time_t>(nanos / 1'000'000'000), static_cast<long>(nanos % 1'000'000'000)};
+                    int ready = epoll_pwait2(epoll_fd_, events.data(), MAX_EVENTS, &timeout, nullptr);
+                    if (ready < 0 && errno == ENOSYS) {
+                        ready = epoll_wait(epoll_fd_, events.data(), MAX_EVENTS, static_cast<int>((nanos + 999'999) / 1'000'000));
+                    }
+                    return ready;
+                }
+
+                void accept_all() {
+                    while (true) {
+                        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                        if (fd < 0) {
+                            return;
+                        }
+                        int enable = 1;
+                        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+                        Connection& connection = connections_[fd];
+                        connection = Connection{};
+                        connection.fd = fd;
+                        connection.id = ++next_id_;
+                        connection.events = EPOLLIN;
+                        epoll_event event{EPOLLIN, {.fd = fd}};
+                        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+                        ++counters_.connections;
+                    }
+                }
+
+                // Read everything available and queue a response per complete request
+                // False when the connection was closed
+                bool readable(Connection& connection) {
+                    char buffer[READ_CHUNK];
+                    while (true) {
+                        ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+                        if (received > 0) {
+                            if (!connection.close_queued) {
+                                connection.input.append(buffer, static_cast<size_t>(received));
+                            }
+                            continue;
+                        }
+                        if (received == 0) {
+                            connection.peer_closed = true;
+                            break;
+                        }
+                        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                            break;
+                        }
+                        if (errno != EINTR) {
+                            drop(connection);
+                            return false;
+                        }
+                    }
+
+                    parse_requests(connection);
+                    return emit(connection);
+                }
+
+                void parse_requests(Connection& connection) {
+                    std::string& input = connection.input;
+                    size_t position = 0;
+
+                    while (!connection.close_queued) {
+                        if (connection.body_remaining > 0) {
+                            auto take = std::min<std::uint64_t>(connection.body_remaining, input.size() - position);
+                            position += static_cast<size_t>(take);
+                            connection.body_remaining -= take;
+                            if (connection.body_remaining > 0) {
+                                break;
+                            }
+                            queue(connection, connection.deferred);
+                            continue;
+                        }
+
+                        size_t head_end = input.find("\r\n\r\n", position);
+                        if (head_end == std::string::npos) {
+                            if (input.size() - position > MAX_HEAD) {
+                                queue(connection, error_response(431));
+                            }
+                            break;
+                        }
+
+                        ParsedHead head = parse_head(std::string_view(input).substr(position, head_end - position));
+                        position = head_end + 4;
+
+                        if (!head.valid || head.chunked) {
+                            // Chunked request bodies are not supported, the stream cant be resynchronised
+                            queue(connection, error_response(head.valid ? 501 : 400));
+                            break;
+                        }
+
+                        Pending response = decide(head);
+                        if (head.content_length > 0) {
+                            connection.body_remaining = head.content_length;
+                            connection.deferred = response;
+                        } else {
+                            queue(connection, response);
+                        }
+                    }
+
+                    if (connection.close_queued) {
+                        input.clear();
+                    } else {
+                        input.erase(0, position);
+                    }
+                }
+
+                // Response (or reset) for a request, drawn from the configured distributions
+                Pending decide(const ParsedHead& head) {
+                    Pending response;
+                    response.close = head.close;
+
+                    double roll = unit_(random_);
+                    if (roll < options_.reset_rate) {
+                        response.action = Action::Reset;
+                    } else if (roll < options_.reset_rate + options_.error_rate) {
+                        response.status = options_.error_status;
+                    }
+
+                    if (!size_override(head.target, response.size)) {
+                        response.size = options_.size_min == options_.size_max ? options_.size_min
+                            : std::uniform_int_distribution<std::size_t>(options_.size_min, options_.size_max)(random_);
+                    }
+
+                    response.delay_ms = sample_latency();
+                    if (options_.stall_probability > 0 && unit_(random_) < options_.stall_probability) {
+                        response.delay_ms += options_.stall_ms;
+                    }
+                    return response;
+                }
+
+                double sample_latency() {
+                    const LatencyDistribution& latency = options_.latency;
+                    switch (latency.kind) {
+                        case LatencyDistribution::Kind::Fixed:
+                            return latency.first;
+                        case LatencyDistribution::Kind::Uniform:
+                            return latency.first + unit_(random_) * (latency.second - latency.first);
+                        case LatencyDistribution::Kind::LogNormal:
+                            return std::lognormal_distribution<double>(std::log(latency.first), latency.second)(random_);
+                        case LatencyDistribution::Kind::None:
+                            break;
+                    }
+                    return 0.0;
+                }
+
+                static Pending error_response(std::uint16_t status) {
+                    Pending response;
+                    response.status = status;
+                    response.close = true;
+                    return response;
+                }
+
+                void queue(Connection& connection, Pending response) {
+                    ++counters_.requests;
+                    response.due = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double, std::milli>(response.delay_ms));
+                    if (response.delay_ms > 0) {
+                        timers_.push(Timer{response.due, connection.fd, connection.id});
+                    }
+                    connection.close_queued = connection.close_queued || response.close;
+                    connection.pending.push_back(response);
+                }
+
+                // Write out every response that is due, in order, false when the connection was closed
+                bool emit(Connection& connection) {
+                    auto now = Clock::now();
+                    while (!connection.pending.empty() && connection.pending.front().due <= now) {
+                        Pending response = connection.pending.front();
+                        connection.pending.pop_front();
+
+                        if (response.action == Action::Reset) {
+                            ++counters_.resets;
+                            linger reset{1, 0};
+                            setsockopt(connection.fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+                            drop(connection);
+                            return false;
+                        }
+                        if (response.status >= 400) {
+                            ++counters_.errors;
+                        }
+                        append_response(connection.output, response);
+                    }
+                    return flush(connection);
+                }
+
+                static void append_response(std::string& out, const Pending& response) {
+                    out += "HTTP/1.1 ";
+                    append_number(out, response.status);
+                    out += ' ';
+                    out += reason_phrase(response.status);
+                    out += "\r\nContent-Type: text/plain\r\nContent-Length: ";
+                    append_number(out, response.size);
+                    out += "\r\n";
+                    if (response.delay_ms > 0) {
+                        char digits[32];
+                        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), response.delay_ms,
+                                                       std::chars_format::fixed, 3);
+                        out += "Server-Timing: delay;dur=";
+                        out.append(digits, end);
+                        out += "\r\n";
+                    }
+                    if (response.close) {
+                        out += "Connection: close\r\n";
+                    }
+                    out += "\r\n";
+                    out.append(response.size, 'x');
+                }
+
+                // Send buffered output, false when the connection was closed
+                bool flush(Connection& connection) {
+                    std::string& output = connection.output;
+                    while (connection.output_sent < output.size()) {
+                        ssize_t sent = send(connection.fd, output.data() + connection.output_sent,
+                                            output.size() - connection.output_sent, MSG_NOSIGNAL);
+                        if (sent > 0) {
+                            connection.output_sent += static_cast<size_t>(sent);
+                            counters_.bytes_sent += static_cast<std::uint64_t>(sent);
+                            continue;
+                        }
+                        if (sent < 0 && errno == EINTR) {
+                            continue;
+                        }
+                        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                            update_events(connection);
+                            return true;
+                        }
+                        drop(connection);
+                        return false;
+                    }
+                    output.clear();
+                    connection.output_sent = 0;
+
+                    // Everything owed has been sent
+                    if (connection.pending.empty() && (connection.close_queued || connection.peer_closed)) {
+                        drop(connection);
+                        return false;
+                    }
+                    update_events(connection);
+                    return true;
+                }
+
+                // Stop reading once the peer is gone or a close is queued, so level triggered
+                // epoll does not spin while delayed responses wait
+                void update_events(Connection& connection) {
+                    std::uint32_t events = 0;
+                    if (!connection.peer_closed && !connection.close_queued) {
+                        events |= EPOLLIN;
+                    }
+                    if (connection.output_sent < connection.output.size()) {
+                        events |= EPOLLOUT;
+                    }
+                    if (events != connection.events) {
+                        epoll_event event{events, {.fd = connection.fd}};
+                        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+                        connection.events = events;
+                    }
+                }
+
+                void fire_timers() {
+                    auto now = Clock::now();
+                    while (!timers_.empty() && timers_.top().due <= now) {
+                        Timer timer = timers_.top();
+                        timers_.pop();
+                        auto it = connections_.find(timer.fd);
+                        if (it != connections_.end() && it->second.id == timer.id) {
+                            emit(it->second);
+                        }
+                    }
+                }
+
+                void drop(Connection& connection) {
+                    int fd = connection.fd;
+                    close(fd);
+                    connections_.erase(fd);
+                }
+
+                const Options& options_;
+                int listen_fd_;
+                int wake_fd_;
+                int epoll_fd_ = -1;
+
+                std::unordered_map<int, Connection> connections_;
+                std::uint64_t next_id_ = 0;
+                std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+
+                std::mt19937_64 random_;
+                std::uniform_real_distribution<double> unit_{0.0, 1.0};
+                ServerCounters counters_;
+        };
+    }
+
+    Server::Server(const Options& options)
+        : options_(options)
+    {}
+
+    Server::~Server() {
+        stop();
+        wait();
+        for (int fd : listen_fds_) {
+            close(fd);
+        }
+        if (wake_fd_ >= 0) {
+            close(wake_fd_);
+        }
+    }
+
+    bool Server::start() {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options_.port);
+        if (inet_pton(AF_INET, options_.host.c_str(), &address.sin_addr) != 1) {
+            std::cerr << "Error: invalid listen address " << options_.host << "\n";
+            return false;
+        }
+
+        std::uint32_t threads = options_.threads > 0 ? options_.threads : std::max(1u, std::thread::hardware_concurrency());
+
+        // One listener per loop on the same port, the kernel balances accepts between them
+        for (std::uint32_t i = 0; i < threads; ++i) {
+            int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                std::cerr << "Error: could not create listen socket\n";
+                return false;
+            }
+            int enable = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+            setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+            listen_fds_.push_back(fd);
+
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, LISTEN_BACKLOG) < 0) {
+                std::cerr << "Error: could not listen on " << options_.host << ":" << options_.port << "\n";
+                return false;
+            }
+
+            // Port 0: the first listener gets a free port from the kernel, the others join it
+            if (options_.port == 0) {
+                socklen_t length = sizeof(address);
+                if (getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) < 0) {
+                    std::cerr << "Error: could not read the listen port\n";
+                    return false;
+                }
+                options_.port = ntohs(address.sin_port);
+            }
+        }
+
+        wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wake_fd_ < 0) {
+            std::cerr << "Error: could not create eventfd\n";
+            return false;
+        }
+
+        for (std::uint32_t i = 0; i < threads; ++i) {
+            threads_.emplace_back([this, i]() {
+                run(listen_fds_[i], i);
+            });
+        }
+        return true;
+    }
+
+    // The eventfd is never read, so it stays readable and wakes every loop
+    void Server::stop() {
+        if (wake_fd_ >= 0) {
+            std::uint64_t one = 1;
+            [[maybe_unused]] ssize_t written = write(wake_fd_, &one, sizeof(one));
+        }
+    }
+
+    void Server::wait() {
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    ServerCounters Server::counters() const {
+        ServerCounters counters;
+        counters.connections = connections_.load(std::memory_order_relaxed);
+        counters.requests = requests_.load(std::memory_order_relaxed);
+        counters.errors = errors_.load(std::memory_order_relaxed);
+        counters.resets = resets_.load(std::memory_order_relaxed);
+        counters.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+        return counters;
+    }
+
+    void Server::run(int listen_fd, std::uint32_t index) {
+        // Each loop gets its own stream so runs with the same seed and thread count repeat
+        EventLoop loop(options_, listen_fd, wake_fd_, options_.seed + index * 0x9E3779B97F4A7C15ULL);
+        loop.run([this](const ServerCounters& delta) {
+            if (delta.connections > 0) {
+                connections_.fetch_add(delta.connections, std::memory_order_relaxed);
+            }
+            if (delta.requests > 0) {
+                requests_.fetch_add(delta.requests, std::memory_order_relaxed);
+            }
+            if (delta.errors > 0) {
+                errors_.fetch_add(delta.errors, std::memory_order_relaxed);
+            }
+            if (delta.resets > 0) {
+                resets_.fetch_add(delta.resets, std::memory_order_relaxed);
+            }
+            if (delta.bytes_sent > 0) {
+                bytes_sent_.fetch_add(delta.bytes_sent, std::memory_order_relaxed);
+            }
+        });
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "target/options.hpp"
+
+namespace surge::target {
+    // Totals across all event loops
+    struct ServerCounters {
+        std::uint64_t connections = 0;
+        std::uint64_t requests = 0;
+        std::uint64_t errors = 0;
+        std::uint64_t resets = 0;
+        std::uint64_t bytes_sent = 0;
+    };
+
+    // Multi threaded HTTP/1.1 server: each thread runs its own epoll loop on its own
+    // SO_REUSEPORT listener, so the kernel spreads connections and threads share nothing
+    // Delayed responses wait on a per thread timer heap and still go out in request order
+    class Server {
+        public:
+            explicit Server(const Options& options);
+            ~Server();
+
+            // Disable copy
+            Server(const Server&) = delete;
+            Server& operator=(const Server&) = delete;
+
+            // Bind every listener and start the loops, false if the address cant be bound
+            bool start();
+
+            // Wake every loop and make it exit, safe from any thread
+            void stop();
+
+            // Block until all loops have exited
+            void wait();
+
+            ServerCounters counters() const;
+
+            // Listening port, the kernel's pick when started with port 0
+            std::uint16_t port() const { return options_.port; }
+
+        private:
+            void run(int listen_fd, std::uint32_t index);
+
+            Options options_;
+            std::vector<int> listen_fds_;
+            int wake_fd_ = -1;
+            std::vector<std::jthread> threads_;
+
+            std::atomic<std::uint64_t> connections_{0};
+            std::atomic<std::uint64_t> requests_{0};
+            std::atomic<std::uint64_t> errors_{0};
+            std::atomic<std::uint64_t> resets_{0};
+            std::atomic<std::uint64_t> bytes_sent_{0};
+    };
+}
@@ -0,0 +1,86 @@
+// Steady state requests must not touch the heap: counts operator new on the calling thread
+// while Client::execute() and Collector::record() run against a local listener
+
+#include "http/client.hpp"
+#include "http/clock.hpp"
+#include "http/request.hpp"
+#include "stats/collector.hpp"
+
+#include "support.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace {
+    // Only the thread running requests is counted, the listener thread is not
+    thread_local bool counting = false;
+    std::uint64_t allocations = 0;
+
+    void* allocate(std::size_t size) {
+        if (counting) {
+            allocations++;
+        }
+        if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    constexpr int WARMUP_REQUESTS = 100;
+    constexpr int MEASURED_REQUESTS = 1000;
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+int main() {
+    surge::http::TscClock::init();
+
+    surge::test::LocalListener listener([](std::string_view) {
+        return surge::test::LocalListener::response("Content-Type: text/plain\r\n");
+    });
+    if (listener.port() == 0) {
+        std::cerr << "FAIL: could not open a local listener\n";
+        return 1;
+    }
+
+    surge::http::Client client;
+    surge::stats::Collector collector;
+    surge::http::Request request;
+    request.url = listener.url("/alloc");
+
+    // Buffers grow and the endpoint is resolved during warmup
+    bool ok = true;
+    auto run = [&](int requests) {
+        for (int i = 0; i < requests; ++i) {
+            collector.request_started();
+            surge::http::Result result = client.execute(request);
+            collector.record(result);
+            ok = ok && result.success && result.status_code == 200;
+        }
+    };
+    run(WARMUP_REQUESTS);
+
+    counting = true;
+    run(MEASURED_REQUESTS);
+    counting = false;
+
+    if (!ok) {
+        std::cerr << "FAIL: requests to the local listener failed\n";
+        return 1;
+    }
+    if (allocations != 0) {
+        std::cerr << "FAIL: " << allocations << " heap allocations over " << MEASURED_REQUESTS
+                  << " steady state requests\n";
+        return 1;
+    }
+    std::cout << "OK: 0 heap allocations over " << MEASURED_REQUESTS << " steady state requests\n";
+    return 0;
+}
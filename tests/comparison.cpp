@@ -0,0 +1,139 @@
+// Baseline comparison: Mann-Whitney U against hand computed values (no ties, ties,
+// identical runs), the regression gate, and the baseline file round trip
+
+#include "core/engine.hpp"
+#include "output/baseline.hpp"
+#include "stats/comparison.hpp"
+#include "stats/histogram.hpp"
+
+#include "support.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+
+namespace {
+    using surge::stats::Histogram;
+
+    // Values below 128 land in exact buckets, so these are the textbook samples
+    Histogram samples(std::initializer_list<std::uint64_t> values) {
+        Histogram histogram;
+        for (std::uint64_t value : values) {
+            histogram.record(value);
+        }
+        return histogram;
+    }
+
+    Histogram repeated(std::initializer_list<std::pair<std::uint64_t, std::uint64_t>> counts) {
+        Histogram histogram;
+        for (const auto& [value, count] : counts) {
+            histogram.record(value, count);
+        }
+        return histogram;
+    }
+
+    surge::stats::RunSummary summary(const Histogram& latency, double rps, std::uint64_t failed = 0) {
+        surge::stats::RunSummary run;
+        run.total_requests = latency.count() + failed;
+        run.successful_requests = latency.count();
+        run.failed_requests = failed;
+        run.requests_per_second = rps;
+        run.latency_histogram = latency;
+        return run;
+    }
+}
+
+int main() {
+    using surge::test::check;
+    using surge::test::near;
+    using surge::stats::mann_whitney;
+
+    // No ties, current entirely slower: U = n1 * n2, normal approximation with continuity correction
+    auto separated = mann_whitney(samples({1, 2, 3, 4, 5}), samples({6, 7, 8, 9, 10}));
+    check(near(separated.u, 25.0), "U without ties");
+    check(near(separated.z, 2.5067182457620487, 1e-9), "z without ties");
+    check(near(separated.p_value, 0.012185780355344818, 1e-9), "p without ties");
+    check(near(separated.prob_slower, 1.0), "every current sample is slower");
+
+    // Swapped: same p, z negative
+    auto faster = mann_whitney(samples({6, 7, 8, 9, 10}), samples({1, 2, 3, 4, 5}));
+    check(near(faster.u, 0.0) && near(faster.z, -separated.z, 1e-9), "faster run has negative z");
+    check(near(faster.p_value, separated.p_value, 1e-12), "two sided p is symmetric");
+
+    // Ties share their average rank and shrink the variance
+    auto tied = mann_whitney(samples({1, 1, 2, 2, 3}), samples({2, 3, 3, 4, 4}));
+    check(near(tied.u, 22.0), "U with ties");
+    check(near(tied.z, 1.9397372618891686, 1e-9), "z with tie correction");
+    check(near(tied.p_value, 0.05241162867102868, 1e-9), "p with tie correction");
+    check(near(tied.prob_slower, 0.88), "ties count half");
+
+    // Large tie groups, as histogram buckets are
+    auto grouped = mann_whitney(repeated({{10, 30}, {20, 30}}), repeated({{10, 20}, {20, 25}, {30, 15}}));
+    check(near(grouped.u, 2325.0), "U over tie groups");
+    check(near(grouped.z, 3.0226509158714574, 1e-9), "z over tie groups");
+    check(near(grouped.p_value, 0.0025057110700282084, 1e-9), "p over tie groups");
+
+    // Identical distributions: U at its mean, nothing significant
+    Histogram wide = repeated({{100, 40}, {250, 90}, {900, 30}, {5000, 3}});
+    auto identical = mann_whitney(wide, wide);
+    check(near(identical.z, 0.0) && near(identical.p_value, 1.0), "identical histograms are not different");
+    check(near(identical.prob_slower, 0.5), "identical histograms are a coin flip");
+
+    // Degenerate: one bucket for everything, or an empty side
+    auto single = mann_whitney(repeated({{42, 100}}), repeated({{42, 50}}));
+    check(near(single.p_value, 1.0) && near(single.z, 0.0), "single shared bucket has no variance");
+    auto empty = mann_whitney(Histogram{}, wide);
+    check(near(empty.p_value, 1.0) && near(empty.u, 0.0), "empty side is not compared");
+
+    // Regression gate: a significant shift past the limit, throughput and errors
+    surge::stats::RegressionThresholds thresholds;
+    Histogram slow = repeated({{130, 40}, {330, 90}, {1200, 30}, {6500, 3}});
+    auto same = surge::stats::compare(summary(wide, 1000.0), summary(wide, 1000.0), thresholds);
+    check(!same.regression() && !same.significant, "identical runs pass");
+    auto slower = surge::stats::compare(summary(wide, 1000.0), summary(slow, 1000.0), thresholds);
+    check(slower.significant && slower.regression(), "significantly slower run regresses");
+    check(slower.violations.size() == 3, "p50, p90 and p99 each breach");
+    auto improved = surge::stats::compare(summary(slow, 1000.0), summary(wide, 1000.0), thresholds);
+    check(improved.significant && !improved.regression(), "significantly faster run passes");
+    auto dropped = surge::stats::compare(summary(wide, 1000.0), summary(wide, 850.0), thresholds);
+    check(dropped.regression() && near(dropped.throughput_change_percent, -15.0, 1e-9), "throughput drop regresses");
+    auto erroring = surge::stats::compare(summary(wide, 1000.0), summary(wide, 1000.0, 10), thresholds);
+    check(erroring.regression() && erroring.current_error_rate > 5.0, "error rate increase regresses");
+
+    // Baseline file round trip
+    surge::core::Results results{};
+    results.metrics.latency_histogram = wide;
+    results.metrics.total_requests = wide.count() + 7;
+    results.metrics.successful_requests = wide.count();
+    results.metrics.failed_requests = 7;
+    results.requests_per_second = 1234.5;
+    results.percentiles = wide.percentiles();
+
+    std::string path = "comparison_baseline.json";
+    check(surge::output::Baseline::save(results, "http://127.0.0.1/\"quoted\"", path), "baseline saved");
+    auto loaded = surge::output::Baseline::load(path);
+    if (check(loaded.has_value(), "baseline loads")) {
+        check(loaded->total_requests == results.metrics.total_requests, "total requests round trip");
+        check(loaded->failed_requests == 7 && loaded->successful_requests == wide.count(), "outcome counts round trip");
+        check(near(loaded->requests_per_second, 1234.5), "throughput round trips");
+        bool buckets = loaded->latency_histogram.count() == wide.count();
+        for (std::size_t i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+            buckets = buckets && loaded->latency_histogram.count_at(i) == wide.count_at(i);
+        }
+        check(buckets, "histogram round trips bucket for bucket");
+        auto against_itself = surge::stats::compare(*loaded, surge::output::Baseline::summarize(results), thresholds);
+        check(!against_itself.regression(), "a run compared with its own baseline passes");
+    }
+
+    {
+        std::ofstream file(path);
+        file << "{\"version\": 99, \"histogram\": {\"sub_bucket_bits\": 7, \"buckets\": []}}\n";
+    }
+    check(!surge::output::Baseline::load(path).has_value(), "unknown version is rejected");
+    check(!surge::output::Baseline::load("missing_baseline.json").has_value(), "missing file is rejected");
+
+    std::remove(path.c_str());
+    return surge::test::exit_code();
+}
@@ -0,0 +1,161 @@
+// Response body decoding: gzip, zlib wrapped deflate, concatenated gzip members, chunked
+// framing around gzip, and bodies that are cut short or corrupt
+
+#include "http/decoder.hpp"
+
+#include "support.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace {
+    using surge::http::ContentEncoding;
+    using surge::http::Decoder;
+
+    // windowBits: 15 bit window, +16 writes a gzip header instead of a zlib one
+    constexpr int ZLIB_WINDOW = 15;
+    constexpr int GZIP_WINDOW = 15 + 16;
+
+    // Compressible but not trivial, and decoding to well past the decoder's 16KB scratch buffer
+    std::string sample_body(std::size_t size) {
+        std::string body;
+        body.reserve(size);
+        for (std::size_t i = 0; body.size() < size; ++i) {
+            body += "{\"id\":" + std::to_string(i) + ",\"name\":\"item-" + std::to_string(i * 7919 % 1000) + "\"},";
+        }
+        body.resize(size);
+        return body;
+    }
+
+    std::string compress(std::string_view input, int window_bits) {
+        z_stream stream{};
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return {};
+        }
+        std::string output(deflateBound(&stream, static_cast<uLong>(input.size())) + 32, '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        stream.avail_in = static_cast<uInt>(input.size());
+        stream.next_out = reinterpret_cast<Bytef*>(output.data());
+        stream.avail_out = static_cast<uInt>(output.size());
+        int status = deflate(&stream, Z_FINISH);
+        output.resize(stream.total_out);
+        deflateEnd(&stream);
+        return status == Z_STREAM_END ? output : std::string{};
+    }
+
+    // Chunks of growing size, with an extension on one of them and a trailer field
+    std::string chunk(std::string_view body) {
+        std::string framed;
+        std::size_t size = 1;
+        while (!body.empty()) {
+            std::size_t take = std::min(size, body.size());
+            char hex[32];
+            std::snprintf(hex, sizeof(hex), "%zx", take);
+            framed += hex;
+            framed += size == 3 ? ";name=value\r\n" : "\r\n";
+            framed += body.substr(0, take);
+            framed += "\r\n";
+            body.remove_prefix(take);
+            size = size * 3 + 1;
+        }
+        return framed + "0\r\nX-Checksum: abc\r\n\r\n";
+    }
+
+    struct Decoded {
+        bool fed = false;
+        bool finished = false;
+        std::uint64_t bytes = 0;
+    };
+
+    // Feeds body in pieces of at most piece bytes, as socket reads would deliver it
+    Decoded decode(Decoder& decoder, ContentEncoding encoding, bool chunked, std::string_view body, std::size_t piece) {
+        Decoded decoded;
+        if (!decoder.begin(encoding, chunked)) {
+            return decoded;
+        }
+        decoded.fed = true;
+        for (std::size_t at = 0; at < body.size() && decoded.fed; at += piece) {
+            std::string_view part = body.substr(at, piece);
+            decoded.fed = decoder.feed(part.data(), part.size());
+        }
+        decoded.finished = decoded.fed && decoder.finish();
+        decoded.bytes = decoder.decoded_bytes();
+        return decoded;
+    }
+
+    bool complete(const Decoded& decoded, std::size_t expected) {
+        return decoded.fed && decoded.finished && decoded.bytes == expected;
+    }
+}
+
+int main() {
+    using surge::test::check;
+
+    const std::string body = sample_body(200'000);
+    const std::string gzip = compress(body, GZIP_WINDOW);
+    const std::string zlib = compress(body, ZLIB_WINDOW);
+    if (!check(!gzip.empty() && !zlib.empty(), "test bodies compressed")) {
+        return surge::test::exit_code();
+    }
+
+    // One decoder for everything, as a connection reuses it across responses
+    Decoder decoder;
+
+    // gzip and zlib wrapped deflate, whole and in small reads
+    for (std::size_t piece : {gzip.size(), std::size_t{4096}, std::size_t{7}, std::size_t{1}}) {
+        std::string reads = " in " + std::to_string(piece) + " byte reads";
+        check(complete(decode(decoder, ContentEncoding::Gzip, false, gzip, piece), body.size()), "gzip" + reads);
+        check(complete(decode(decoder, ContentEncoding::Deflate, false, zlib, piece), body.size()), "deflate" + reads);
+    }
+
+    // Either header is detected whatever the label says
+    check(complete(decode(decoder, ContentEncoding::Deflate, false, gzip, 1024), body.size()), "gzip labelled deflate");
+
+    // Concatenated gzip members decode as one body
+    const std::string second = sample_body(5000);
+    const std::string members = gzip + compress(second, GZIP_WINDOW);
+    check(complete(decode(decoder, ContentEncoding::Gzip, false, members, members.size()), body.size() + second.size()),
+          "concatenated gzip members");
+    check(complete(decode(decoder, ContentEncoding::Gzip, false, members, 3), body.size() + second.size()),
+          "concatenated gzip members in small reads");
+
+    // Chunked framing around gzip, and around an identity body
+    const std::string chunked = chunk(gzip);
+    for (std::size_t piece : {chunked.size(), std::size_t{5}, std::size_t{1}}) {
+        check(complete(decode(decoder, ContentEncoding::Gzip, true, chunked, piece), body.size()),
+              "chunked gzip in " + std::to_string(piece) + " byte reads");
+    }
+    check(complete(decode(decoder, ContentEncoding::Identity, true, chunk(body), 999), body.size()), "chunked identity");
+
+    // Cut short: the decoder accepts what it got, but the body did not finish
+    Decoded truncated = decode(decoder, ContentEncoding::Gzip, false, std::string_view(gzip).substr(0, gzip.size() - 10), 512);
+    check(truncated.fed && !truncated.finished, "truncated gzip does not finish");
+    check(truncated.bytes > 0 && truncated.bytes <= body.size(), "truncated gzip counts what was decoded");
+    Decoded no_last_chunk = decode(decoder, ContentEncoding::Gzip, true, std::string_view(chunked).substr(0, chunked.size() - 30), 512);
+    check(no_last_chunk.fed && !no_last_chunk.finished, "chunked body cut before its last chunk does not finish");
+
+    // Corrupt data is rejected
+    std::string bad_header = gzip;
+    bad_header[0] = 'x';
+    check(!decode(decoder, ContentEncoding::Gzip, false, bad_header, 512).fed, "bad gzip magic is rejected");
+    std::string bad_data = zlib;
+    for (std::size_t i = bad_data.size() / 2; i < bad_data.size() / 2 + 16; ++i) {
+        bad_data[i] = static_cast<char>(~bad_data[i]);
+    }
+    check(!complete(decode(decoder, ContentEncoding::Deflate, false, bad_data, 512), body.size()), "corrupt deflate data is rejected");
+    check(!decode(decoder, ContentEncoding::Gzip, true, "zz\r\n" + gzip, 512).fed, "bad chunk size is rejected");
+
+    // The decoder is still good after a failure
+    check(complete(decode(decoder, ContentEncoding::Gzip, false, gzip, 4096), body.size()), "decoder resets after a corrupt body");
+
+    // Nothing the build cannot decode
+    check(!decoder.begin(ContentEncoding::Unsupported, false), "unsupported coding refused");
+
+    return surge::test::exit_code();
+}
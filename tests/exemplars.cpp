@@ -0,0 +1,108 @@
+// Exemplar store: the slowest requests plus a sample above the threshold, a request kept
+// for both reasons reported once with both flags, and the admission floor
+
+#include "stats/exemplars.hpp"
+
+#include "support.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace {
+    // What the engine does after a request: admit on latency, copy only when admitted
+    void observe(surge::stats::ExemplarStore& store, std::uint64_t latency_us) {
+        if (latency_us < store.floor()) {
+            return;
+        }
+        surge::stats::Admission admission = store.admit(latency_us);
+        if (!admission) {
+            return;
+        }
+        surge::stats::Exemplar exemplar;
+        exemplar.id = admission.id;
+        exemplar.latency = std::chrono::microseconds(latency_us);
+        store.keep(admission, exemplar);
+    }
+}
+
+int main() {
+    using surge::test::check;
+    using surge::stats::Exemplar;
+    using surge::stats::ExemplarStore;
+
+    // A lone slow request fills both lists and comes back once
+    {
+        ExemplarStore store(3, 1000, 2);
+        observe(store, 5000);
+        std::vector<Exemplar> kept = store.take();
+        check(kept.size() == 1, "sampled and slowest request kept once");
+        check(!kept.empty() && kept[0].slowest && kept[0].sampled, "both reasons flagged");
+        check(store.take().empty(), "take() empties the store");
+    }
+
+    // 1..200ms, slowest 5, sample 10 of the 101 requests at or above 100ms
+    constexpr std::size_t SLOWEST = 5;
+    constexpr std::size_t SAMPLES = 10;
+    ExemplarStore store(SLOWEST, 100'000, SAMPLES);
+    for (std::uint64_t ms = 1; ms <= 200; ++ms) {
+        observe(store, ms * 1000);
+    }
+    check(store.above_threshold() == 101, "above threshold requests counted");
+    check(store.floor() == 100'000, "floor is the threshold once the slowest list is full");
+
+    std::vector<Exemplar> kept = store.take();
+    std::set<std::uint64_t> ids;
+    std::size_t slowest = 0;
+    std::size_t sampled = 0;
+    std::size_t both = 0;
+    bool above = true;
+    for (const Exemplar& exemplar : kept) {
+        ids.insert(exemplar.id);
+        slowest += exemplar.slowest;
+        sampled += exemplar.sampled;
+        both += exemplar.slowest && exemplar.sampled;
+        above = above && exemplar.latency >= std::chrono::milliseconds(100);
+    }
+    check(ids.size() == kept.size(), "no request appears twice");
+    check(slowest == SLOWEST && sampled == SAMPLES, "both lists full");
+    check(kept.size() == SLOWEST + SAMPLES - both, "overlap counted once");
+    check(above, "only requests at or above the threshold kept");
+    check(std::is_sorted(kept.begin(), kept.end(), [](const Exemplar& a, const Exemplar& b) {
+        return a.latency > b.latency;
+    }), "slowest first");
+    bool top = kept.size() >= SLOWEST;
+    for (std::size_t i = 0; i < SLOWEST && top; ++i) {
+        top = kept[i].slowest && kept[i].latency == std::chrono::milliseconds(200 - i);
+    }
+    check(top, "the five slowest lead, flagged slowest");
+
+    // Every slowest request also sampled: the reservoir holds all of them
+    {
+        ExemplarStore overlap(3, 0, 8);
+        for (std::uint64_t latency : {10, 40, 20, 50, 30}) {
+            observe(overlap, latency);
+        }
+        std::vector<Exemplar> all = overlap.take();
+        check(all.size() == 5, "five requests, each once");
+        check(std::count_if(all.begin(), all.end(), [](const Exemplar& e) { return e.slowest && e.sampled; }) == 3,
+              "the three slowest carry both flags");
+    }
+
+    // No sampling: the floor follows the slowest list
+    {
+        ExemplarStore slowest_only(2, 1000, 0);
+        check(slowest_only.threshold_us() == ExemplarStore::NO_THRESHOLD, "no samples, no threshold");
+        observe(slowest_only, 30);
+        observe(slowest_only, 70);
+        check(slowest_only.floor() == 31, "floor above the fastest kept");
+        check(!slowest_only.admit(20), "faster request not admitted");
+        observe(slowest_only, 50);
+        std::vector<Exemplar> two = slowest_only.take();
+        check(two.size() == 2 && two[0].latency.count() == 70 && two[1].latency.count() == 50, "slower request replaced the fastest");
+    }
+
+    return surge::test::exit_code();
+}
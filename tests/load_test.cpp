@@ -0,0 +1,101 @@
+// Embedded LoadTest: a Config built in code against a local listener, snapshots,
+// the completion callback, and stop() from a callback or before run()
+
+#include "surge/surge.hpp"
+#include "http/clock.hpp"
+
+#include "support.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    surge::Config local_config(const surge::test::LocalListener& listener) {
+        surge::Config config;
+        config.url = listener.url("/embedded");
+        config.concurrency = 2;
+        config.verbose = false;
+        return config;
+    }
+}
+
+int main() {
+    using surge::test::check;
+    surge::http::TscClock::init();
+
+    surge::test::LocalListener listener([](std::string_view) {
+        return surge::test::LocalListener::response("");
+    });
+    if (!check(listener.port() != 0, "local listener opened")) {
+        return surge::test::exit_code();
+    }
+
+    // Request budget: on_complete sees the same final results run() returns
+    {
+        surge::Config config = local_config(listener);
+        config.requests = 200;
+        surge::LoadTest test(config);
+        std::optional<surge::Results> completed;
+        test.on_complete([&](const surge::Results& results) {
+            completed = results;
+        });
+        std::optional<surge::Results> results = test.run();
+        if (check(results.has_value() && completed.has_value(), "run and on_complete returned results")) {
+            check(results->metrics.total_requests == 200, "request budget is exact");
+            check(results->metrics.status_codes.at(200) == 200, "every response was a 200");
+            check(completed->metrics.total_requests == results->metrics.total_requests, "on_complete saw the final count");
+            check(!results->interrupted, "budget run is not interrupted");
+        }
+    }
+
+    // A long run, stopped from the third snapshot
+    {
+        surge::Config config = local_config(listener);
+        config.duration_seconds = 30;
+        surge::LoadTest test(config);
+        int snapshots = 0;
+        std::uint64_t last_requests = 0;
+        bool increasing = true;
+        test.on_snapshot(std::chrono::milliseconds(20), [&](const surge::Snapshot& snapshot) {
+            increasing = increasing && snapshot.metrics.total_requests >= last_requests;
+            last_requests = snapshot.metrics.total_requests;
+            if (++snapshots == 3) {
+                test.stop();
+            }
+        });
+        std::atomic<bool> completed{false};
+        test.on_complete([&](const surge::Results&) {
+            completed = true;
+        });
+
+        auto start = Clock::now();
+        std::optional<surge::Results> results = test.run();
+        auto took = Clock::now() - start;
+
+        check(snapshots >= 3, "on_snapshot fired");
+        check(increasing && last_requests > 0, "snapshots are cumulative");
+        check(completed, "on_complete fired after stop()");
+        check(took < std::chrono::seconds(10), "stop() from a callback ended the run");
+        check(results && results->interrupted, "stopped run is interrupted");
+        check(results && results->metrics.total_requests >= last_requests, "final results include the snapshots");
+    }
+
+    // stop() before run() is not lost
+    {
+        surge::Config config = local_config(listener);
+        config.duration_seconds = 30;
+        surge::LoadTest test(config);
+        test.stop();
+        auto start = Clock::now();
+        std::optional<surge::Results> results = test.run();
+        check(Clock::now() - start < std::chrono::seconds(10), "stop() before run() ends the run");
+        check(results && results->interrupted, "run stopped in advance is interrupted");
+    }
+
+    return surge::test::exit_code();
+}
@@ -0,0 +1,114 @@
+// Per path statistics: path normalisation, LatencySketch accuracy against exact quantiles,
+// and PathStats staying within its capacity through record and merge
+
+#include "stats/path_stats.hpp"
+
+#include "support.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    std::string normalized(std::string_view path) {
+        std::string out;
+        surge::stats::normalize_path(path, out);
+        return out;
+    }
+
+    const surge::stats::PathSummary* find(const std::vector<surge::stats::PathSummary>& summaries, std::string_view path) {
+        auto found = std::find_if(summaries.begin(), summaries.end(), [&](const surge::stats::PathSummary& summary) {
+            return summary.path == path;
+        });
+        return found == summaries.end() ? nullptr : &*found;
+    }
+
+    // Exact quantile with the sketch's rank convention
+    std::uint64_t exact(const std::vector<std::uint64_t>& sorted, double quantile) {
+        auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(sorted.size()) + 0.5);
+        rank = std::clamp<std::uint64_t>(rank, 1, sorted.size());
+        return sorted[rank - 1];
+    }
+}
+
+int main() {
+    using surge::test::check;
+
+    // Identifier segments become {id}, the query and fragment are dropped
+    check(normalized("/users/48213/orders?x=1") == "/users/{id}/orders", "numeric segment and query");
+    check(normalized("/items/550e8400-e29b-41d4-a716-446655440000/edit") == "/items/{id}/edit", "UUID segment");
+    check(normalized("/items/550E8400-E29B-41D4-A716-446655440000") == "/items/{id}", "upper case UUID");
+    check(normalized("/blobs/9f86d081884c7d65") == "/blobs/{id}", "long hex segment");
+    check(normalized("/blobs/deadbeefcafe") == "/blobs/deadbeefcafe", "hex without a digit is a word");
+    check(normalized("/short/abc123") == "/short/abc123", "short hex is a word");
+    check(normalized("/api/v1/users/") == "/api/v1/users/", "words and trailing slash kept");
+    check(normalized("/search#results") == "/search", "fragment dropped");
+    check(normalized("/1/2/3") == "/{id}/{id}/{id}", "every numeric segment");
+    check(normalized("") == "/" && normalized("?q=1") == "/", "empty path is the root");
+
+    // Sketch quantiles within 2% of the exact value, over six decades of latencies
+    std::vector<std::uint64_t> values;
+    surge::stats::LatencySketch sketch;
+    for (std::uint64_t i = 0; i < 20'000; ++i) {
+        auto value = static_cast<std::uint64_t>(std::pow(10.0, 6.0 * static_cast<double>(i * 7919 % 20'000) / 20'000.0));
+        values.push_back(value);
+        sketch.record(value);
+    }
+    std::sort(values.begin(), values.end());
+    bool accurate = true;
+    for (double quantile : {0.001, 0.10, 0.25, 0.50, 0.75, 0.90, 0.99, 0.999, 1.0}) {
+        double expected = static_cast<double>(exact(values, quantile));
+        double estimate = static_cast<double>(sketch.value_at(quantile));
+        // +1: the estimate is truncated to whole microseconds
+        accurate = accurate && std::abs(estimate - expected) <= expected * surge::stats::LatencySketch::RELATIVE_ACCURACY + 1.0;
+    }
+    check(accurate, "sketch quantiles within the relative accuracy");
+    check(sketch.value_at(1.0) <= sketch.max() && sketch.max() == values.back(), "sketch never exceeds the max");
+    check(surge::stats::LatencySketch{}.value_at(0.5) == 0, "empty sketch");
+
+    // Merged sketches answer as one sketch over both inputs
+    surge::stats::LatencySketch low;
+    surge::stats::LatencySketch high;
+    for (std::uint64_t value = 1000; value < 2000; ++value) {
+        low.record(value);
+        high.record(value + 1000);
+    }
+    low.merge(high);
+    check(low.count() == 2000 && low.max() == 2999, "merged sketch counts");
+    check(surge::test::near(static_cast<double>(low.value_at(0.5)), 1999.0, 1999.0 * 0.02 + 1.0), "merged sketch median");
+
+    // Capacity bounds each table: heavy hitters survive a stream of one-off paths
+    constexpr std::size_t CAPACITY = 4;
+    surge::stats::PathStats first(CAPACITY);
+    for (int i = 0; i < 500; ++i) {
+        first.record("/hot/" + std::to_string(i), 100);        // All one path once normalised
+        first.record("/once-" + std::string(1, static_cast<char>('a' + i % 26)) + std::to_string(i), 10);
+    }
+    std::vector<surge::stats::PathSummary> summaries = first.summaries();
+    check(summaries.size() <= 2 * CAPACITY, "record stays within capacity");
+    const surge::stats::PathSummary* hot = find(summaries, "/hot/{id}");
+    check(hot != nullptr && hot->count == 500 && hot->error == 0, "heavy hitter tracked exactly");
+
+    // Merge: same path adds up, distinct paths compete for the same capacity
+    surge::stats::PathStats second(CAPACITY);
+    for (int i = 0; i < 300; ++i) {
+        second.record("/hot/" + std::to_string(i), 100);
+        second.record("/slow", 5000);
+    }
+    for (int i = 0; i < 10; ++i) {
+        second.record("/rare-" + std::to_string(i * 1000 + 1) + "x", 10);
+    }
+    first.merge(second);
+    summaries = first.summaries();
+    check(summaries.size() <= 2 * CAPACITY, "merge stays within capacity");
+    hot = find(summaries, "/hot/{id}");
+    check(hot != nullptr && hot->count == 800 && hot->total_time_us == 80'000, "merge adds the same path");
+    check(hot != nullptr && hot->p50 == 100 && hot->max == 100, "merge keeps the path's sketch");
+    const surge::stats::PathSummary* slow = find(summaries, "/slow");
+    check(slow != nullptr && slow->count == 300 && slow->total_time_us == 1'500'000, "heaviest by time survives the merge");
+
+    return surge::test::exit_code();
+}
@@ -0,0 +1,99 @@
+// Server reported time: the response time header and its units, Server-Timing, and which wins
+
+#include "http/client.hpp"
+#include "http/clock.hpp"
+#include "http/request.hpp"
+
+#include "support.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace {
+    using surge::test::LocalListener;
+
+    // The request path picks the response headers
+    std::string respond(std::string_view request) {
+        auto path = [&](std::string_view name) {
+            return request.starts_with("GET " + std::string(name) + " ");
+        };
+        if (path("/bad-unit")) {
+            return LocalListener::response("X-Response-Time: 12abc\r\nServer-Timing: db;dur=5, total;dur=30\r\n");
+        }
+        if (path("/bad-unit-sum")) {
+            return LocalListener::response("X-Response-Time: 12abc\r\nServer-Timing: db;dur=5, app;dur=7.5\r\n");
+        }
+        if (path("/seconds")) {
+            return LocalListener::response("X-Response-Time: 0.25s\r\n");
+        }
+        if (path("/micros")) {
+            return LocalListener::response("X-Response-Time: 1500us\r\n");
+        }
+        if (path("/micro-sign")) {
+            return LocalListener::response("X-Response-Time: 2500μs\r\n");
+        }
+        if (path("/plain")) {
+            return LocalListener::response("X-Response-Time: 42\r\n");
+        }
+        if (path("/header-wins")) {
+            return LocalListener::response("X-Response-Time: 12ms\r\nServer-Timing: db;dur=5, total;dur=30\r\n");
+        }
+        if (path("/total")) {
+            return LocalListener::response("Server-Timing: db;dur=5, cache;desc=\"hit\", total;dur=20\r\n");
+        }
+        if (path("/sum")) {
+            return LocalListener::response("Server-Timing: db;dur=5, app;dur=7.5\r\n");
+        }
+        return LocalListener::response("");
+    }
+}
+
+int main() {
+    using surge::test::check;
+    using surge::test::near;
+    surge::http::TscClock::init();
+
+    LocalListener listener(respond);
+    if (!check(listener.port() != 0, "local listener opened")) {
+        return surge::test::exit_code();
+    }
+
+    surge::http::ReceiveOptions receive;
+    receive.response_time_header = "X-Response-Time";
+    surge::http::Client client({}, receive);
+
+    auto server_time = [&](std::string_view path, std::size_t& timings) {
+        surge::http::Request request;
+        request.url = listener.url(path);
+        surge::http::Result result = client.execute(request);
+        check(result.success, "request to " + std::string(path) + " succeeded");
+        timings = result.server_timing_count;
+        return result.server_time_ms;
+    };
+
+    std::size_t timings = 0;
+
+    // A bad unit is ignored, the Server-Timing total (or sum) is used instead of the number before it
+    check(near(server_time("/bad-unit", timings), 30.0), "bad unit falls back to the total metric");
+    check(timings == 2, "bad unit header is not recorded as a timing");
+    check(near(server_time("/bad-unit-sum", timings), 12.5), "bad unit falls back to the metric sum");
+
+    // Units scale to milliseconds
+    check(near(server_time("/seconds", timings), 250.0), "s scales by 1000");
+    check(near(server_time("/micros", timings), 1.5), "us scales by 1/1000");
+    check(near(server_time("/micro-sign", timings), 2.5), "μs scales by 1/1000");
+    check(near(server_time("/plain", timings), 42.0), "no unit is milliseconds");
+
+    // The response time header beats Server-Timing, total beats the sum
+    check(near(server_time("/header-wins", timings), 12.0), "valid header wins over the total metric");
+    check(timings == 3, "header and both metrics recorded");
+    check(near(server_time("/total", timings), 20.0), "total metric wins over the sum");
+    check(timings == 2, "metric without dur is skipped");
+    check(near(server_time("/sum", timings), 12.5), "sum without a total metric");
+
+    // Nothing reported
+    check(server_time("/none", timings) < 0.0, "no server time without headers");
+    check(timings == 0, "no timings without headers");
+
+    return surge::test::exit_code();
+}
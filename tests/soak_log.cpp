@@ -0,0 +1,172 @@
+// Soak log: histogram payload round trip, every report histogram surviving a log line,
+// lines cut short by a crash, and --from/--to windowing
+
+#include "http/result.hpp"
+#include "output/soak_log.hpp"
+#include "stats/collector.hpp"
+#include "stats/histogram.hpp"
+
+#include "support.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr std::uint64_t REQUESTS = 200;
+
+    bool same_counts(const surge::stats::Histogram& a, const surge::stats::Histogram& b) {
+        for (std::size_t i = 0; i < surge::stats::Histogram::BUCKET_COUNT; ++i) {
+            if (a.count_at(i) != b.count_at(i)) {
+                return false;
+            }
+        }
+        return a.count() == b.count();
+    }
+
+    // A request that fills every histogram the soak log keeps
+    surge::http::Result sample_result(std::uint64_t i) {
+        surge::http::Result result;
+        result.success = true;
+        result.status_code = i % 10 == 0 ? 503 : 200;
+        result.latency = std::chrono::microseconds(1000 + i * 37);
+        result.first_byte = std::chrono::microseconds(800 + i * 11);
+        result.bytes_sent = 80;
+        result.bytes_received = 4096;
+        result.connect_attempted = true;
+        result.connected = true;
+        result.connect_time = std::chrono::microseconds(50);
+        result.timestamped = true;
+        result.network_time = std::chrono::microseconds(600 + i);
+        result.read_delay = std::chrono::microseconds(5 + i % 7);
+        result.compressed = true;
+        result.body_wire_bytes = 1024;
+        result.body_decoded_bytes = 4000;
+        result.decode_time = std::chrono::microseconds(20 + i % 13);
+        result.server_timings[0] = surge::http::ServerTiming{"db", 0.3};
+        result.server_timings[1] = surge::http::ServerTiming{"total", 0.7};
+        result.server_timing_count = 2;
+        result.server_time_ms = 0.7;
+        return result;
+    }
+
+    std::vector<std::string> read_lines(const std::string& path) {
+        std::vector<std::string> lines;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+}
+
+int main() {
+    using surge::test::check;
+    using surge::stats::Histogram;
+
+    // Payload round trip: wide range of values and counts, empty, merge on decode, garbage
+    Histogram histogram;
+    for (std::uint64_t value = 1; value < 50'000'000; value = value * 3 + 1) {
+        histogram.record(value, value % 17 + 1);
+    }
+    histogram.record(Histogram::MAX_VALUE);
+    Histogram decoded;
+    check(surge::output::decode_histogram(surge::output::encode_histogram(histogram), decoded), "payload decodes");
+    check(same_counts(histogram, decoded), "payload round trip keeps every bucket");
+
+    Histogram doubled = decoded;
+    check(surge::output::decode_histogram(surge::output::encode_histogram(histogram), doubled), "payload decodes again");
+    check(doubled.count() == histogram.count() * 2, "decoding adds into the histogram");
+
+    Histogram empty;
+    check(surge::output::encode_histogram(empty).empty(), "empty histogram is an empty payload");
+    check(surge::output::decode_histogram("", empty) && empty.count() == 0, "empty payload decodes to nothing");
+
+    std::string payload = surge::output::encode_histogram(histogram);
+    Histogram rejected;
+    check(!surge::output::decode_histogram(payload.substr(0, payload.size() - 4), rejected), "truncated payload is rejected");
+    check(!surge::output::decode_histogram("not base64!", rejected), "invalid base64 is rejected");
+    check(!surge::output::decode_histogram("AAAA", rejected), "bytes that are not deflate are rejected");
+
+    // One interval written by a real SoakLog
+    std::string path = "soak_log_test.log";
+    surge::stats::Collector collector(true);
+    {
+        surge::output::SoakLog log(path, std::chrono::hours(1), collector, "http://127.0.0.1/");
+        if (!check(log.start(), "soak log created")) {
+            return surge::test::exit_code();
+        }
+        for (std::uint64_t i = 0; i < REQUESTS; ++i) {
+            collector.request_started();
+            collector.record(sample_result(i));
+        }
+        log.finish();
+    }
+    surge::stats::Metrics live = collector.get_metrics();
+
+    auto whole = surge::output::SoakLog::load(path, 0.0, 1e9);
+    if (check(whole.has_value(), "log loads")) {
+        const surge::stats::Metrics& m = whole->metrics;
+        check(m.total_requests == REQUESTS && m.status_codes.at(503) == REQUESTS / 10, "counts and status codes");
+        check(m.total_connect_time == live.total_connect_time, "connect time");
+        check(m.body_wire_bytes == live.body_wire_bytes && m.compressed_responses == REQUESTS, "decoding counters");
+        check(same_counts(m.latency_histogram, live.latency_histogram), "latency histogram");
+        check(same_counts(m.first_byte_histogram, live.first_byte_histogram), "first byte histogram");
+        check(same_counts(m.transfer_rate_histogram, live.transfer_rate_histogram), "transfer rate histogram");
+        check(same_counts(m.network_histogram, live.network_histogram), "network histogram");
+        check(same_counts(m.read_delay_histogram, live.read_delay_histogram), "read delay histogram");
+        check(same_counts(m.decode_histogram, live.decode_histogram), "decode histogram");
+        check(same_counts(m.outside_server_histogram, live.outside_server_histogram), "outside server histogram");
+        for (std::size_t i = 0; i < surge::stats::OUTCOME_COUNT; ++i) {
+            check(same_counts(m.outcome_histograms[i], live.outcome_histograms[i]), "outcome histogram " + std::to_string(i));
+        }
+        check(m.code_histograms.size() == 2 && same_counts(m.code_histograms.at(503), live.code_histograms.at(503)),
+              "per code histograms");
+        check(m.server_timing_histograms.size() == 2 &&
+              same_counts(m.server_timing_histograms.at("db"), live.server_timing_histograms.at("db")),
+              "server timing histograms");
+    }
+
+    // Copies of that interval at 0, 60, 120 and 180s, plus a line cut short by a crash
+    std::vector<std::string> lines = read_lines(path);
+    std::string header;
+    std::string interval;
+    for (const std::string& line : lines) {
+        if (line.empty() || line.front() == '#' || line.front() == '"') {
+            header += line + "\n";
+        } else {
+            interval = line.substr(line.find(','));
+        }
+    }
+    check(!interval.empty(), "log has an interval line");
+
+    std::string windowed = "soak_log_window.log";
+    {
+        std::ofstream file(windowed);
+        file << header;
+        for (int start : {0, 60, 120, 180}) {
+            file << start << interval << "\n";
+        }
+        std::string crashed = "240" + interval;
+        file << crashed.substr(0, crashed.size() / 2) << "\n";
+    }
+
+    auto all = surge::output::SoakLog::load(windowed, 0.0, 1e9);
+    check(all && all->metrics.total_requests == 4 * REQUESTS, "truncated line skipped, whole intervals kept");
+    auto middle = surge::output::SoakLog::load(windowed, 60.0, 180.0);
+    check(middle && middle->metrics.total_requests == 2 * REQUESTS, "--from 60 --to 180 keeps the intervals starting inside");
+    check(middle && middle->metrics.latency_histogram.count() == 2 * live.latency_histogram.count(), "window merges histograms");
+    auto tail = surge::output::SoakLog::load(windowed, 150.0, 1e9);
+    check(tail && tail->metrics.total_requests == REQUESTS, "--from between intervals starts at the next one");
+    auto none = surge::output::SoakLog::load(windowed, 300.0, 1e9);
+    check(none && none->metrics.total_requests == 0, "window past the end is empty");
+
+    std::remove(path.c_str());
+    std::remove((path + ".checkpoint").c_str());
+    std::remove(windowed.c_str());
+    return surge::test::exit_code();
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+// Shared by the test executables: a check that records failures and a loopback HTTP listener
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace surge::test {
+    inline int failures = 0;
+
+    // Prints the failing line and keeps going, main returns exit_code()
+    inline bool check(bool ok, std::string_view what, std::source_location where = std::source_location::current()) {
+        if (!ok) {
+            std::cerr << "FAIL: " << where.file_name() << ":" << where.line() << ": " << what << "\n";
+            failures++;
+        }
+        return ok;
+    }
+
+    // Approximate equality for parsed and estimated values
+    inline bool near(double value, double expected, double tolerance = 1e-9) {
+        double difference = value - expected;
+        return difference <= tolerance && difference >= -tolerance;
+    }
+
+    inline int exit_code() {
+        if (failures > 0) {
+            std::cerr << failures << " check(s) failed\n";
+            return 1;
+        }
+        std::cout << "OK\n";
+        return 0;
+    }
+
+    // Loopback HTTP listener on an ephemeral port, one response per connection like the client expects
+    // respond gets the request head and returns the raw response, it runs on the listener thread
+    class LocalListener {
+        public:
+            explicit LocalListener(std::function<std::string(std::string_view)> respond)
+                : respond_(std::move(respond))
+            {
+                fd_ = socket(AF_INET, SOCK_STREAM, 0);
+                sockaddr_in address{};
+                address.sin_family = AF_INET;
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                socklen_t length = sizeof(address);
+                if (fd_ < 0 || bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+                    listen(fd_, 128) < 0 || getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length) < 0) {
+                    return;
+                }
+                port_ = ntohs(address.sin_port);
+                thread_ = std::thread([this]() {
+                    serve();
+                });
+            }
+
+            ~LocalListener() {
+                running_ = false;
+                if (fd_ >= 0) {
+                    shutdown(fd_, SHUT_RDWR);
+                    close(fd_);
+                }
+                if (thread_.joinable()) {
+                    thread_.join();
+                }
+            }
+
+            // Disable copy
+            LocalListener(const LocalListener&) = delete;
+            LocalListener& operator=(const LocalListener&) = delete;
+
+            // 0 if the listener could not be opened
+            std::uint16_t port() const { return port_; }
+
+            std::string url(std::string_view path = "/") const {
+                return "http://127.0.0.1:" + std::to_string(port_) + std::string(path);
+            }
+
+            // A complete response with a body and Connection: close
+            static std::string response(std::string_view headers, std::string_view body = "hello", int status = 200) {
+                return "HTTP/1.1 " + std::to_string(status) + " OK\r\n" + std::string(headers) +
+                    "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + std::string(body);
+            }
+
+        private:
+            void serve() {
+                char buffer[8192];
+                while (running_) {
+                    int fd = accept(fd_, nullptr, nullptr);
+                    if (fd < 0) {
+                        continue;
+                    }
+                    std::size_t filled = 0;
+                    std::string_view seen;
+                    while (seen.find("\r\n\r\n") == std::string_view::npos && filled < sizeof(buffer)) {
+                        ssize_t received = recv(fd, buffer + filled, sizeof(buffer) - filled, 0);
+                        if (received <= 0) {
+                            break;
+                        }
+                        filled += static_cast<std::size_t>(received);
+                        seen = std::string_view(buffer, filled);
+                    }
+                    std::string reply = respond_(seen);
+                    std::size_t sent = 0;
+                    while (sent < reply.size()) {
+                        ssize_t written = send(fd, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+                        if (written <= 0) {
+                            break;
+                        }
+                        sent += static_cast<std::size_t>(written);
+                    }
+                    close(fd);
+                }
+            }
+
+            std::function<std::string(std::string_view)> respond_;
+            int fd_ = -1;
+            std::uint16_t port_ = 0;
+            std::atomic<bool> running_{true};
+            std::thread thread_;
+    };
+}
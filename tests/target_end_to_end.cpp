@@ -0,0 +1,170 @@
+// Engine against surge-target: starts the target on a free port with injected latency and
+// errors, runs a request budget and checks what both sides counted
+// Usage: target_end_to_end <path to surge-target>
+
+#include "core/engine.hpp"
+#include "http/clock.hpp"
+
+#include "support.hpp"
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+extern char** environ;
+
+namespace {
+    constexpr std::uint32_t REQUESTS = 2000;
+    constexpr double ERROR_RATE = 0.1;
+    constexpr double DELAY_MS = 2.0;
+
+    // surge-target as a child process, its stdout on a pipe
+    class Target {
+        public:
+            explicit Target(const char* path) {
+                int fds[2];
+                if (pipe(fds) < 0) {
+                    return;
+                }
+                posix_spawn_file_actions_t actions;
+                posix_spawn_file_actions_init(&actions);
+                posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+                posix_spawn_file_actions_addclose(&actions, fds[0]);
+                const std::string error_rate = std::to_string(ERROR_RATE);
+                const std::string latency = "fixed:" + std::to_string(DELAY_MS);
+                const char* argv[] = {path, "--host", "127.0.0.1", "-p", "0", "-t", "1", "--latency", latency.c_str(),
+                                      "--error-rate", error_rate.c_str(), "--error-status", "503", nullptr};
+                if (posix_spawn(&pid_, path, &actions, nullptr, const_cast<char* const*>(argv), environ) != 0) {
+                    pid_ = -1;
+                }
+                posix_spawn_file_actions_destroy(&actions);
+                close(fds[1]);
+                output_ = fds[0];
+            }
+
+            ~Target() {
+                stop();
+                if (output_ >= 0) {
+                    close(output_);
+                }
+            }
+
+            // Disable copy
+            Target(const Target&) = delete;
+            Target& operator=(const Target&) = delete;
+
+            // Port from the "listening on host:port" line, 0 if the target did not start
+            std::uint16_t wait_for_port() {
+                while (pid_ > 0 && read_more()) {
+                    std::size_t line = text_.find("listening on ");
+                    std::size_t end = line == std::string::npos ? line : text_.find(" (", line);
+                    if (end != std::string::npos) {
+                        std::size_t colon = text_.rfind(':', end);
+                        return static_cast<std::uint16_t>(std::stoul(text_.substr(colon + 1, end - colon - 1)));
+                    }
+                }
+                return 0;
+            }
+
+            // SIGTERM, then everything it printed (its counters come last)
+            const std::string& stop() {
+                if (pid_ > 0) {
+                    kill(pid_, SIGTERM);
+                    while (read_more()) {}
+                    waitpid(pid_, nullptr, 0);
+                    pid_ = -1;
+                }
+                return text_;
+            }
+
+        private:
+            bool read_more() {
+                char buffer[1024];
+                ssize_t received = read(output_, buffer, sizeof(buffer));
+                if (received <= 0) {
+                    return false;
+                }
+                text_.append(buffer, static_cast<std::size_t>(received));
+                return true;
+            }
+
+            pid_t pid_ = -1;
+            int output_ = -1;
+            std::string text_;
+    };
+
+    // "Requests:    2000" from the target's exit summary
+    std::uint64_t counter(std::string_view output, std::string_view name) {
+        std::size_t at = output.find(name);
+        if (at == std::string_view::npos) {
+            return 0;
+        }
+        std::size_t digits = output.find_first_of("0123456789", at);
+        return std::stoull(std::string(output.substr(digits, output.find('\n', digits) - digits)));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    using surge::test::check;
+    if (argc < 2) {
+        std::cerr << "Usage: target_end_to_end <surge-target>\n";
+        return 1;
+    }
+    surge::http::TscClock::init();
+
+    Target target(argv[1]);
+    std::uint16_t port = target.wait_for_port();
+    if (!check(port != 0, "surge-target started on a free port")) {
+        return surge::test::exit_code();
+    }
+
+    surge::cli::Config config;
+    config.url = "http://127.0.0.1:" + std::to_string(port) + "/e2e";
+    config.concurrency = 4;
+    config.requests = REQUESTS;
+    config.verbose = false;
+
+    surge::core::Engine engine(config);
+    if (!check(engine.prepare(), "engine accepted the config")) {
+        return surge::test::exit_code();
+    }
+    surge::core::Results results = engine.run();
+    const surge::stats::Metrics& m = results.metrics;
+
+    // Every request answered, as a 200 or the injected 503
+    check(m.total_requests == REQUESTS, "request budget is exact");
+    check(m.successful_requests == REQUESTS && m.failed_requests == 0, "every request got a response");
+    auto count = [&](std::uint16_t code) {
+        auto found = m.status_codes.find(code);
+        return found == m.status_codes.end() ? std::uint64_t{0} : found->second;
+    };
+    check(count(200) + count(503) == REQUESTS && m.status_codes.size() <= 2, "only 200 and 503 responses");
+
+    // Injected error rate, within 5 standard deviations of the binomial
+    double expected = REQUESTS * ERROR_RATE;
+    double tolerance = 5.0 * std::sqrt(REQUESTS * ERROR_RATE * (1.0 - ERROR_RATE));
+    check(std::abs(static_cast<double>(count(503)) - expected) <= tolerance,
+          "503 share matches --error-rate (" + std::to_string(count(503)) + " of " + std::to_string(REQUESTS) + ")");
+
+    // Server-Timing: delay;dur=2.000 recovered on every response, and latency includes it
+    auto delay = m.server_timing_histograms.find("delay");
+    if (check(delay != m.server_timing_histograms.end(), "Server-Timing delay recorded")) {
+        check(delay->second.count() == REQUESTS, "delay on every response");
+        check(surge::test::near(static_cast<double>(delay->second.value_at(0.50)), DELAY_MS * 1000.0, DELAY_MS * 1000.0 * 0.02),
+              "delay p50 is the injected 2ms");
+    }
+    check(results.percentiles.p50 >= static_cast<std::uint64_t>(DELAY_MS * 1000.0), "latency includes the injected delay");
+
+    // The target counted the same requests
+    const std::string& output = target.stop();
+    check(counter(output, "Requests:") == REQUESTS, "target counted every request");
+    check(counter(output, "Errors:") == count(503), "target counted the same errors");
+
+    return surge::test::exit_code();
+}